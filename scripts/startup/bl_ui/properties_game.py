@@ -564,6 +564,7 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
         if gs.physics_engine != 'NONE':
             layout.prop(gs, "physics_solver")
             layout.prop(gs, "physics_gravity", text="Gravity")
+            layout.prop(gs, "use_physics_multithreading")
 
             split = layout.split()
 
@@ -600,6 +601,8 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             row.label(text="Object Activity:")
             row.prop(gs, "use_activity_culling")
 
+            layout.prop(gs, "use_parallel_scenes")
+
         else:
             split = layout.split()
 
@@ -611,6 +614,10 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             col.label(text="Logic Steps:")
             col.prop(gs, "logic_step_max", text="Max")
 
+        layout.prop(gs, "use_transform_store")
+        layout.prop(gs, "use_parallel_scene_graph")
+        layout.prop(gs, "use_bvh_cache")
+
 class SCENE_PT_game_blender_physics(SceneButtonsPanel, Panel):
     bl_label = "Game Blender Physics"
     COMPAT_ENGINES = {
@@ -813,6 +820,23 @@ class OBJECT_PT_activity_culling(ObjectButtonsPanel, Panel):
         sub.active = activity.use_logic
         sub.prop(activity, "logic_radius")
 
+class OBJECT_PT_game_instancing(ObjectButtonsPanel, Panel):
+    bl_label = "Game Instancing"
+    COMPAT_ENGINES = {
+        'BLENDER_EEVEE_NEXT',
+        'BLENDER_WORKBENCH'}
+
+    @classmethod
+    def poll(cls, context):
+        ob = context.object
+        return context.scene.render.engine in cls.COMPAT_ENGINES and ob.type == 'MESH'
+
+    def draw(self, context):
+        layout = self.layout
+        game = context.object.game
+
+        layout.prop(game, "use_instancing")
+
 class OBJECT_MT_lod_tools(Menu):
     bl_label = "Level Of Detail Tools"
 
@@ -890,6 +914,7 @@ classes = (
     SCENE_PT_game_console,
     OBJECT_MT_lod_tools,
     OBJECT_PT_activity_culling,
+    OBJECT_PT_game_instancing,
     OBJECT_PT_levels_of_detail,
 )
 
@@ -54,6 +54,13 @@ typedef struct FileReader {
 FileReader *BLI_filereader_new_file(int filedes) ATTR_WARN_UNUSED_RESULT;
 /** Create #FileReader from raw file descriptor using memory-mapped IO. */
 FileReader *BLI_filereader_new_mmap(int filedes) ATTR_WARN_UNUSED_RESULT;
+/**
+ * Create #FileReader from a range of a raw file descriptor using memory-mapped IO,
+ * the offsets of the reader are relative to the start of the range.
+ */
+FileReader *BLI_filereader_new_mmap_range(int filedes,
+                                          size_t offset,
+                                          size_t length) ATTR_WARN_UNUSED_RESULT;
 /** Create #FileReader from a region of memory. */
 FileReader *BLI_filereader_new_memory(const void *data, size_t len) ATTR_WARN_UNUSED_RESULT
     ATTR_NONNULL();
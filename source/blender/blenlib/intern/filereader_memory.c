@@ -6,6 +6,7 @@
  * \ingroup bli
  */
 
+#include <stdint.h>
 #include <string.h>
 
 #include "BLI_fileops.h"
@@ -20,6 +21,8 @@ typedef struct {
 
   const char *data;
   BLI_mmap_file *mmap;
+  /** Offset of the read range in the mapped file. */
+  size_t mmap_offset;
   size_t length;
 } MemoryReader;
 
@@ -94,7 +97,7 @@ static int64_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
   /* Don't read more bytes than there are available in the buffer. */
   size_t readsize = MIN2(size, (size_t)(mem->length - mem->reader.offset));
 
-  if (!BLI_mmap_read(mem->mmap, buffer, mem->reader.offset, readsize)) {
+  if (!BLI_mmap_read(mem->mmap, buffer, mem->mmap_offset + mem->reader.offset, readsize)) {
     return 0;
   }
 
@@ -111,16 +114,28 @@ static void memory_close_mmap(FileReader *reader)
 }
 
 FileReader *BLI_filereader_new_mmap(int filedes)
+{
+  return BLI_filereader_new_mmap_range(filedes, 0, SIZE_MAX);
+}
+
+FileReader *BLI_filereader_new_mmap_range(int filedes, size_t offset, size_t length)
 {
   BLI_mmap_file *mmap = BLI_mmap_open(filedes);
   if (mmap == NULL) {
     return NULL;
   }
 
+  const size_t file_length = BLI_mmap_get_length(mmap);
+  if (offset > file_length) {
+    BLI_mmap_free(mmap);
+    return NULL;
+  }
+
   MemoryReader *mem = MEM_callocN(sizeof(MemoryReader), __func__);
 
   mem->mmap = mmap;
-  mem->length = BLI_mmap_get_length(mmap);
+  mem->mmap_offset = offset;
+  mem->length = MIN2(length, file_length - offset);
 
   mem->reader.read = memory_read_mmap;
   mem->reader.seek = memory_seek;
@@ -5324,12 +5324,48 @@ BlendFileData *blo_read_blendafterruntime(int file,
                                           BlendFileReadReport *reports)
 {
   BlendFileData *bfd = NULL;
+
+  /* The data is followed by its start offset and the "BRUNTIME" tag. */
+  const size_t filesize = BLI_file_descriptor_size(file);
+  const size_t trailersize = 12;
+  if (datastart < 0 || filesize == size_t(-1) || filesize < size_t(datastart) + trailersize) {
+    BKE_reportf(reports->reports, RPT_ERROR, "Unable to read '%s' (truncated runtime)", name);
+    close(file);
+    return NULL;
+  }
+
+  /* Map the appended data to avoid copying it through read calls, the offsets of the mapped
+   * reader are relative to the data start as for a regular blend file. */
+  FileReader *rawfile = BLI_filereader_new_mmap_range(
+      file, datastart, filesize - trailersize - datastart);
+  if (rawfile) {
+    /* The mapping stays valid after closing the file. */
+    close(file);
+
+    char header[7];
+    if (rawfile->read(rawfile, header, sizeof(header)) == sizeof(header)) {
+      rawfile->seek(rawfile, 0, SEEK_SET);
+
+      FileReader *decompressed = nullptr;
+      if (BLI_file_magic_is_gzip(header)) {
+        decompressed = BLI_filereader_new_gzip(rawfile);
+      }
+      else if (BLI_file_magic_is_zstd(header)) {
+        decompressed = BLI_filereader_new_zstd(rawfile);
+      }
+      /* The compressed readers take the ownership of the mapped reader. */
+      if (decompressed) {
+        rawfile = decompressed;
+      }
+    }
+  }
+  else {
+    rawfile = BLI_filereader_new_file(file);
+    rawfile->seek(rawfile, datastart, SEEK_SET);
+  }
+
   FileData *fd = filedata_new(reports);
-  fd->file = BLI_filereader_new_file(file);
-  fd->file->seek(fd->file, datastart, SEEK_SET);
-  /*fd->filedes = file;
-  fd->buffersize = actualsize;
-  fd->read = fd_read_data_from_file;*/
+  fd->file = rawfile;
 
   /* needed for library_append and read_libraries */
   BLI_strncpy(fd->relabase, name, sizeof(fd->relabase));
@@ -1027,6 +1027,11 @@ enum {
 #define GAME_PYTHON_CONSOLE (1 << 22)
 #define GAME_USE_INTERACTIVE_DYNAPAINT (1 << 23)
 #define GAME_USE_INTERACTIVE_RIGIDBODY (1 << 24)
+#define GAME_USE_PARALLEL_SCENES (1 << 25)
+#define GAME_USE_PHYSICS_MULTITHREADING (1 << 26)
+#define GAME_USE_TRANSFORM_STORE (1 << 27)
+#define GAME_USE_PARALLEL_SCENEGRAPH (1 << 28)
+#define GAME_USE_BVH_CACHE (1 << 29)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
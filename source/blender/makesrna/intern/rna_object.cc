@@ -2880,6 +2880,13 @@ static void rna_def_object_game_settings(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "gameflag", OB_RECORD_ANIMATION);
   RNA_def_property_ui_text(prop, "Record Animation", "Record animation objects without physics");
 
+  prop = RNA_def_property(srna, "use_instancing", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "gameflag", OB_GAME_INSTANCING);
+  RNA_def_property_ui_text(prop,
+                           "Instancing",
+                           "Draw the copies added during the game as instances of a single "
+                           "object, their mesh and materials can't be changed separately");
+
   prop = RNA_def_property(srna, "use_actor", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "gameflag", OB_ACTOR);
   RNA_def_property_ui_text(prop, "Actor", "Object is detected by the Near and Radar sensor");
@@ -6663,6 +6663,46 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Use Interactive Rigidbody Sim", "Blender Rigidbody sim at bge runtime (experimental)");
 
+  prop = RNA_def_property(srna, "use_parallel_scenes", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_SCENES);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Scenes",
+                           "Step the physics and scene graph of all active scenes at the same "
+                           "time on several threads, logic and python stay serialized "
+                           "(experimental)");
+
+  prop = RNA_def_property(srna, "use_physics_multithreading", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PHYSICS_MULTITHREADING);
+  RNA_def_property_ui_text(prop,
+                           "Multithreaded Physics",
+                           "Run collision detection and constraint solving of the Bullet world on "
+                           "several threads, soft bodies are not supported (experimental)");
+
+  prop = RNA_def_property(srna, "use_transform_store", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_TRANSFORM_STORE);
+  RNA_def_property_ui_text(prop,
+                           "Contiguous Transforms",
+                           "Store the world matrices of the objects in one array in hierarchy "
+                           "order, filled by the scene graph update and read by the render "
+                           "synchronization and scene.getWorldMatrices");
+
+  prop = RNA_def_property(srna, "use_parallel_scene_graph", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_SCENEGRAPH);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Scene Graph",
+                           "Compute the world transforms of independent object hierarchies on "
+                           "several threads (experimental)");
+
+  prop = RNA_def_property(srna, "use_bvh_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_BVH_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Cache Mesh BVH",
+                           "Save the BVH of the static triangle mesh collision shapes in a "
+                           "bvh_cache directory next to the saved blend file, to load them "
+                           "instead of building them at the next start. The least recently used "
+                           "files are deleted at the end of the game when the directory exceeds "
+                           "256 MB");
+
   /* obstacle simulation */
   prop = RNA_def_property(srna, "obstacle_simulation", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, NULL, "obstacleSimulation");
@@ -0,0 +1,213 @@
+/** \file gameengine/Common/CM_Trace.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "BLI_fileops.h"
+
+std::atomic<bool> CM_TraceRecorder::s_enabled(false);
+
+/// Write a string in a JSON file with the characters escaped.
+static void write_json_string(FILE *file, const char *str)
+{
+  fputc('"', file);
+  for (; *str; ++str) {
+    const char c = *str;
+    switch (c) {
+      case '"':
+        fputs("\\\"", file);
+        break;
+      case '\\':
+        fputs("\\\\", file);
+        break;
+      case '\n':
+        fputs("\\n", file);
+        break;
+      case '\t':
+        fputs("\\t", file);
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          fprintf(file, "\\u%04x", (unsigned int)c);
+        }
+        else {
+          fputc(c, file);
+        }
+        break;
+    }
+  }
+  fputc('"', file);
+}
+
+CM_TraceRecorder::CM_TraceRecorder() : m_numEvents(0), m_numThreads(CATEGORIES_THREAD + 1)
+{
+}
+
+CM_TraceRecorder::~CM_TraceRecorder()
+{
+}
+
+CM_TraceRecorder &CM_TraceRecorder::Get()
+{
+  static CM_TraceRecorder recorder;
+  return recorder;
+}
+
+void CM_TraceRecorder::Start(unsigned int maxEvents)
+{
+  s_enabled = false;
+
+  m_events.clear();
+  m_events.shrink_to_fit();
+  m_events.resize(std::max(maxEvents, 1u));
+  m_numEvents = 0;
+
+  // Make sure the main thread is the first of the trace.
+  GetThread();
+
+  s_enabled = true;
+}
+
+void CM_TraceRecorder::Stop()
+{
+  s_enabled = false;
+}
+
+CM_Clock::Rep CM_TraceRecorder::GetTime() const
+{
+  return m_clock.GetTimeNano();
+}
+
+unsigned int CM_TraceRecorder::GetThread()
+{
+  static thread_local unsigned int thread = m_numThreads++;
+  return thread;
+}
+
+const char *CM_TraceRecorder::RegisterName(const std::string &name)
+{
+  static thread_local std::unordered_map<std::string, const char *> cache;
+
+  const auto it = cache.find(name);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  m_namesMutex.Lock();
+  const char *str = m_names.insert(name).first->c_str();
+  m_namesMutex.Unlock();
+
+  cache.emplace(name, str);
+
+  return str;
+}
+
+void CM_TraceRecorder::AddSpan(const char *category,
+                               const char *name,
+                               CM_Clock::Rep begin,
+                               CM_Clock::Rep end,
+                               unsigned int thread)
+{
+  const uint64_t index = m_numEvents.fetch_add(1, std::memory_order_relaxed);
+  Event &event = m_events[index % m_events.size()];
+  event.category = category;
+  event.name = name;
+  event.thread = thread;
+  event.begin = begin;
+  event.end = end;
+}
+
+bool CM_TraceRecorder::Dump(const std::string &path, std::string &error)
+{
+  FILE *file = BLI_fopen(path.c_str(), "w");
+  if (!file) {
+    error = std::strerror(errno);
+    return false;
+  }
+
+  const uint64_t numEvents = m_numEvents;
+  const uint64_t size = m_events.size();
+  const uint64_t first = (numEvents > size) ? numEvents - size : 0;
+
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+  // Name the threads of the trace, the first is always the main thread.
+  const unsigned int numThreads = m_numThreads;
+  for (unsigned int thread = CATEGORIES_THREAD; thread < numThreads; ++thread) {
+    std::string name;
+    if (thread == CATEGORIES_THREAD) {
+      name = "Time categories";
+    }
+    else if (thread == CATEGORIES_THREAD + 1) {
+      name = "Main";
+    }
+    else {
+      name = "Worker " + std::to_string(thread - CATEGORIES_THREAD - 1);
+    }
+    fprintf(file,
+            "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            (thread == CATEGORIES_THREAD) ? "" : ",\n",
+            thread);
+    write_json_string(file, name.c_str());
+    fputs("}}", file);
+  }
+
+  for (uint64_t i = first; i < numEvents; ++i) {
+    const Event &event = m_events[i % size];
+    fputs(",\n{\"name\":", file);
+    write_json_string(file, event.name);
+    fprintf(file,
+            ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            event.category,
+            event.thread,
+            double(event.begin) * 1e-3,
+            double(event.end - event.begin) * 1e-3);
+  }
+
+  fputs("\n]}\n", file);
+
+  const bool success = (ferror(file) == 0);
+  if (!success) {
+    error = std::strerror(errno);
+  }
+  fclose(file);
+
+  return success;
+}
+
+CM_TraceScope::CM_TraceScope(const char *category, const char *name)
+    : m_enabled(CM_TraceRecorder::IsEnabled())
+{
+  if (m_enabled) {
+    m_category = category;
+    m_name = name;
+    m_begin = CM_TraceRecorder::Get().GetTime();
+  }
+}
+
+CM_TraceScope::CM_TraceScope(const char *category, const std::string &name)
+    : m_enabled(CM_TraceRecorder::IsEnabled())
+{
+  if (m_enabled) {
+    CM_TraceRecorder &recorder = CM_TraceRecorder::Get();
+    m_category = category;
+    m_name = recorder.RegisterName(name);
+    m_begin = recorder.GetTime();
+  }
+}
+
+CM_TraceScope::~CM_TraceScope()
+{
+  // The span is also closed if the recorder was stopped meanwhile, the buffer is still allocated.
+  if (m_enabled) {
+    CM_TraceRecorder &recorder = CM_TraceRecorder::Get();
+    recorder.AddSpan(m_category, m_name, m_begin, recorder.GetTime(), recorder.GetThread());
+  }
+}
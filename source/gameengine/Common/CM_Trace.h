@@ -0,0 +1,108 @@
+/** \file CM_Trace.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "CM_Clock.h"
+#include "CM_Thread.h"
+
+/** Records timed spans in a ring buffer and exports them in the Chrome trace event format,
+ * readable by chrome://tracing and Perfetto.
+ * The recorder is global to be reachable from every module without threading it through the
+ * engine. When it is not started, recording a span costs only the test of an atomic flag.
+ * Start, Stop and Dump must be called from the main thread while no other thread records spans.
+ */
+class CM_TraceRecorder {
+ public:
+  /// Thread index of the spans of the time categories, kept separated as they don't nest.
+  static const unsigned int CATEGORIES_THREAD = 0;
+  /// Default number of spans kept in the ring buffer.
+  static const unsigned int DEFAULT_MAX_EVENTS = 262144;
+
+ private:
+  struct Event {
+    /// Static category string.
+    const char *category;
+    /// Static or registered name string.
+    const char *name;
+    unsigned int thread;
+    CM_Clock::Rep begin;
+    CM_Clock::Rep end;
+  };
+
+  static std::atomic<bool> s_enabled;
+
+  CM_Clock m_clock;
+  std::vector<Event> m_events;
+  /// Number of spans recorded since the start, the ring buffer index is this modulo its size.
+  std::atomic<uint64_t> m_numEvents;
+  /// Next index given to a thread recording its first span.
+  std::atomic<unsigned int> m_numThreads;
+
+  CM_ThreadMutex m_namesMutex;
+  /// Registered names, never freed to keep valid the names of the spans and of the threads caches.
+  std::unordered_set<std::string> m_names;
+
+  CM_TraceRecorder();
+
+ public:
+  ~CM_TraceRecorder();
+
+  static CM_TraceRecorder &Get();
+
+  static inline bool IsEnabled()
+  {
+    return s_enabled.load(std::memory_order_relaxed);
+  }
+
+  /** Clear the previous spans and start recording.
+   * \param maxEvents The number of spans kept, the oldest are overwritten.
+   */
+  void Start(unsigned int maxEvents);
+  /// Stop recording, the recorded spans are kept until the next start.
+  void Stop();
+
+  /// Time in nanoseconds used for the spans.
+  CM_Clock::Rep GetTime() const;
+  /// Index of the calling thread in the trace.
+  unsigned int GetThread();
+  /** Get a span name string living as long as the recorder, the names are cached by each thread
+   * to not lock the names mutex for every span.
+   */
+  const char *RegisterName(const std::string &name);
+
+  void AddSpan(const char *category,
+               const char *name,
+               CM_Clock::Rep begin,
+               CM_Clock::Rep end,
+               unsigned int thread);
+
+  /** Write the recorded spans to a JSON file.
+   * \return False and set error if the file can't be written.
+   */
+  bool Dump(const std::string &path, std::string &error);
+};
+
+/** Record a span from the construction to the destruction, when the recorder is enabled.
+ * Nothing else than the test of the recorder flag is done when it is disabled.
+ */
+class CM_TraceScope {
+ private:
+  const char *m_category;
+  const char *m_name;
+  CM_Clock::Rep m_begin;
+  bool m_enabled;
+
+ public:
+  /// \param name A static string, used as is.
+  CM_TraceScope(const char *category, const char *name);
+  /// \param name A dynamic string, registered only when the recorder is enabled.
+  CM_TraceScope(const char *category, const std::string &name);
+  ~CM_TraceScope();
+};
@@ -445,6 +445,13 @@ void BL_ArmatureObject::BlendInPose(bPose *blend_pose, float weight, short mode)
   game_blend_poses(m_objArma->pose, blend_pose, weight, mode);
 }
 
+void BL_ArmatureObject::EnsurePoseChannelsHash()
+{
+  if (m_objArma->pose) {
+    BKE_pose_channels_hash_ensure(m_objArma->pose);
+  }
+}
+
 bool BL_ArmatureObject::UpdateTimestep(double curtime)
 {
   if (curtime != m_lastframe) {
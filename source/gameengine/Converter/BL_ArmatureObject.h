@@ -83,6 +83,10 @@ class BL_ArmatureObject : public KX_GameObject {
   void ApplyPose();
   void SetPoseByAction(bAction *action, AnimationEvalContext *evalCtx);
   void BlendInPose(bPose *blend_pose, float weight, short mode);
+  /** Build the pose channels lookup hash, must be called from the main thread before
+   * evaluating actions of several armatures in parallel as the hash is lazily created.
+   */
+  void EnsurePoseChannelsHash();
 
   bool UpdateTimestep(double curtime);
 
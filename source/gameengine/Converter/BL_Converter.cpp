@@ -40,10 +40,13 @@
 #include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_report.hh"
+#include "BLI_fileops.h"
 #include "BLI_linklist.h"
+#include "BLI_listbase.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_task.h"
+#include "BLI_time.h"
 #include "BLO_readfile.hh"
 #include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
@@ -51,9 +54,12 @@
 
 #include "BL_DataConversion.h"
 #include "BL_SceneConverter.h"
+#include "CM_Trace.h"
 #include "DummyPhysicsEnvironment.h"
 #include "EXP_StringValue.h"
 #include "KX_GameObject.h"
+#include "KX_Globals.h"
+#include "KX_Scene.h"
 #include "KX_LibLoadStatus.h"
 #include "KX_PythonInit.h"  // So we can handle adding new text datablocks for Python to import
 #include "LA_SystemCommandLine.h"
@@ -61,6 +67,7 @@
 #include "SCA_ActionActuator.h"
 
 #ifdef WITH_BULLET
+#  include "CcdBvhCache.h"
 #  include "CcdPhysicsEnvironment.h"
 #endif
 
@@ -102,10 +109,21 @@ void BL_Converter::SceneSlot::Merge(const BL_SceneConverter *converter)
 }
 
 BL_Converter::BL_Converter(Main *maggie, KX_KetsjiEngine *engine)
-    : m_maggie(maggie), m_ketsjiEngine(engine), m_alwaysUseExpandFraming(false)
+    : m_maggie(maggie),
+      m_ketsjiEngine(engine),
+      m_alwaysUseExpandFraming(false),
+      m_mergeBudget(0.0)
 {
   BKE_main_id_tag_all(maggie, ID_TAG_DOIT, false);  // avoid re-tagging later on
   m_threadinfo.m_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
+
+  // The BVH cache is next to the blend file, an unsaved file has no cache.
+  const std::string &mainPath = KX_GetMainPath();
+  if (!mainPath.empty()) {
+    char directory[FILE_MAX] = "//bvh_cache";
+    BLI_path_abs(directory, mainPath.c_str());
+    m_bvhCacheDirectory = directory;
+  }
 }
 
 BL_Converter::~BL_Converter()
@@ -121,6 +139,13 @@ BL_Converter::~BL_Converter()
      Because it needs to lock the mutex, even if there's no active task when it's
      in the scene converter destructor. */
   BLI_task_pool_free(m_threadinfo.m_pool);
+
+#ifdef WITH_BULLET
+  // The BVH files written by all the conversions are evicted once, no conversion is running.
+  if (!m_bvhCacheDirectory.empty()) {
+    CcdBvhCache::Evict(m_bvhCacheDirectory);
+  }
+#endif
 }
 
 Main *BL_Converter::GetMain()
@@ -185,7 +210,8 @@ void BL_Converter::ConvertScene(KX_Scene *destinationscene,
       SYS_SystemHandle syshandle = SYS_GetSystem(); /*unused*/
       int visualizePhysics = SYS_GetCommandLineInt(syshandle, "show_physics", 0);
 
-      phy_env = CcdPhysicsEnvironment::Create(blenderscene, visualizePhysics);
+      phy_env = CcdPhysicsEnvironment::Create(
+          blenderscene, visualizePhysics, m_bvhCacheDirectory);
       physics_engine = UseBullet;
       break;
     }
@@ -293,32 +319,96 @@ Main *BL_Converter::GetMainDynamicPath(const std::string &path) const
   return nullptr;
 }
 
-void BL_Converter::MergeAsyncLoads()
+/// Library loaded in a worker thread, deleted in MergeAsyncLoads.
+struct AsyncLibLoad {
+  std::string m_path;
+  /// Copy of the library data when it's loaded from memory.
+  std::vector<char> m_buffer;
+  int m_idcode;
+  short m_options;
+  /// The linked library, nullptr if the file couldn't be read.
+  Main *m_main;
+  std::vector<KX_Scene *> m_scenes;
+  /// Number of scenes entirely merged and progress of the next one.
+  unsigned int m_mergedScenes;
+  KX_Scene::MergeState m_mergeState;
+  /// True when the merge started in a previous call to MergeAsyncLoads.
+  bool m_merging;
+};
+
+bool BL_Converter::MergeAsyncLoad(KX_LibLoadStatus *status, double endTime)
 {
-  std::vector<KX_Scene *> *merge_scenes;
-
-  std::vector<KX_LibLoadStatus *>::iterator mit;
-  std::vector<KX_Scene *>::iterator sit;
+  AsyncLibLoad *load = (AsyncLibLoad *)status->GetData();
+  CM_TraceScope libLoadTrace("libload", load->m_path);
+
+  if (!load->m_main) {
+    CM_Error("could not open blendfile \"" << load->m_path << "\"");
+    m_status_map.erase(load->m_path);
+    status->SetData(nullptr);
+    // The finish callback is not run, the scripts only see the failed stage.
+    status->Fail();
+    status->Free();
+    delete load;
+    return true;
+  }
 
-  m_threadinfo.m_mutex.Lock();
+  if (!load->m_merging) {
+    // needed for lookups
+    m_DynamicMaggie.push_back(load->m_main);
+    BLI_strncpy(load->m_main->filepath, load->m_path.c_str(), sizeof(load->m_main->filepath));
 
-  for (mit = m_mergequeue.begin(); mit != m_mergequeue.end(); ++mit) {
-    merge_scenes = (std::vector<KX_Scene *> *)(*mit)->GetData();
+    status->SetStage(KX_LibLoadStatus::STAGE_MERGE);
+    load->m_merging = true;
+  }
 
-    for (sit = merge_scenes->begin(); sit != merge_scenes->end(); ++sit) {
-      (*mit)->GetMergeScene()->MergeScene(*sit);
-      delete (*sit);
+  KX_Scene *scene_merge = status->GetMergeScene();
+  const unsigned int numScenes = load->m_scenes.size();
+  while (load->m_mergedScenes < numScenes) {
+    KX_Scene *scene = load->m_scenes[load->m_mergedScenes];
+    if (!scene_merge->MergeSceneStep(scene, load->m_mergeState, endTime)) {
+      return false;
     }
 
-    delete merge_scenes;
-    (*mit)->SetData(nullptr);
-
-    (*mit)->Finish();
+    // RemoveScene(other); // Don't run this, it frees the entire scene converter data, just
+    // delete the scene
+    delete scene;
+    load->m_mergeState = KX_Scene::MergeState();
+    status->SetStageProgress((float)++load->m_mergedScenes / numScenes);
   }
 
-  m_mergequeue.clear();
+  // The scenes are already merged, only convert the other data.
+  MergeLibrary(status, load->m_main, load->m_idcode, load->m_options, {});
+
+  // The callbacks are run only once the library is entirely merged.
+  status->SetData(nullptr);
+  status->Finish();
+  delete load;
+
+  return true;
+}
 
+void BL_Converter::MergeAsyncLoads(double endTime)
+{
+  // Take the loads finished by the loading threads, the merge is done without the mutex.
+  m_threadinfo.m_mutex.Lock();
+  m_pendingmerges.insert(m_pendingmerges.end(), m_mergequeue.begin(), m_mergequeue.end());
+  m_mergequeue.clear();
   m_threadinfo.m_mutex.Unlock();
+
+  /* The finish callbacks can load or free libraries and then modify the pending list,
+   * always take the first pending load. */
+  while (!m_pendingmerges.empty()) {
+    KX_LibLoadStatus *status = m_pendingmerges.front();
+    if (!MergeAsyncLoad(status, endTime)) {
+      break;
+    }
+    m_pendingmerges.erase(m_pendingmerges.begin());
+  }
+}
+
+void BL_Converter::MergeAsyncLoads()
+{
+  MergeAsyncLoads((m_mergeBudget > 0.0) ? BLI_time_now_seconds() + m_mergeBudget : 0.0);
 }
 
 void BL_Converter::FinalizeAsyncLoads()
@@ -326,7 +416,17 @@ void BL_Converter::FinalizeAsyncLoads()
   // Finish all loading libraries.
   BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
   // Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
-  MergeAsyncLoads();
+  MergeAsyncLoads(0.0);
+}
+
+void BL_Converter::SetMergeBudget(double budget)
+{
+  m_mergeBudget = budget;
+}
+
+double BL_Converter::GetMergeBudget() const
+{
+  return m_mergeBudget;
 }
 
 void BL_Converter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -336,39 +436,140 @@ void BL_Converter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
   m_threadinfo.m_mutex.Unlock();
 }
 
-static void async_convert(TaskPool *pool, void *ptr, int /*threadid*/)
+static void load_datablocks(Main *main_tmp,
+                            BlendHandle *bpy_openlib,
+                            int idcode,
+                            const LibraryLink_Params *liblink_params,
+                            KX_LibLoadStatus *status)
 {
-  KX_Scene *new_scene = nullptr;
-  KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
-  std::vector<Scene *> *scenes = (std::vector<Scene *> *)status->GetData();
-  std::vector<KX_Scene *> *merge_scenes =
-      new std::vector<KX_Scene *>();  // Deleted in MergeAsyncLoads
+  LinkNode *names = nullptr;
 
-  for (unsigned int i = 0; i < scenes->size(); ++i) {
-    new_scene = status->GetEngine()->CreateScene((*scenes)[i], true);
+  int totnames;
+  names = BLO_blendhandle_get_datablock_names(bpy_openlib, idcode, false, &totnames);
 
+  int i = 0;
+  LinkNode *n = names;
+  while (n) {
+    BLO_library_link_named_part(main_tmp, &bpy_openlib, idcode, (char *)n->link, liblink_params);
+    n = (LinkNode *)n->next;
+    i++;
+
+    if (status) {
+      status->SetStageProgress((float)i / totnames);
+    }
+  }
+  BLI_linklist_free(names, free);  // free linklist *and* each node's data
+}
+
+/** Link the datablocks of a library into a new main, can be called from any thread.
+ *
+ * The linking only writes the new main and the temporary mains of the file data: the link
+ * parameters have no scene, view layer or flags, so nothing is instanced in G_MAIN and the
+ * relative paths are not remapped with the path of G_MAIN. The globals read by the linking
+ * (DNA, ID types and node types) are initialized at startup and not modified while the game
+ * runs, the ID session uid counter is atomic, and the main thread doesn't access the new main
+ * before it is added to the merge queue under the thread mutex. The versioning code run at the
+ * end of the linking is not written for concurrent calls, so the links of several libraries
+ * are serialized.
+ */
+static Main *link_library(
+    BlendHandle *bpy_openlib, const char *path, int idcode, short options, KX_LibLoadStatus *status)
+{
+  static CM_ThreadMutex linkMutex;
+  linkMutex.Lock();
+
+  Main *main_newlib = BKE_main_new();  // stored as a dynamic 'main' until we free it
+
+  // created only for linking, then freed
+  LibraryLink_Params liblink_params;
+  BLO_library_link_params_init(&liblink_params, main_newlib, 0, 0);
+  Main *main_tmp = BLO_library_link_begin(&bpy_openlib, path, &liblink_params);
+
+  load_datablocks(main_tmp, bpy_openlib, idcode, &liblink_params, status);
+
+  if (idcode == ID_SCE && options & BL_Converter::LIB_LOAD_LOAD_SCRIPTS) {
+    load_datablocks(main_tmp, bpy_openlib, ID_TXT, &liblink_params, nullptr);
+  }
+
+  // now do another round of linking for Scenes so all actions are properly loaded
+  if (idcode == ID_SCE && options & BL_Converter::LIB_LOAD_LOAD_ACTIONS) {
+    load_datablocks(main_tmp, bpy_openlib, ID_AC, &liblink_params, nullptr);
+  }
+
+  BLO_library_link_end(main_tmp, &bpy_openlib, &liblink_params);
+
+  linkMutex.Unlock();
+
+  return main_newlib;
+}
+
+/// Convert the scenes of a library, can be called from any thread.
+static std::vector<KX_Scene *> convert_scenes(KX_LibLoadStatus *status,
+                                              Main *main_newlib,
+                                              short options)
+{
+  std::vector<KX_Scene *> scenes;
+  const int numScenes = BLI_listbase_count(&main_newlib->scenes);
+
+  int i = 0;
+  for (ID *scene = (ID *)main_newlib->scenes.first; scene; scene = (ID *)scene->next) {
+    if (options & BL_Converter::LIB_LOAD_VERBOSE) {
+      CM_Debug("scene name: " << scene->name + 2);
+    }
+
+    KX_Scene *new_scene = status->GetEngine()->CreateScene((Scene *)scene, true);
     if (new_scene) {
-      merge_scenes->push_back(new_scene);
+      scenes.push_back(new_scene);
     }
 
-    status->AddProgress((1.0f / scenes->size()) *
-                        0.9f);  // We'll call conversion 90% and merging 10% for now
+    status->SetStageProgress((float)++i / numScenes);
   }
 
-  delete scenes;
-  status->SetData(merge_scenes);
+  return scenes;
+}
+
+static void async_load(TaskPool *__restrict /*pool*/, void *ptr)
+{
+  KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
+  AsyncLibLoad *load = (AsyncLibLoad *)status->GetData();
+
+  status->SetStage(KX_LibLoadStatus::STAGE_READ);
+  BlendHandle *bpy_openlib = (load->m_buffer.empty()) ?
+                                 BLO_blendhandle_from_file(load->m_path.c_str(), nullptr) :
+                                 BLO_blendhandle_from_memory(
+                                     load->m_buffer.data(), load->m_buffer.size(), nullptr);
+
+  if (bpy_openlib) {
+    status->SetStage(KX_LibLoadStatus::STAGE_LINK);
+    load->m_main = link_library(
+        bpy_openlib, load->m_path.c_str(), load->m_idcode, load->m_options, status);
+    BLO_blendhandle_close(bpy_openlib);
+
+    // The file data is not needed anymore.
+    std::vector<char>().swap(load->m_buffer);
+
+    if (load->m_idcode == ID_SCE) {
+      status->SetStage(KX_LibLoadStatus::STAGE_CONVERT);
+      load->m_scenes = convert_scenes(status, load->m_main, load->m_options);
+    }
+  }
 
+  // The merge and the conversion of the other data types are done in the main thread.
   status->GetConverter()->AddScenesToMergeQueue(status);
 }
 
 KX_LibLoadStatus *BL_Converter::LinkBlendFileMemory(void *data,
-                                                           int length,
-                                                           const char *path,
-                                                           char *group,
-                                                           KX_Scene *scene_merge,
-                                                           char **err_str,
-                                                           short options)
+                                                    int length,
+                                                    const char *path,
+                                                    char *group,
+                                                    KX_Scene *scene_merge,
+                                                    char **err_str,
+                                                    short options)
 {
+  if (options & LIB_LOAD_ASYNC) {
+    return LinkBlendFileAsync(data, length, path, group, scene_merge, err_str, options);
+  }
+
   BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length, nullptr);
 
   // Error checking is done in LinkBlendFile
@@ -378,96 +579,47 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFileMemory(void *data,
 KX_LibLoadStatus *BL_Converter::LinkBlendFilePath(
     const char *filepath, char *group, KX_Scene *scene_merge, char **err_str, short options)
 {
+  if (options & LIB_LOAD_ASYNC) {
+    return LinkBlendFileAsync(nullptr, 0, filepath, group, scene_merge, err_str, options);
+  }
+
   BlendHandle *bpy_openlib = BLO_blendhandle_from_file(filepath, nullptr);
 
   // Error checking is done in LinkBlendFile
   return LinkBlendFile(bpy_openlib, filepath, group, scene_merge, err_str, options);
 }
 
-static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char *path, int idcode)
+bool BL_Converter::CheckLinkBlendFile(const char *path, char *group, int &idcode, char **err_str)
 {
-  LinkNode *names = nullptr;
-
-  int totnames_dummy;
-  names = BLO_blendhandle_get_datablock_names(bpy_openlib, idcode, false, &totnames_dummy);
-
-  int i = 0;
-  LinkNode *n = names;
-  while (n) {
-    struct LibraryLink_Params liblink_params;
-    BLO_library_link_named_part(main_tmp, &bpy_openlib, idcode, (char *)n->link, &liblink_params);
-    n = (LinkNode *)n->next;
-    i++;
-  }
-  BLI_linklist_free(names, free);  // free linklist *and* each node's data
-}
-
-KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
-                                                     const char *path,
-                                                     char *group,
-                                                     KX_Scene *scene_merge,
-                                                     char **err_str,
-                                                     short options)
-{
-  Main *main_newlib;  // stored as a dynamic 'main' until we free it
-  const int idcode = BKE_idtype_idcode_from_name(group);
-  ReportList reports;
   static char err_local[255];
 
-  KX_LibLoadStatus *status;
+  idcode = BKE_idtype_idcode_from_name(group);
 
   // only scene and mesh supported right now
   if (idcode != ID_SCE && idcode != ID_ME && idcode != ID_AC) {
     snprintf(err_local, sizeof(err_local), "invalid ID type given \"%s\"\n", group);
     *err_str = err_local;
-    BLO_blendhandle_close(bpy_openlib);
-    return nullptr;
+    return false;
   }
 
-  if (GetMainDynamicPath(path)) {
+  // The libraries being loaded asynchronously are only in the status map.
+  if (GetMainDynamicPath(path) || m_status_map.count(path)) {
     snprintf(err_local, sizeof(err_local), "blend file already open \"%s\"\n", path);
     *err_str = err_local;
-    BLO_blendhandle_close(bpy_openlib);
-    return nullptr;
-  }
-
-  if (bpy_openlib == nullptr) {
-    snprintf(err_local, sizeof(err_local), "could not open blendfile \"%s\"\n", path);
-    *err_str = err_local;
-    return nullptr;
-  }
-
-  main_newlib = BKE_main_new();
-  BKE_reports_init(&reports, RPT_STORE);
-
-  // short flag = 0;  // don't need any special options
-  // created only for linking, then freed
-  struct LibraryLink_Params liblink_params;
-  Main *main_tmp = BLO_library_link_begin(&bpy_openlib, (char *)path, &liblink_params);
-
-  load_datablocks(main_tmp, bpy_openlib, path, idcode);
-
-  if (idcode == ID_SCE && options & LIB_LOAD_LOAD_SCRIPTS) {
-    load_datablocks(main_tmp, bpy_openlib, path, ID_TXT);
-  }
-
-  // now do another round of linking for Scenes so all actions are properly loaded
-  if (idcode == ID_SCE && options & LIB_LOAD_LOAD_ACTIONS) {
-    load_datablocks(main_tmp, bpy_openlib, path, ID_AC);
+    return false;
   }
 
-  BLO_library_link_end(main_tmp, &bpy_openlib, &liblink_params);
-
-  BLO_blendhandle_close(bpy_openlib);
-
-  BKE_reports_clear(&reports);
-  // done linking
-
-  // needed for lookups
-  m_DynamicMaggie.push_back(main_newlib);
-  BLI_strncpy(main_newlib->filepath, path, sizeof(main_newlib->filepath));
+  return true;
+}
 
-  status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+void BL_Converter::MergeLibrary(KX_LibLoadStatus *status,
+                                Main *main_newlib,
+                                int idcode,
+                                short options,
+                                const std::vector<KX_Scene *> &scenes)
+{
+  CM_TraceScope libLoadTrace("libload", status->GetLibraryName());
+  KX_Scene *scene_merge = status->GetMergeScene();
 
   if (idcode == ID_ME) {
     // Convert all new meshes into BGE meshes
@@ -505,34 +657,13 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
   }
   else if (idcode == ID_SCE) {
     // Merge all new linked in scene into the existing one
-    ID *scene;
-    // scenes gets deleted by the thread when it's done using it (look in async_convert())
-    std::vector<Scene *> *scenes = (options & LIB_LOAD_ASYNC) ? new std::vector<Scene *>() :
-                                                                nullptr;
-
-    for (scene = (ID *)main_newlib->scenes.first; scene; scene = (ID *)scene->next) {
-      if (options & LIB_LOAD_VERBOSE) {
-        CM_Debug("scene name: " << scene->name + 2);
-      }
+    for (unsigned int i = 0, size = scenes.size(); i < size; ++i) {
+      scene_merge->MergeScene(scenes[i]);
+      // RemoveScene(other); // Don't run this, it frees the entire scene converter data, just
+      // delete the scene
+      delete scenes[i];
 
-      if (options & LIB_LOAD_ASYNC) {
-        scenes->push_back((Scene *)scene);
-      }
-      else {
-        // merge into the base  scene
-        KX_Scene *other = m_ketsjiEngine->CreateScene((Scene *)scene, true);
-        scene_merge->MergeScene(other);
-
-        // RemoveScene(other); // Don't run this, it frees the entire scene converter data, just
-        // delete the scene
-        delete other;
-      }
-    }
-
-    if (options & LIB_LOAD_ASYNC) {
-      status->SetData(scenes);
-      BLI_task_pool_push(
-          m_threadinfo.m_pool, (TaskRunFunction)async_convert, (void *)status, false, NULL);
+      status->SetStageProgress((float)(i + 1) / size);
     }
 
 #ifdef WITH_PYTHON
@@ -554,15 +685,100 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
       }
     }
   }
+}
+
+KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
+                                              const char *path,
+                                              char *group,
+                                              KX_Scene *scene_merge,
+                                              char **err_str,
+                                              short options)
+{
+  static char err_local[255];
+
+  int idcode;
+  if (!CheckLinkBlendFile(path, group, idcode, err_str)) {
+    if (bpy_openlib) {
+      BLO_blendhandle_close(bpy_openlib);
+    }
+    return nullptr;
+  }
 
-  if (!(options & LIB_LOAD_ASYNC)) {
-    status->Finish();
+  if (bpy_openlib == nullptr) {
+    snprintf(err_local, sizeof(err_local), "could not open blendfile \"%s\"\n", path);
+    *err_str = err_local;
+    return nullptr;
   }
 
+  KX_LibLoadStatus *status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+
+  status->SetStage(KX_LibLoadStatus::STAGE_LINK);
+  Main *main_newlib = link_library(bpy_openlib, path, idcode, options, status);
+  BLO_blendhandle_close(bpy_openlib);
+
+  // needed for lookups
+  m_DynamicMaggie.push_back(main_newlib);
+  BLI_strncpy(main_newlib->filepath, path, sizeof(main_newlib->filepath));
+
+  std::vector<KX_Scene *> scenes;
+  if (idcode == ID_SCE) {
+    status->SetStage(KX_LibLoadStatus::STAGE_CONVERT);
+    scenes = convert_scenes(status, main_newlib, options);
+  }
+
+  status->SetStage(KX_LibLoadStatus::STAGE_MERGE);
+  MergeLibrary(status, main_newlib, idcode, options, scenes);
+  status->Finish();
+
   m_status_map[main_newlib->filepath] = status;
   return status;
 }
 
+KX_LibLoadStatus *BL_Converter::LinkBlendFileAsync(void *data,
+                                                   int length,
+                                                   const char *path,
+                                                   char *group,
+                                                   KX_Scene *scene_merge,
+                                                   char **err_str,
+                                                   short options)
+{
+  static char err_local[255];
+
+  int idcode;
+  if (!CheckLinkBlendFile(path, group, idcode, err_str)) {
+    return nullptr;
+  }
+
+  // The file is read in the loading thread, only check its existence here.
+  if (!data && !BLI_exists(path)) {
+    snprintf(err_local, sizeof(err_local), "could not open blendfile \"%s\"\n", path);
+    *err_str = err_local;
+    return nullptr;
+  }
+
+  AsyncLibLoad *load = new AsyncLibLoad();
+  load->m_path = path;
+  if (data) {
+    // The caller data is not guaranteed to live until the end of the loading.
+    load->m_buffer.assign((char *)data, (char *)data + length);
+  }
+  load->m_idcode = idcode;
+  load->m_options = options;
+  load->m_main = nullptr;
+  load->m_mergedScenes = 0;
+  load->m_merging = false;
+
+  KX_LibLoadStatus *status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+  status->SetData(load);
+
+  // Register the status now to reject loading the same file twice.
+  m_status_map[path] = status;
+
+  BLI_task_pool_push(m_threadinfo.m_pool, async_load, status, false, nullptr);
+
+  return status;
+}
+
 /** Note m_map_*** are all ok and don't need to be freed
  * most are temp and NewRemoveObject frees m_map_gameobject_to_blender */
 bool BL_Converter::FreeBlendFile(Main *maggie)
@@ -639,6 +855,9 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
         }
       }
 
+      // pooled copies of tagged objects reference the freed data
+      scene->FreeObjectPools(true);
+
       // removed tagged objects and meshes
       EXP_ListValue<KX_GameObject> *obj_lists[] = {
           scene->GetObjectList(), scene->GetInactiveList(), nullptr};
@@ -700,6 +919,9 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
           }
         }
       }
+
+      // the instanced replicas of tagged objects were removed above
+      scene->FreeInstanceBuffers(true);
     }
   }
 
@@ -754,7 +976,7 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
   removeImportMain(maggie);
 #endif
 
-  delete m_status_map[maggie->filepath];
+  m_status_map[maggie->filepath]->Free();
   m_status_map.erase(maggie->filepath);
 
   BKE_main_free(maggie);
@@ -764,6 +986,15 @@ bool BL_Converter::FreeBlendFile(Main *maggie)
 
 bool BL_Converter::FreeBlendFile(const std::string &path)
 {
+  // The library is not yet in the dynamic mains while it's loaded asynchronously.
+  const auto it = m_status_map.find(path);
+  if (it != m_status_map.end() && !it->second->IsFinished()) {
+    CM_Error("Library (" << path
+                         << ") is currently being loaded asynchronously, and cannot be freed "
+                            "until this process is done");
+    return false;
+  }
+
   return FreeBlendFile(GetMainDynamicPath(path));
 }
 
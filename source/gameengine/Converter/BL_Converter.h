@@ -84,6 +84,13 @@ class BL_Converter {
   // Saved KX_LibLoadStatus objects
   std::map<std::string, KX_LibLoadStatus *> m_status_map;
   std::vector<KX_LibLoadStatus *> m_mergequeue;
+  /// Loads taken from the merge queue and not yet entirely merged, used only by the main thread.
+  std::vector<KX_LibLoadStatus *> m_pendingmerges;
+  /// Maximum time in seconds spent merging libraries per frame, 0 for no limit.
+  double m_mergeBudget;
+  /** Directory of the BVH cache of the game, resolved in the main thread as the scenes can be
+   * converted in the loading threads, empty for an unsaved file. */
+  std::string m_bvhCacheDirectory;
 
   Main *m_maggie;
   std::vector<Main *> m_DynamicMaggie;
@@ -91,6 +98,30 @@ class BL_Converter {
   KX_KetsjiEngine *m_ketsjiEngine;
   bool m_alwaysUseExpandFraming;
 
+  /// Check that a library of the given type can be loaded, return false and set the error if not.
+  bool CheckLinkBlendFile(const char *path, char *group, int &idcode, char **err_str);
+  /// Convert and merge the data of a linked library in the merge scene of the status.
+  void MergeLibrary(KX_LibLoadStatus *status,
+                    Main *main_newlib,
+                    int idcode,
+                    short options,
+                    const std::vector<KX_Scene *> &scenes);
+  /// Merge a part of an asynchronous load, return true when it's finished.
+  bool MergeAsyncLoad(KX_LibLoadStatus *status, double endTime);
+  /// Merge the finished loads until the end time is reached, 0 to merge all.
+  void MergeAsyncLoads(double endTime);
+  /** Read, link and convert a library in a worker thread, only the merge is done in the main
+   * thread from MergeAsyncLoads.
+   * \param data The library data or nullptr to read the file at path.
+   */
+  KX_LibLoadStatus *LinkBlendFileAsync(void *data,
+                                       int length,
+                                       const char *path,
+                                       char *group,
+                                       KX_Scene *scene_merge,
+                                       char **err_str,
+                                       short options);
+
  public:
   BL_Converter(Main *maggie, KX_KetsjiEngine *engine);
   virtual ~BL_Converter();
@@ -143,8 +174,11 @@ class BL_Converter {
 
   void MergeScene(KX_Scene *to, KX_Scene *from);
 
+  /// Merge the finished asynchronous loads in the limit of the merge budget.
   void MergeAsyncLoads();
   void FinalizeAsyncLoads();
+  void SetMergeBudget(double budget);
+  double GetMergeBudget() const;
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
 
   void PrintStats();
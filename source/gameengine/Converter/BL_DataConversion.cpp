@@ -72,6 +72,7 @@
 #include "BKE_modifier.hh"
 #include "BKE_object.hh"
 #include "BKE_scene.hh"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_actuator_types.h"
 #include "DNA_meshdata_types.h"
@@ -350,27 +351,36 @@ static int GetPolygonMaterialIndex(const VArray<int> mat_indices, const Mesh *me
   return r;
 }
 
-/* blenderobj can be nullptr, make sure its checked for */
-RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
-                               Object *blenderobj,
-                               KX_Scene *scene,
-                               RAS_Rasterizer *rasty,
-                               BL_SceneConverter *converter,
-                               bool libloading,
-                               bool converting_during_runtime)
-{
+/// Material of a mesh converted before its geometry.
+struct BL_ConvertedMaterial {
+  Material *ma;
+  RAS_MeshMaterial *meshmat;
+  bool visible;
+  bool twoside;
+  bool collider;
+  bool wire;
+};
+
+/** A mesh object created with its materials, its geometry is converted after and can be
+ * converted from a worker thread as it only accesses data owned by the mesh.
+ */
+struct BL_MeshConversion {
+  Mesh *mesh;
+  Mesh *final_me;
   RAS_MeshObject *meshobj;
-  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
+  std::vector<BL_ConvertedMaterial> materials;
+};
 
-  // Without checking names, we get some reuse we don't want that can cause
-  // problems with material LoDs.
-  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
-    const std::string bge_name = meshobj->GetName();
-    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
-    if (bge_name == blender_name) {
-      return meshobj;
-    }
-  }
+/// Create the mesh object and convert its materials, must be called from the main thread.
+static void BL_CreateMeshObject(Mesh *mesh,
+                                Object *blenderobj,
+                                KX_Scene *scene,
+                                RAS_Rasterizer *rasty,
+                                BL_SceneConverter *converter,
+                                bool converting_during_runtime,
+                                BL_MeshConversion &conversion)
+{
+  int lightlayer = blenderobj ? blenderobj->lay : (1 << 20) - 1;  // all layers if no object.
 
   // Get Mesh data
   bContext *C = KX_GetActiveEngine()->GetContext();
@@ -378,15 +388,6 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   Object *ob_eval = DEG_get_evaluated_object(depsgraph, blenderobj);
   Mesh *final_me = (Mesh *)ob_eval->data;
 
-  BKE_mesh_tessface_ensure(final_me);
-
-  const blender::Span<blender::float3> positions = final_me->vert_positions();
-  const int totverts = final_me->verts_num;
-
-  const MFace *faces = (MFace *)CustomData_get_layer(&final_me->fdata_legacy, CD_MFACE);
-  const int totfaces = final_me->totface_legacy;
-  const int *mfaceToMpoly = (int *)CustomData_get_layer(&final_me->fdata_legacy, CD_ORIGINDEX);
-
   /* Extract available layers.
    * Get the active color and uv layer. */
   const short activeUv = CustomData_get_active_layer(&final_me->corner_data, CD_PROP_FLOAT2);
@@ -418,6 +419,71 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     layersInfo.layers.push_back({nullptr, col, i, name});
   }
 
+  RAS_MeshObject *meshobj = new RAS_MeshObject(mesh, final_me->verts_num, blenderobj, layersInfo);
+  meshobj->m_sharedvertex_map.resize(final_me->verts_num);
+
+  // Initialize vertex format with used uv and color layers.
+  RAS_VertexFormat vertformat;
+  vertformat.uvSize = max_ii(1, uvLayers);
+  vertformat.colorSize = max_ii(1, colorLayers);
+
+  const unsigned short totmat = max_ii(final_me->totcol, 1);
+  std::vector<BL_ConvertedMaterial> convertedMats(totmat);
+
+  // Convert all the materials contained in the mesh.
+  for (unsigned short i = 0; i < totmat; ++i) {
+    Material *ma = nullptr;
+    if (blenderobj) {
+      ma = BKE_object_material_get(ob_eval, i + 1);
+    }
+    else {
+      ma = final_me->mat ? final_me->mat[i] : nullptr;
+    }
+    // Check for blender material
+    if (!ma) {
+      ma = BKE_material_default_empty();
+    }
+
+    RAS_MaterialBucket *bucket = BL_material_from_mesh(
+        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
+    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
+
+    convertedMats[i] = {ma,
+                        meshmat,
+                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
+                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
+                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
+                        bucket->IsWire()};
+  }
+
+  conversion.mesh = mesh;
+  conversion.final_me = final_me;
+  conversion.meshobj = meshobj;
+  conversion.materials = std::move(convertedMats);
+}
+
+/// Convert the vertices and polygons of a mesh object created by BL_CreateMeshObject.
+static void BL_ConvertMeshGeometry(const BL_MeshConversion &conversion)
+{
+  RAS_MeshObject *meshobj = conversion.meshobj;
+  Mesh *final_me = conversion.final_me;
+  const std::vector<BL_ConvertedMaterial> &convertedMats = conversion.materials;
+  const RAS_MeshObject::LayersInfo &layersInfo = meshobj->GetLayersInfo();
+
+  BKE_mesh_tessface_ensure(final_me);
+
+  const blender::Span<blender::float3> positions = final_me->vert_positions();
+  const int totverts = final_me->verts_num;
+
+  const MFace *faces = (MFace *)CustomData_get_layer(&final_me->fdata_legacy, CD_MFACE);
+  const int totfaces = final_me->totface_legacy;
+  const int *mfaceToMpoly = (int *)CustomData_get_layer(&final_me->fdata_legacy, CD_ORIGINDEX);
+
+  const unsigned short uvLayers = CustomData_number_of_layers(&final_me->corner_data,
+                                                              CD_PROP_FLOAT2);
+  const unsigned short colorLayers = CustomData_number_of_layers(&final_me->corner_data,
+                                                                 CD_PROP_BYTE_COLOR);
+
   blender::Span<float3> loop_nors_dst;
   float(*loop_normals)[3] = (float(*)[3])CustomData_get_layer(&final_me->corner_data, CD_NORMAL);
   const bool do_loop_nors = (loop_normals == nullptr);
@@ -460,52 +526,6 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     tangent = (float(*)[4])CustomData_get_layer(&final_me->corner_data, CD_TANGENT);
   }
 
-  meshobj = new RAS_MeshObject(mesh, final_me->verts_num, blenderobj, layersInfo);
-  meshobj->m_sharedvertex_map.resize(totverts);
-
-  // Initialize vertex format with used uv and color layers.
-  RAS_VertexFormat vertformat;
-  vertformat.uvSize = max_ii(1, uvLayers);
-  vertformat.colorSize = max_ii(1, colorLayers);
-
-  struct ConvertedMaterial {
-    Material *ma;
-    RAS_MeshMaterial *meshmat;
-    bool visible;
-    bool twoside;
-    bool collider;
-    bool wire;
-  };
-
-  const unsigned short totmat = max_ii(final_me->totcol, 1);
-  std::vector<ConvertedMaterial> convertedMats(totmat);
-
-  // Convert all the materials contained in the mesh.
-  for (unsigned short i = 0; i < totmat; ++i) {
-    Material *ma = nullptr;
-    if (blenderobj) {
-      ma = BKE_object_material_get(ob_eval, i + 1);
-    }
-    else {
-      ma = final_me->mat ? final_me->mat[i] : nullptr;
-    }
-    // Check for blender material
-    if (!ma) {
-      ma = BKE_material_default_empty();
-    }
-
-    RAS_MaterialBucket *bucket = BL_material_from_mesh(
-        ma, lightlayer, scene, rasty, converter, converting_during_runtime);
-    RAS_MeshMaterial *meshmat = meshobj->AddMaterial(bucket, i, vertformat);
-
-    convertedMats[i] = {ma,
-                        meshmat,
-                        ((ma->game.flag & GEMAT_INVISIBLE) == 0),
-                        ((ma->game.flag & GEMAT_BACKCULL) == 0),
-                        ((ma->game.flag & GEMAT_NOPHYSICS) == 0),
-                        bucket->IsWire()};
-  }
-
   std::vector<std::vector<unsigned int>> mpolyToMface(final_me->faces().size());
   // Generate a list of all mfaces wrapped by a mpoly.
   for (unsigned int i = 0; i < totfaces; ++i) {
@@ -533,7 +553,7 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     /* There is still an issue with boolean exact solver with polygon material indice */
     int mat_nr = GetPolygonMaterialIndex(material_indices, final_me, i);
 
-    const ConvertedMaterial &mat = convertedMats[mat_nr];
+    const BL_ConvertedMaterial &mat = convertedMats[mat_nr];
 
     RAS_MeshMaterial *meshmat = mat.meshmat;
 
@@ -584,6 +604,14 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
   // 2.49a and before it did: meshobj->m_sharedvertex_map.clear();
   // but this didnt save much ram. - Campbell
   meshobj->EndConversion();
+}
+
+/// Finalize the materials and register a mesh object converted by BL_ConvertMeshGeometry.
+static void BL_EndMeshConversion(const BL_MeshConversion &conversion,
+                                 BL_SceneConverter *converter,
+                                 bool libloading)
+{
+  RAS_MeshObject *meshobj = conversion.meshobj;
 
   // Finalize materials.
   // However, we want to delay this if we're libloading so we can make sure we have the right
@@ -595,8 +623,83 @@ RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
     }
   }
 
-  converter->RegisterGameMesh(meshobj, mesh);
-  return meshobj;
+  converter->RegisterGameMesh(meshobj, conversion.mesh);
+}
+
+/* blenderobj can be nullptr, make sure its checked for */
+RAS_MeshObject *BL_ConvertMesh(Mesh *mesh,
+                               Object *blenderobj,
+                               KX_Scene *scene,
+                               RAS_Rasterizer *rasty,
+                               BL_SceneConverter *converter,
+                               bool libloading,
+                               bool converting_during_runtime)
+{
+  RAS_MeshObject *meshobj;
+
+  // Without checking names, we get some reuse we don't want that can cause
+  // problems with material LoDs.
+  if (blenderobj && ((meshobj = converter->FindGameMesh(mesh /*, ob->lay*/)) != nullptr)) {
+    const std::string bge_name = meshobj->GetName();
+    const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
+    if (bge_name == blender_name) {
+      return meshobj;
+    }
+  }
+
+  BL_MeshConversion conversion;
+  BL_CreateMeshObject(
+      mesh, blenderobj, scene, rasty, converter, converting_during_runtime, conversion);
+  BL_ConvertMeshGeometry(conversion);
+  BL_EndMeshConversion(conversion, converter, libloading);
+
+  return conversion.meshobj;
+}
+
+static void convert_mesh_geometry_func(void *__restrict userdata,
+                                       const int index,
+                                       const TaskParallelTLS *__restrict /*tls*/)
+{
+  const std::vector<BL_MeshConversion> &conversions = *(std::vector<BL_MeshConversion> *)userdata;
+  BL_ConvertMeshGeometry(conversions[index]);
+}
+
+/** Convert the meshes of the objects before the objects themselves. The mesh objects and their
+ * materials are created serially, then the geometry of each unique mesh is converted in
+ * parallel. The conversion of the objects then reuses the registered mesh objects.
+ */
+static void BL_ConvertMeshes(const std::vector<Object *> &objects,
+                             KX_Scene *scene,
+                             RAS_Rasterizer *rasty,
+                             BL_SceneConverter *converter,
+                             bool libloading)
+{
+  std::vector<BL_MeshConversion> conversions;
+  std::set<Mesh *> meshes;
+  for (Object *ob : objects) {
+    if (ob->type != OB_MESH) {
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(ob->data);
+    if (converter->FindGameMesh(mesh) || !meshes.insert(mesh).second) {
+      continue;
+    }
+
+    conversions.emplace_back();
+    BL_CreateMeshObject(mesh, ob, scene, rasty, converter, false, conversions.back());
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(
+      0, conversions.size(), &conversions, convert_mesh_geometry_func, &settings);
+
+  for (const BL_MeshConversion &conversion : conversions) {
+    BL_EndMeshConversion(conversion, converter, libloading);
+  }
 }
 
 //////////////////////////////////////////////////////
@@ -969,6 +1072,11 @@ static KX_GameObject *BL_gameobject_from_blenderobject(Object *ob,
     gameobj->SetScene(kxscene);
     gameobj->SetBlenderObject(ob);
 
+    // The transform of the object is read from blender at every render pass.
+    if (ob->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY) {
+      kxscene->AddAlwaysDirtyRenderObject(gameobj);
+    }
+
     /* Bakup Objects object_to_world to restore at scene exit */
     if (kxscene->GetBlenderScene()->gm.flag & GAME_USE_UNDO) {
       if (!converting_during_runtime) {
@@ -1108,6 +1216,12 @@ static std::vector<Object *> lod_level_object_list(ViewLayer *view_layer)
   return lod_objs;
 }
 
+static bool bl_object_in_active_layer(Object *blenderobject)
+{
+  return (blenderobject->base_flag & (BASE_ENABLED_AND_MAYBE_VISIBLE_IN_VIEWPORT |
+                                      BASE_ENABLED_AND_VISIBLE_IN_DEFAULT_VIEWPORT)) != 0;
+}
+
 static bool is_lod_level(std::vector<Object *> lod_objs, Object *blenderobject)
 {
   return std::find(lod_objs.begin(), lod_objs.end(), blenderobject) != lod_objs.end();
@@ -1361,6 +1475,23 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
   bool converting_during_runtime = single_object != nullptr;
   bool converting_instance_col_at_runtime = single_object && single_object->instance_collection && converter->FindGameObject(single_object) == nullptr;
 
+  if (!single_object) {
+    /* Convert the meshes of all the objects first to convert their geometry in parallel, the
+     * layer used by the materials is set as in the objects conversion. */
+    std::vector<Object *> meshObjects;
+    for (SETLOOPER(blenderscene, sce_iter, base)) {
+      Object *blenderobject = base->object;
+      if (blenderobject->type != OB_MESH || converter->FindGameObject(blenderobject) != nullptr) {
+        continue;
+      }
+
+      blenderobject->lay = bl_object_in_active_layer(blenderobject) ? blenderscene->lay : 0;
+      meshObjects.push_back(blenderobject);
+    }
+
+    BL_ConvertMeshes(meshObjects, kxscene, rendertools, converter, libloading);
+  }
+
   // Let's support scene set.
   // Beware of name conflict in linked data, it will not crash but will create confusion
   // in Python scripting and in certain actuators (replace mesh). Linked scene *should* have
@@ -1385,9 +1516,7 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       }
     }
 
-    bool isInActiveLayer = (blenderobject->base_flag &
-                            (BASE_ENABLED_AND_MAYBE_VISIBLE_IN_VIEWPORT |
-                             BASE_ENABLED_AND_VISIBLE_IN_DEFAULT_VIEWPORT)) != 0;
+    bool isInActiveLayer = bl_object_in_active_layer(blenderobject);
     blenderobject->lay = isInActiveLayer ? blenderscene->lay : 0;
 
     /* Force OB_RESTRICT_VIEWPORT to avoid not needed depsgraph operations in some cases,
@@ -1597,6 +1726,7 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       parentlist->Add(CM_AddRef(gameobj));
       gameobj->NodeUpdateGS(0);
     }
+    kxscene->UpdateDepsgraphResetObject(gameobj);
   }
 
   if (!single_object) {
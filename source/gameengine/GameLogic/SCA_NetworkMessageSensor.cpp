@@ -32,8 +32,7 @@
 
 #include "SCA_NetworkMessageSensor.h"
 
-#include "EXP_ListValue.h"
-#include "EXP_StringValue.h"
+#include "EXP_ListWrapper.h"
 #include "KX_NetworkMessageScene.h"
 
 #ifdef NAN_NET_DEBUG
@@ -48,9 +47,7 @@ SCA_NetworkMessageSensor::SCA_NetworkMessageSensor(
     : SCA_ISensor(gameobj, eventmgr),
       m_NetworkScene(NetworkScene),
       m_subject(subject),
-      m_frame_message_count(0),
-      m_BodyList(nullptr),
-      m_SubjectList(nullptr)
+      m_frame_message_count(0)
 {
   Init();
 }
@@ -86,47 +83,16 @@ bool SCA_NetworkMessageSensor::Evaluate()
 
   m_IsUp = false;
 
-  if (m_BodyList) {
-    m_BodyList->Release();
-    m_BodyList = nullptr;
-  }
-
-  if (m_SubjectList) {
-    m_SubjectList->Release();
-    m_SubjectList = nullptr;
-  }
+  const std::string &toname = GetParent()->GetName();
+  m_messages = m_NetworkScene->FindMessages(toname, m_subject);
 
-  std::string toname = GetParent()->GetName();
-  std::string &subject = this->m_subject;
+  m_frame_message_count = m_messages.GetSize();
 
-  const std::vector<KX_NetworkMessageManager::Message> messages = m_NetworkScene->FindMessages(
-      toname, subject);
-
-  m_frame_message_count = messages.size();
-
-  if (!messages.empty()) {
+  if (m_frame_message_count > 0) {
 #ifdef NAN_NET_DEBUG
     std::cout << "SCA_NetworkMessageSensor found one or more messages" << std::endl;
 #endif
     m_IsUp = true;
-    m_BodyList = new EXP_ListValue<EXP_StringValue>();
-    m_SubjectList = new EXP_ListValue<EXP_StringValue>();
-  }
-
-  std::vector<KX_NetworkMessageManager::Message>::const_iterator mesit;
-  for (mesit = messages.begin(); mesit != messages.end(); mesit++) {
-    // save the body
-    const std::string &body = (*mesit).body;
-    // save the subject
-    const std::string &messub = (*mesit).subject;
-#ifdef NAN_NET_DEBUG
-    if (body) {
-      cout << "body [" << body << "]\n";
-    }
-#endif
-    m_BodyList->Add(new EXP_StringValue(body, "body"));
-    // Store Subject
-    m_SubjectList->Add(new EXP_StringValue(messub, "subject"));
   }
 
   result = (WasUp != m_IsUp);
@@ -206,28 +172,49 @@ PyAttributeDef SCA_NetworkMessageSensor::Attributes[] = {
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
+int SCA_NetworkMessageSensor::get_messages_size_cb(void *self_v)
+{
+  return ((SCA_NetworkMessageSensor *)self_v)->m_messages.GetSize();
+}
+
+PyObject *SCA_NetworkMessageSensor::get_bodies_item_cb(void *self_v, int index)
+{
+  const std::string_view body = ((SCA_NetworkMessageSensor *)self_v)->m_messages.GetBody(index);
+  return PyUnicode_FromStringAndSize(body.data(), body.size());
+}
+
+PyObject *SCA_NetworkMessageSensor::get_subjects_item_cb(void *self_v, int index)
+{
+  const std::string &subject = ((SCA_NetworkMessageSensor *)self_v)->m_messages.GetSubject(index);
+  return PyUnicode_FromStringAndSize(subject.c_str(), subject.size());
+}
+
 PyObject *SCA_NetworkMessageSensor::pyattr_get_bodies(EXP_PyObjectPlus *self_v,
                                                       const EXP_PYATTRIBUTE_DEF *attrdef)
 {
-  SCA_NetworkMessageSensor *self = static_cast<SCA_NetworkMessageSensor *>(self_v);
-  if (self->m_BodyList) {
-    return self->m_BodyList->GetProxy();
-  }
-  else {
-    return (new EXP_ListValue<EXP_StringValue>())->NewProxy(true);
-  }
+  return (new EXP_ListWrapper(self_v,
+                              ((SCA_NetworkMessageSensor *)self_v)->GetProxy(),
+                              nullptr,
+                              SCA_NetworkMessageSensor::get_messages_size_cb,
+                              SCA_NetworkMessageSensor::get_bodies_item_cb,
+                              nullptr,
+                              nullptr,
+                              EXP_ListWrapper::FLAG_FIND_VALUE))
+      ->NewProxy(true);
 }
 
 PyObject *SCA_NetworkMessageSensor::pyattr_get_subjects(EXP_PyObjectPlus *self_v,
                                                         const EXP_PYATTRIBUTE_DEF *attrdef)
 {
-  SCA_NetworkMessageSensor *self = static_cast<SCA_NetworkMessageSensor *>(self_v);
-  if (self->m_SubjectList) {
-    return self->m_SubjectList->GetProxy();
-  }
-  else {
-    return (new EXP_ListValue<EXP_StringValue>())->NewProxy(true);
-  }
+  return (new EXP_ListWrapper(self_v,
+                              ((SCA_NetworkMessageSensor *)self_v)->GetProxy(),
+                              nullptr,
+                              SCA_NetworkMessageSensor::get_messages_size_cb,
+                              SCA_NetworkMessageSensor::get_subjects_item_cb,
+                              nullptr,
+                              nullptr,
+                              EXP_ListWrapper::FLAG_FIND_VALUE))
+      ->NewProxy(true);
 }
 
 #endif  // WITH_PYTHON
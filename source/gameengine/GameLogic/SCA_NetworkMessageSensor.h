@@ -31,11 +31,10 @@
  */
 #pragma once
 
+#include "KX_NetworkMessageManager.h"
 #include "SCA_ISensor.h"
 
 class KX_NetworkMessageScene;
-class EXP_StringValue;
-template<class ItemType> class EXP_ListValue;
 
 class SCA_NetworkMessageSensor : public SCA_ISensor {
   // note: Py_Header MUST BE the first listed here
@@ -49,8 +48,8 @@ class SCA_NetworkMessageSensor : public SCA_ISensor {
 
   bool m_IsUp;
 
-  EXP_ListValue<EXP_StringValue> *m_BodyList;
-  EXP_ListValue<EXP_StringValue> *m_SubjectList;
+  /// The messages received in the last evaluation, empty after the frame.
+  KX_NetworkMessageManager::MessageView m_messages;
 
  public:
   SCA_NetworkMessageSensor(SCA_EventManager *eventmgr,            // our eventmanager
@@ -76,6 +75,10 @@ class SCA_NetworkMessageSensor : public SCA_ISensor {
   /* Python interface -------------------------------------------- */
   /* ------------------------------------------------------------- */
 
+  static int get_messages_size_cb(void *self_v);
+  static PyObject *get_bodies_item_cb(void *self_v, int index);
+  static PyObject *get_subjects_item_cb(void *self_v, int index);
+
   /* attributes */
   static PyObject *pyattr_get_bodies(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_subjects(EXP_PyObjectPlus *self_v,
@@ -40,6 +40,9 @@
 #endif  // WITH_PYTHON
 
 #include "CM_Message.h"
+#include "CM_Trace.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 // initialize static member variables
 SCA_PythonController *SCA_PythonController::m_sCurrentController = nullptr;
@@ -346,6 +349,10 @@ bool SCA_PythonController::Import()
 
 void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
 {
+  CM_TraceScope pythonTrace("python", m_scriptName);
+  KX_PythonProfiler::Scope profile(KX_GetActiveEngine()->GetPythonProfiler(),
+                                   m_scriptName.c_str());
+
   m_sCurrentController = this;
 
   PyObject *excdict = nullptr;
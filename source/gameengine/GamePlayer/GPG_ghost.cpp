@@ -76,6 +76,7 @@
 #include "BLI_string.h"
 #include "BLI_system.h"
 #include "BLI_task.h"
+#include "BLI_time.h"
 #include "BLI_timer.h"
 #include "BLO_readfile.hh"
 #include "BLO_runtime.hh"
@@ -542,7 +543,8 @@ static void usage(const std::string &program, bool isBlenderPlayer)
 #ifdef _WIN32
   CM_Message("  -c: keep console window open" << std::endl);
 #endif
-  CM_Message("  -d: debugging options:");
+  CM_Message("  -d: debugging options, without option print the game data read time and the");
+  CM_Message("      startup time:");
   CM_Message("       memory        Debug memory leaks");
   CM_Message("       gpu           Debug gpu error and warnings" << std::endl);
   CM_Message("  -g: game engine options:" << std::endl);
@@ -553,12 +555,19 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_framerate                 0         Show the frame rate");
   CM_Message("       show_properties                0         Show debug properties");
   CM_Message("       show_profile                   0         Show profiling information");
+  CM_Message("       profile_python                 0         Measure the Python scripts time");
   CM_Message("       show_bounding_box              0         Show debug bounding box volume");
   CM_Message("       show_armatures                 0         Show debug armatures");
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
-  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
+  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+  CM_Message("       benchmark_frames               0         Quit after the number of frames");
+  CM_Message("                                                and print the profiling times");
+  CM_Message("       benchmark_warmup              10         Frames run before the benchmark");
+  CM_Message("       trace_file                               Record the frame spans and write");
+  CM_Message("                                                them to this Chrome trace file");
+  CM_Message("       trace_events              262144         Number of spans kept in the trace"
              << std::endl);
   CM_Message("  -p: override python main loop script");
   CM_Message(std::endl);
@@ -631,6 +640,8 @@ static BlendFileData *load_game_data(const char *progname,
   BlendFileReadReport breports;
   breports.reports = &reports;
 
+  const double startTime = BLI_time_now_seconds();
+
   /* try to load ourself, will only work if we are a runtime */
   if (BLO_is_a_runtime(progname)) {
     bfd = BLO_read_runtime(progname, &breports);
@@ -643,6 +654,11 @@ static BlendFileData *load_game_data(const char *progname,
     bfd = BLO_read_from_file(progname, BLO_READ_SKIP_NONE, &breports);
   }
 
+  if (bfd && (G.debug & G_DEBUG)) {
+    CM_Debug("game data read from " << progname << " in "
+                                    << (BLI_time_now_seconds() - startTime) * 1000.0 << " ms");
+  }
+
   if (!bfd && filename) {
     bfd = load_game_data(filename);
     if (!bfd) {
@@ -747,6 +763,8 @@ int main(int argc,
 #endif
 )
 {
+  const double startTime = BLI_time_now_seconds();
+  bool startupTimeReported = false;
   int i;
   int argc_py_clamped = argc; /* use this so python args can be added after ' - ' */
   bool error = false;
@@ -1142,14 +1160,18 @@ int main(int argc,
         case 'd':  // debug on
         {
           ++i;
+          // A bare -d only prints the startup timing.
+          G.debug |= G_DEBUG;
+
+          if ((i + 1) > validArguments || argv[i][0] == '-') {
+            break;
+          }
 
           if (strcmp(argv[i], "gpu") == 0) {
-            G.debug |= G_DEBUG_GPU | G_DEBUG;
+            G.debug |= G_DEBUG_GPU;
             ++i;
           }
           else if (strcmp(argv[i], "memory") == 0) {
-            G.debug |= G_DEBUG;
-
             CM_Debug("Switching to fully guarded memory allocator.");
             MEM_use_guarded_allocator();
 
@@ -1791,6 +1813,11 @@ int main(int argc,
 
             launcher.InitEngine();
 
+            if ((G.debug & G_DEBUG) && !startupTimeReported) {
+              CM_Debug("startup time: " << (BLI_time_now_seconds() - startTime) * 1000.0 << " ms");
+              startupTimeReported = true;
+            }
+
             // Enter main loop
             launcher.EngineMainLoop();
 
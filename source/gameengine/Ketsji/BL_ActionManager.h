@@ -120,4 +120,15 @@ class BL_ActionManager {
    * manages actions' frames.
    */
   void Update(float curtime, bool applyToObject);
+
+  /**
+   * Update the running actions without syncing the scene graph, used when the actions of
+   * several objects are updated in parallel, UpdateIPOs must be called after.
+   * \param curtime The current time used to compute the actions' frame.
+   * \param applyToObject Set to true if the actions must transform the object, else it only
+   * manages actions' frames.
+   */
+  void UpdateActions(float curtime, bool applyToObject);
+  /// Sync the object and its children in the scene graph after the actions update.
+  void UpdateIPOs();
 };
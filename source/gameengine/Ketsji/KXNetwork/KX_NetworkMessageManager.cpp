@@ -32,58 +32,180 @@
 
 #include "KX_NetworkMessageManager.h"
 
-KX_NetworkMessageManager::KX_NetworkMessageManager() : m_currentList(0)
+#include <algorithm>
+#include <climits>
+
+/// Order the messages by receiver and then subject.
+static bool message_less(const KX_NetworkMessageManager::Message &a,
+                         const KX_NetworkMessageManager::Message &b)
 {
+  return (a.to < b.to) || (a.to == b.to && a.subject < b.subject);
 }
 
-KX_NetworkMessageManager::~KX_NetworkMessageManager()
+KX_NetworkMessageManager::MessageView::MessageView() : m_manager(nullptr), m_frame(0)
+{
+  m_ranges[0][0] = m_ranges[0][1] = m_ranges[1][0] = m_ranges[1][1] = nullptr;
+}
+
+bool KX_NetworkMessageManager::MessageView::IsValid() const
+{
+  return (m_manager && m_manager->m_frame == m_frame);
+}
+
+unsigned int KX_NetworkMessageManager::MessageView::GetSize() const
+{
+  if (!IsValid()) {
+    return 0;
+  }
+  return (m_ranges[0][1] - m_ranges[0][0]) + (m_ranges[1][1] - m_ranges[1][0]);
+}
+
+const KX_NetworkMessageManager::Message &KX_NetworkMessageManager::MessageView::operator[](
+    unsigned int index) const
+{
+  const unsigned int firstSize = m_ranges[0][1] - m_ranges[0][0];
+  if (index < firstSize) {
+    return m_ranges[0][0][index];
+  }
+  return m_ranges[1][0][index - firstSize];
+}
+
+const std::string &KX_NetworkMessageManager::MessageView::GetSubject(unsigned int index) const
 {
-  ClearMessages();
+  return *m_manager->m_names[(*this)[index].subject];
 }
 
-void KX_NetworkMessageManager::AddMessage(KX_NetworkMessageManager::Message message)
+std::string_view KX_NetworkMessageManager::MessageView::GetBody(unsigned int index) const
 {
-  // Put the new message in map for the given receiver and subject.
-  m_messages[m_currentList][message.to][message.subject].push_back(message);
+  const Message &message = (*this)[index];
+  const std::string &bodies = m_manager->m_bodies[1 - m_manager->m_currentList];
+  return std::string_view(bodies.data() + message.bodyOffset, message.bodyLength);
 }
 
-const std::vector<KX_NetworkMessageManager::Message> KX_NetworkMessageManager::GetMessages(
-    std::string to, std::string subject)
+KX_NetworkMessageManager::KX_NetworkMessageManager() : m_currentList(0), m_frame(0)
+{
+  // The empty name is always the first id.
+  RegisterName("");
+}
+
+KX_NetworkMessageManager::~KX_NetworkMessageManager()
 {
-  std::vector<KX_NetworkMessageManager::Message> messages;
-
-  // look at messages without receiver.
-  std::map<std::string, std::vector<Message>> &messagesNoReceiver =
-      m_messages[1 - m_currentList][""];
-  std::map<std::string, std::vector<Message>> &messagesReceiver =
-      m_messages[1 - m_currentList][to];
-  if (subject.empty()) {
-    // Add all message without receiver and subject.
-    for (const auto &pair : messagesNoReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+}
+
+unsigned int KX_NetworkMessageManager::RegisterName(const std::string &name)
+{
+  const bool reuseId = !m_freeNameIds.empty();
+  const auto pair = m_nameIds.emplace(name, reuseId ? m_freeNameIds.back() : m_names.size());
+  const unsigned int id = pair.first->second;
+  if (pair.second) {
+    if (reuseId) {
+      m_freeNameIds.pop_back();
+      m_names[id] = &pair.first->first;
     }
-    // Add all message with the given receiver and no subject.
-    for (const auto &pair : messagesReceiver) {
-      messages.insert(messages.end(), pair.second.begin(), pair.second.end());
+    else {
+      m_names.push_back(&pair.first->first);
+      m_nameUsers.push_back(0);
     }
   }
-  else {
-    std::vector<KX_NetworkMessageManager::Message> &messagesNoReceiverSubject =
-        messagesNoReceiver[subject];
-    messages.insert(
-        messages.end(), messagesNoReceiverSubject.begin(), messagesNoReceiverSubject.end());
-    std::vector<KX_NetworkMessageManager::Message> &messagesReceiverSubject =
-        messagesReceiver[subject];
-    messages.insert(
-        messages.end(), messagesReceiverSubject.begin(), messagesReceiverSubject.end());
+
+  ++m_nameUsers[id];
+  return id;
+}
+
+void KX_NetworkMessageManager::ReleaseName(unsigned int id)
+{
+  if (--m_nameUsers[id] > 0) {
+    return;
   }
 
-  return messages;
+  m_nameIds.erase(m_nameIds.find(*m_names[id]));
+  m_names[id] = nullptr;
+  m_freeNameIds.push_back(id);
+}
+
+bool KX_NetworkMessageManager::FindName(const std::string &name, unsigned int &id) const
+{
+  const auto it = m_nameIds.find(name);
+  if (it == m_nameIds.end()) {
+    return false;
+  }
+  id = it->second;
+  return true;
+}
+
+void KX_NetworkMessageManager::AddMessage(const std::string &to,
+                                          SCA_IObject *from,
+                                          const std::string &subject,
+                                          const std::string &body)
+{
+  std::string &bodies = m_bodies[m_currentList];
+
+  Message message;
+  message.to = RegisterName(to);
+  message.subject = RegisterName(subject);
+  message.from = from;
+  message.bodyOffset = bodies.size();
+  message.bodyLength = body.size();
+
+  bodies.append(body);
+  m_messages[m_currentList].push_back(message);
+}
+
+KX_NetworkMessageManager::MessageView KX_NetworkMessageManager::GetMessages(
+    const std::string &to, const std::string &subject) const
+{
+  MessageView view;
+  view.m_manager = this;
+  view.m_frame = m_frame;
+
+  unsigned int subjectId = EMPTY_NAME;
+  if (!subject.empty() && !FindName(subject, subjectId)) {
+    // No message ever used this subject.
+    return view;
+  }
+
+  unsigned int toIds[2] = {EMPTY_NAME, EMPTY_NAME};
+  // Look at messages without receiver and then messages with the given receiver.
+  const unsigned int numReceivers = (FindName(to, toIds[1]) && toIds[1] != EMPTY_NAME) ? 2 : 1;
+
+  const std::vector<Message> &messages = m_messages[1 - m_currentList];
+  const Message *begin = messages.data();
+  const Message *end = begin + messages.size();
+  for (unsigned int i = 0; i < numReceivers; ++i) {
+    Message first;
+    Message last;
+    first.to = last.to = toIds[i];
+    if (subject.empty()) {
+      // All the subjects of the receiver.
+      first.subject = 0;
+      last.subject = UINT_MAX;
+    }
+    else {
+      first.subject = last.subject = subjectId;
+    }
+
+    view.m_ranges[i][0] = std::lower_bound(begin, end, first, message_less);
+    view.m_ranges[i][1] = std::upper_bound(view.m_ranges[i][0], end, last, message_less);
+  }
+
+  return view;
 }
 
 void KX_NetworkMessageManager::ClearMessages()
 {
-  // Clear previous list.
+  // Clear previous list, its views are invalidated below so its names can be released.
+  for (const Message &message : m_messages[1 - m_currentList]) {
+    ReleaseName(message.to);
+    ReleaseName(message.subject);
+  }
   m_messages[1 - m_currentList].clear();
+  m_bodies[1 - m_currentList].clear();
   m_currentList = 1 - m_currentList;
+
+  /* Sort the messages of the ended frame, the messages of a receiver and subject are then
+   * contiguous. The stable sort keeps the sending order of these messages. */
+  std::vector<Message> &messages = m_messages[1 - m_currentList];
+  std::stable_sort(messages.begin(), messages.end(), message_less);
+
+  ++m_frame;
 }
@@ -34,50 +34,109 @@ conflicts with KX_NetworkMessageManager::SendMessage */
 #  undef SendMessage
 #endif
 
-#include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 class SCA_IObject;
 
+/** Loopback message bus.
+ * The receiver and subject names are interned to integer ids, a name is released with its id
+ * once no message of the two lists uses it anymore, and the messages of a frame are
+ * stored contiguously, sorted by receiver and subject when the frame ends. The messages of the
+ * last frame are then accessed through views referencing this storage without copy.
+ */
 class KX_NetworkMessageManager {
  public:
+  /// Id of the empty name, used for messages without receiver or subject.
+  static const unsigned int EMPTY_NAME = 0;
+
   struct Message {
-    /// Receiver object(s) name.
-    std::string to;
+    /// Receiver object(s) name id.
+    unsigned int to;
+    /// Message subject id, used as filter.
+    unsigned int subject;
     /// Sender game object.
     SCA_IObject *from;
-    /// Message subject, used as filter.
-    std::string subject;
-    /// Message body.
-    std::string body;
+    /// Message body location in the bodies storage of the frame.
+    unsigned int bodyOffset;
+    unsigned int bodyLength;
+  };
+
+  /** View on the messages of the last frame matching a receiver and a subject.
+   * A view is valid until the end of the frame, after what it is empty.
+   */
+  class MessageView {
+    friend class KX_NetworkMessageManager;
+
+   private:
+    const KX_NetworkMessageManager *m_manager;
+    /// Messages without receiver followed by the messages with the receiver.
+    const Message *m_ranges[2][2];
+    /// Frame the view was created for.
+    unsigned int m_frame;
+
+   public:
+    MessageView();
+
+    bool IsValid() const;
+    unsigned int GetSize() const;
+    const Message &operator[](unsigned int index) const;
+    const std::string &GetSubject(unsigned int index) const;
+    std::string_view GetBody(unsigned int index) const;
   };
 
  private:
-  /** List of all messages, filtered by receiver object(s) name and subject name.
-   * We use two lists, one handle sended message in the current frame and the other
+  /// Id of each interned name.
+  std::unordered_map<std::string, unsigned int> m_nameIds;
+  /// Interned names indexed by id, pointing to the keys of m_nameIds, nullptr for a free id.
+  std::vector<const std::string *> m_names;
+  /// Number of messages using each name, the empty name is always used by the manager.
+  std::vector<unsigned int> m_nameUsers;
+  /// Ids of the released names, reused by the next names.
+  std::vector<unsigned int> m_freeNameIds;
+
+  /** We use two lists, one handle sended message in the current frame and the other
    * is used for handle message sended in the last frame for sensors.
    */
-  std::map<std::string, std::map<std::string, std::vector<Message>>> m_messages[2];
+  std::vector<Message> m_messages[2];
+  /// Contiguous storage of the message bodies of each list.
+  std::string m_bodies[2];
 
   /** Since we use two list for the current and last frame we have to switch of
    * current message list each frame. This value is only 0 or 1.
    */
   unsigned short m_currentList;
+  /// Number of frames ended, used to invalidate the views.
+  unsigned int m_frame;
+
+  /// Intern a name and add a user to it.
+  unsigned int RegisterName(const std::string &name);
+  /// Remove a user of a name, the name is released without users.
+  void ReleaseName(unsigned int id);
+  /// Return false if the name was never used by a message.
+  bool FindName(const std::string &name, unsigned int &id) const;
 
  public:
   KX_NetworkMessageManager();
   virtual ~KX_NetworkMessageManager();
 
   /** Add a message in the next message list.
-   * \param message The given message to add.
+   * \param to The receiver object(s) name, empty for all objects.
+   * \param from The sender game object.
+   * \param subject The message subject.
+   * \param body The message body.
    */
-  void AddMessage(Message message);
-  /** Get all messages for a given receiver object name and message subject.
+  void AddMessage(const std::string &to,
+                  SCA_IObject *from,
+                  const std::string &subject,
+                  const std::string &body);
+  /** Get all messages of the last frame for a given receiver object name and message subject.
    * \param to The object(s) name.
-   * \param subject The message subject/filter.
+   * \param subject The message subject/filter, empty for all subjects.
    */
-  const std::vector<Message> GetMessages(std::string to, std::string subject);
+  MessageView GetMessages(const std::string &to, const std::string &subject) const;
 
   /// Clear all messages
   void ClearMessages();
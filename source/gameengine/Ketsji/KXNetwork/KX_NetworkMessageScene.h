@@ -39,9 +39,7 @@ conflicts with KX_NetworkMessageScene::SendMessage */
 
 #include "KX_NetworkMessageManager.h"
 
-#include <map>
 #include <string>
-#include <vector>
 
 class SCA_IObject;
 
@@ -60,12 +58,16 @@ class KX_NetworkMessageScene {
    * \param subject The message subject, used as filter for receiver object(s).
    * \param message The body of the message.
    */
-  void SendMessage(std::string to, SCA_IObject *from, std::string subject, std::string body);
+  void SendMessage(const std::string &to,
+                   SCA_IObject *from,
+                   const std::string &subject,
+                   const std::string &body);
 
   /** Get all messages for a given receiver object name and message subject.
    * \param to The object(s) name.
    * \param subject The message subject/filter.
+   * \return A view on the messages valid until the end of the frame.
    */
-  const std::vector<KX_NetworkMessageManager::Message> FindMessages(std::string to,
-                                                                    std::string subject);
+  KX_NetworkMessageManager::MessageView FindMessages(const std::string &to,
+                                                     const std::string &subject) const;
 };
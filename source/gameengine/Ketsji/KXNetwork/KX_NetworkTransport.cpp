@@ -0,0 +1,303 @@
+/** \file gameengine/Ketsji/KXNetwork/KX_NetworkTransport.cpp
+ *  \ingroup ketsjinet
+ */
+
+#include "KX_NetworkTransport.h"
+
+#ifdef WIN32
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#else
+#  include <arpa/inet.h>
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <sys/select.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
+
+#include <cstring>
+#include <iterator>
+
+#ifdef WIN32
+typedef SOCKET socket_t;
+#  define SOCKET_INVALID ((intptr_t)INVALID_SOCKET)
+static bool socket_would_block()
+{
+  return (WSAGetLastError() == WSAEWOULDBLOCK);
+}
+static void socket_close(socket_t sock)
+{
+  closesocket(sock);
+}
+#else
+typedef int socket_t;
+#  define SOCKET_INVALID ((intptr_t)-1)
+static bool socket_would_block()
+{
+  return (errno == EWOULDBLOCK || errno == EAGAIN);
+}
+static void socket_close(socket_t sock)
+{
+  close(sock);
+}
+#endif
+
+/// Size of the socket send and receive buffers.
+static const int SOCKET_BUFFER_SIZE = 1 << 20;
+
+/// Maximum time the I/O thread waits for incoming datagrams, in microseconds.
+static const long IO_WAIT_TIME = 2000;
+
+/// Number of IO_WAIT_TIME waits for the socket buffer to send the datagrams queued before closing.
+static const int CLOSE_SEND_RETRIES = 50;
+
+bool KX_NetworkTransport::Address::operator==(const Address &other) const
+{
+  return (host == other.host && port == other.port);
+}
+
+std::string KX_NetworkTransport::Address::GetText() const
+{
+  const uint32_t h = ntohl(host);
+  return std::to_string((h >> 24) & 0xFF) + "." + std::to_string((h >> 16) & 0xFF) + "." +
+         std::to_string((h >> 8) & 0xFF) + "." + std::to_string(h & 0xFF) + ":" +
+         std::to_string(ntohs(port));
+}
+
+KX_NetworkTransport::KX_NetworkTransport()
+    : m_socket(SOCKET_INVALID), m_port(0), m_running(false)
+{
+}
+
+KX_NetworkTransport::~KX_NetworkTransport()
+{
+  Close();
+}
+
+bool KX_NetworkTransport::Open(const std::string &host, unsigned short port, std::string &error)
+{
+  Close();
+
+#ifdef WIN32
+  WSADATA wsaData;
+  if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+    error = "Failed to initialize Winsock";
+    return false;
+  }
+#endif
+
+  const socket_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if ((intptr_t)sock == SOCKET_INVALID) {
+    error = "Failed to create the socket";
+#ifdef WIN32
+    WSACleanup();
+#endif
+    return false;
+  }
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+
+  if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    error = "Invalid local IPv4 address " + host;
+    socket_close(sock);
+#ifdef WIN32
+    WSACleanup();
+#endif
+    return false;
+  }
+
+  socklen_t addrlen = sizeof(addr);
+  if (bind(sock, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(sock, (sockaddr *)&addr, &addrlen) != 0)
+  {
+    error = "Failed to bind the socket to " + host + ":" + std::to_string(port);
+    socket_close(sock);
+#ifdef WIN32
+    WSACleanup();
+#endif
+    return false;
+  }
+
+  // Larger buffers than the defaults to absorb the bursts of snapshots.
+  const int bufferSize = SOCKET_BUFFER_SIZE;
+  setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&bufferSize, sizeof(bufferSize));
+  setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char *)&bufferSize, sizeof(bufferSize));
+
+#ifdef WIN32
+  u_long nonBlocking = 1;
+  ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+  fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+  m_socket = (intptr_t)sock;
+  m_port = ntohs(addr.sin_port);
+  m_running = true;
+  m_thread = std::thread(&KX_NetworkTransport::Run, this);
+
+  return true;
+}
+
+void KX_NetworkTransport::Close()
+{
+  if (m_socket == SOCKET_INVALID) {
+    return;
+  }
+
+  m_running = false;
+  m_thread.join();
+
+  socket_close((socket_t)m_socket);
+#ifdef WIN32
+  WSACleanup();
+#endif
+
+  m_socket = SOCKET_INVALID;
+  m_port = 0;
+  m_incoming.clear();
+  m_outgoing.clear();
+}
+
+bool KX_NetworkTransport::IsOpen() const
+{
+  return (m_socket != SOCKET_INVALID);
+}
+
+unsigned short KX_NetworkTransport::GetPort() const
+{
+  return m_port;
+}
+
+bool KX_NetworkTransport::ResolveAddress(const std::string &host,
+                                         unsigned short port,
+                                         Address &address)
+{
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+
+  addrinfo *result;
+  if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0) {
+    return false;
+  }
+
+  address.host = ((sockaddr_in *)result->ai_addr)->sin_addr.s_addr;
+  address.port = htons(port);
+  freeaddrinfo(result);
+
+  return true;
+}
+
+void KX_NetworkTransport::Send(const Address &to, const std::vector<unsigned char> &data)
+{
+  m_mutex.Lock();
+  m_outgoing.push_back({to, data});
+  m_mutex.Unlock();
+}
+
+void KX_NetworkTransport::Receive(std::vector<Packet> &packets)
+{
+  m_mutex.Lock();
+  packets.swap(m_incoming);
+  m_incoming.clear();
+  m_mutex.Unlock();
+}
+
+void KX_NetworkTransport::Run()
+{
+  const socket_t sock = (socket_t)m_socket;
+  std::vector<Packet> outgoing;
+  std::vector<Packet> incoming;
+  std::vector<unsigned char> buffer(MAX_PACKET_SIZE);
+  int closeRetries = 0;
+
+  while (true) {
+    m_mutex.Lock();
+    outgoing.insert(outgoing.end(),
+                    std::make_move_iterator(m_outgoing.begin()),
+                    std::make_move_iterator(m_outgoing.end()));
+    m_outgoing.clear();
+    m_mutex.Unlock();
+
+    unsigned int sent = 0;
+    for (const Packet &packet : outgoing) {
+      sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = packet.address.host;
+      addr.sin_port = packet.address.port;
+
+      if (sendto(sock,
+                 (const char *)packet.data.data(),
+                 packet.data.size(),
+                 0,
+                 (sockaddr *)&addr,
+                 sizeof(addr)) < 0 &&
+          socket_would_block())
+      {
+        // The socket buffer is full, retry the remaining datagrams later.
+        break;
+      }
+      ++sent;
+    }
+    outgoing.erase(outgoing.begin(), outgoing.begin() + sent);
+
+    /* Closing, the datagrams queued before closing like the bye packets are sent when the
+     * socket buffer has room again, the remaining ones are dropped after a bounded wait. */
+    if (!m_running) {
+      if (outgoing.empty() || ++closeRetries > CLOSE_SEND_RETRIES) {
+        break;
+      }
+
+      fd_set writeSet;
+      FD_ZERO(&writeSet);
+      FD_SET(sock, &writeSet);
+      timeval timeout = {0, IO_WAIT_TIME};
+      select((int)sock + 1, nullptr, &writeSet, nullptr, &timeout);
+      continue;
+    }
+
+    // Wait for incoming datagrams, or for the next datagrams to send.
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(sock, &readSet);
+    timeval timeout = {0, IO_WAIT_TIME};
+    if (select((int)sock + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+      continue;
+    }
+
+    while (true) {
+      sockaddr_in addr;
+      socklen_t addrlen = sizeof(addr);
+      const int size = recvfrom(
+          sock, (char *)buffer.data(), buffer.size(), 0, (sockaddr *)&addr, &addrlen);
+      /* Stop on errors too, like the port unreachable notifications of a closed peer,
+       * the next datagrams are read at the next loop. */
+      if (size < 0) {
+        break;
+      }
+
+      Packet packet;
+      packet.address.host = addr.sin_addr.s_addr;
+      packet.address.port = addr.sin_port;
+      packet.data.assign(buffer.begin(), buffer.begin() + size);
+      incoming.push_back(std::move(packet));
+    }
+
+    if (!incoming.empty()) {
+      m_mutex.Lock();
+      m_incoming.insert(m_incoming.end(),
+                        std::make_move_iterator(incoming.begin()),
+                        std::make_move_iterator(incoming.end()));
+      m_mutex.Unlock();
+      incoming.clear();
+    }
+  }
+}
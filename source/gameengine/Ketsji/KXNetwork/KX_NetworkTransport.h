@@ -0,0 +1,78 @@
+/** \file KX_NetworkTransport.h
+ *  \ingroup ketsjinet
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CM_Thread.h"
+
+/** Non-blocking UDP socket serviced by its own thread.
+ * The datagrams to send are queued and the received ones are buffered until the game
+ * thread fetches them, the game thread never waits on the network.
+ */
+class KX_NetworkTransport {
+ public:
+  /// IPv4 address and port, in network byte order.
+  struct Address {
+    uint32_t host;
+    uint16_t port;
+
+    bool operator==(const Address &other) const;
+    std::string GetText() const;
+  };
+
+  struct Packet {
+    Address address;
+    std::vector<unsigned char> data;
+  };
+
+  /// Maximum size of an UDP datagram payload.
+  static const unsigned int MAX_PACKET_SIZE = 65507;
+
+ private:
+  /// Platform socket handle, invalid when not open.
+  intptr_t m_socket;
+  unsigned short m_port;
+
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+
+  /// Protect the incoming and outgoing queues.
+  CM_ThreadMutex m_mutex;
+  std::vector<Packet> m_incoming;
+  std::vector<Packet> m_outgoing;
+
+  /// I/O thread loop.
+  void Run();
+
+ public:
+  KX_NetworkTransport();
+  ~KX_NetworkTransport();
+
+  /** Bind the socket and start the I/O thread.
+   * \param host The local IPv4 address to bind, "0.0.0.0" for all the interfaces.
+   * \param port The local port, 0 for any available port.
+   * \param error The error description when failing.
+   */
+  bool Open(const std::string &host, unsigned short port, std::string &error);
+  /// Stop the I/O thread once the queued datagrams are sent, or after about 100 ms.
+  void Close();
+
+  bool IsOpen() const;
+  /// The bound local port.
+  unsigned short GetPort() const;
+
+  /// Resolve a host name or IPv4 address, return false on failure.
+  static bool ResolveAddress(const std::string &host, unsigned short port, Address &address);
+
+  /// Queue a datagram to send.
+  void Send(const Address &to, const std::vector<unsigned char> &data);
+  /// Fetch all the datagrams received since the last call.
+  void Receive(std::vector<Packet> &packets);
+};
@@ -0,0 +1,311 @@
+/** \file gameengine/Ketsji/KX_ActivityGrid.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityGrid.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <initializer_list>
+
+#include "CM_List.h"
+#include "KX_GameObject.h"
+
+/// Bits used per axis in the cell keys.
+static const int CELL_KEY_BITS = 21;
+static const int CELL_COORD_MAX = (1 << (CELL_KEY_BITS - 1)) - 1;
+
+/// Number of cells in the activity radius of the largest object, on each side of the camera.
+static const float CELLS_PER_RADIUS = 4.0f;
+
+/// Get the minimum and maximum squared radii of an object, false if it doesn't use culling.
+static bool get_object_radii(KX_GameObject *gameobj, float &minRadius, float &maxRadius)
+{
+  const KX_GameObject::ActivityCullingInfo &info = gameobj->GetActivityCullingInfo();
+  minRadius = FLT_MAX;
+  maxRadius = 0.0f;
+
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    minRadius = std::min(minRadius, info.m_physicsRadius);
+    maxRadius = std::max(maxRadius, info.m_physicsRadius);
+  }
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_LOGIC) {
+    minRadius = std::min(minRadius, info.m_logicRadius);
+    maxRadius = std::max(maxRadius, info.m_logicRadius);
+  }
+
+  return (info.m_flags != KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE);
+}
+
+bool KX_ActivityGrid::CellCoord::operator==(const CellCoord &other) const
+{
+  return (x == other.x && y == other.y && z == other.z);
+}
+
+KX_ActivityGrid::KX_ActivityGrid() : m_cellSize(1.0f), m_maxRadius(0.0f), m_invalid(true)
+{
+}
+
+KX_ActivityGrid::~KX_ActivityGrid()
+{
+}
+
+KX_ActivityGrid::CellCoord KX_ActivityGrid::GetCellCoord(const MT_Vector3 &position) const
+{
+  CellCoord coord;
+  int *coords[3] = {&coord.x, &coord.y, &coord.z};
+  for (unsigned short i = 0; i < 3; ++i) {
+    const float value = std::floor(position[i] / m_cellSize);
+    *coords[i] = (int)std::max(-float(CELL_COORD_MAX), std::min(float(CELL_COORD_MAX), value));
+  }
+  return coord;
+}
+
+uint64_t KX_ActivityGrid::GetCellKey(const CellCoord &coord)
+{
+  const uint64_t mask = (uint64_t(1) << CELL_KEY_BITS) - 1;
+  return ((uint64_t(coord.x) & mask) << (CELL_KEY_BITS * 2)) |
+         ((uint64_t(coord.y) & mask) << CELL_KEY_BITS) | (uint64_t(coord.z) & mask);
+}
+
+void KX_ActivityGrid::InsertObject(KX_GameObject *gameobj)
+{
+  float minRadius, maxRadius;
+  if (!get_object_radii(gameobj, minRadius, maxRadius)) {
+    RemoveObject(gameobj);
+    return;
+  }
+
+  const CellCoord coord = GetCellCoord(gameobj->NodeGetWorldPosition());
+  const uint64_t key = GetCellKey(coord);
+
+  const auto it = m_objectCells.find(gameobj);
+  if (it == m_objectCells.end()) {
+    m_objectCells.emplace(gameobj, key);
+  }
+  else if (it->second != key) {
+    RemoveObject(gameobj);
+    m_objectCells.emplace(gameobj, key);
+  }
+
+  auto cellit = m_cells.find(key);
+  if (cellit == m_cells.end()) {
+    Cell cell;
+    cell.m_coord = coord;
+    cell.m_minRadius = minRadius;
+    cell.m_maxRadius = maxRadius;
+    cell.m_boundary = false;
+    cell.m_inside = false;
+    cellit = m_cells.emplace(key, cell).first;
+  }
+
+  Cell &cell = cellit->second;
+  CM_ListAddIfNotFound(cell.m_objects, gameobj);
+
+  // Radii changes of an object already in the cell are also handled here.
+  cell.m_minRadius = std::min(cell.m_minRadius, minRadius);
+  cell.m_maxRadius = std::max(cell.m_maxRadius, maxRadius);
+  m_maxRadius = std::max(m_maxRadius, maxRadius);
+  ClassifyCell(key, cell);
+}
+
+void KX_ActivityGrid::RemoveObject(KX_GameObject *gameobj)
+{
+  const auto it = m_objectCells.find(gameobj);
+  if (it == m_objectCells.end()) {
+    return;
+  }
+
+  const uint64_t key = it->second;
+  m_objectCells.erase(it);
+
+  const auto cellit = m_cells.find(key);
+  Cell &cell = cellit->second;
+  CM_ListRemoveIfFound(cell.m_objects, gameobj);
+  if (cell.m_objects.empty()) {
+    if (cell.m_boundary) {
+      CM_ListRemoveIfFound(m_boundaryCells, key);
+    }
+    m_cells.erase(cellit);
+  }
+}
+
+bool KX_ActivityGrid::ClassifyCell(uint64_t key, Cell &cell)
+{
+  /* Minimum and maximum squared distance between any point of the cell and the nearest camera,
+   * the cameras being anywhere in their cells. */
+  float minDistance = FLT_MAX;
+  float maxDistance = FLT_MAX;
+  for (const CellCoord &camCoord : m_cameraCells) {
+    const int delta[3] = {std::abs(cell.m_coord.x - camCoord.x),
+                          std::abs(cell.m_coord.y - camCoord.y),
+                          std::abs(cell.m_coord.z - camCoord.z)};
+    float minCamDistance = 0.0f;
+    float maxCamDistance = 0.0f;
+    for (unsigned short i = 0; i < 3; ++i) {
+      const float gap = std::max(delta[i] - 1, 0) * m_cellSize;
+      const float extent = (delta[i] + 1) * m_cellSize;
+      minCamDistance += gap * gap;
+      maxCamDistance += extent * extent;
+    }
+    minDistance = std::min(minDistance, minCamDistance);
+    maxDistance = std::min(maxDistance, maxCamDistance);
+  }
+
+  // Same comparisons than KX_GameObject::UpdateActivity.
+  const bool outside = (minDistance > cell.m_maxRadius);
+  const bool inside = (maxDistance <= cell.m_minRadius);
+  const bool boundary = !outside && !inside;
+
+  if (boundary && !cell.m_boundary) {
+    m_boundaryCells.push_back(key);
+  }
+  else if (!boundary && cell.m_boundary) {
+    CM_ListRemoveIfFound(m_boundaryCells, key);
+  }
+
+  const bool changed = (boundary != cell.m_boundary || inside != cell.m_inside);
+  cell.m_boundary = boundary;
+  cell.m_inside = inside;
+
+  return changed;
+}
+
+void KX_ActivityGrid::MoveCameras(const std::vector<CellCoord> &cameraCells,
+                                  const std::vector<MT_Vector3> &camPositions)
+{
+  const std::vector<CellCoord> previousCells = m_cameraCells;
+  m_cameraCells = cameraCells;
+
+  /* The objects of a cell entering or leaving the radii are evaluated once, the boundary cells
+   * are evaluated by the update anyway. */
+  const auto reclassify = [this, &camPositions](uint64_t key, Cell &cell) {
+    if (ClassifyCell(key, cell) && !cell.m_boundary) {
+      for (KX_GameObject *gameobj : cell.m_objects) {
+        EvaluateObject(gameobj, camPositions);
+      }
+    }
+  };
+
+  /* A cell farther than the largest radius plus one cell from all the previous and new camera
+   * cells stays outside of the radii. */
+  const double range = std::ceil(std::sqrt(m_maxRadius) / m_cellSize) + 1.0;
+  const double side = 2.0 * range + 1.0;
+  const double numNearCells = side * side * side * (previousCells.size() + cameraCells.size());
+
+  // Classify all the cells when there are less cells than to look up near the cameras.
+  if (numNearCells >= m_cells.size()) {
+    for (auto &pair : m_cells) {
+      reclassify(pair.first, pair.second);
+    }
+    return;
+  }
+
+  const int cellRange = int(range);
+  for (const std::vector<CellCoord> *coords : {&previousCells, &cameraCells}) {
+    for (const CellCoord &camCoord : *coords) {
+      CellCoord coord;
+      for (coord.x = camCoord.x - cellRange; coord.x <= camCoord.x + cellRange; ++coord.x) {
+        for (coord.y = camCoord.y - cellRange; coord.y <= camCoord.y + cellRange; ++coord.y) {
+          for (coord.z = camCoord.z - cellRange; coord.z <= camCoord.z + cellRange; ++coord.z) {
+            const uint64_t key = GetCellKey(coord);
+            const auto it = m_cells.find(key);
+            // The cells near both cameras are visited twice, the second time is unchanged.
+            if (it != m_cells.end() && it->second.m_coord == coord) {
+              reclassify(key, it->second);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void KX_ActivityGrid::Rebuild(EXP_ListValue<KX_GameObject> *objects,
+                              const std::vector<MT_Vector3> &camPositions)
+{
+  m_cells.clear();
+  m_objectCells.clear();
+  m_boundaryCells.clear();
+
+  // Size the cells from the largest radius to keep the boundary cells close to the radii.
+  float maxRadius = 0.0f;
+  for (KX_GameObject *gameobj : objects) {
+    float minObjectRadius, maxObjectRadius;
+    if (get_object_radii(gameobj, minObjectRadius, maxObjectRadius)) {
+      maxRadius = std::max(maxRadius, maxObjectRadius);
+    }
+  }
+  m_cellSize = std::max(1.0f, std::sqrt(maxRadius) / CELLS_PER_RADIUS);
+  m_maxRadius = maxRadius;
+
+  m_cameraCells.clear();
+  for (const MT_Vector3 &campos : camPositions) {
+    m_cameraCells.push_back(GetCellCoord(campos));
+  }
+
+  for (KX_GameObject *gameobj : objects) {
+    InsertObject(gameobj);
+    EvaluateObject(gameobj, camPositions);
+  }
+
+  m_invalid = false;
+}
+
+void KX_ActivityGrid::EvaluateObject(KX_GameObject *gameobj,
+                                     const std::vector<MT_Vector3> &camPositions)
+{
+  // If the object doesn't manage activity culling we don't compute distance.
+  if (gameobj->GetActivityCullingInfo().m_flags ==
+      KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
+    return;
+  }
+
+  // For each camera compute the distance to objects and keep the minimum distance.
+  const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
+  float dist = FLT_MAX;
+  for (const MT_Vector3 &campos : camPositions) {
+    dist = std::min((obpos - campos).length2(), dist);
+  }
+  gameobj->UpdateActivity(dist);
+}
+
+void KX_ActivityGrid::Invalidate()
+{
+  m_invalid = true;
+}
+
+void KX_ActivityGrid::Update(const std::vector<MT_Vector3> &camPositions,
+                             EXP_ListValue<KX_GameObject> *objects,
+                             const std::vector<KX_GameObject *> &movedObjects)
+{
+  // The number of cameras changed, rebuild all.
+  if (m_invalid || camPositions.size() != m_cameraCells.size()) {
+    Rebuild(objects, camPositions);
+    return;
+  }
+
+  std::vector<CellCoord> cameraCells;
+  bool camerasMoved = false;
+  for (unsigned int i = 0, size = camPositions.size(); i < size; ++i) {
+    cameraCells.push_back(GetCellCoord(camPositions[i]));
+    camerasMoved |= !(cameraCells[i] == m_cameraCells[i]);
+  }
+
+  // The cells classification depends on the camera cells.
+  if (camerasMoved) {
+    MoveCameras(cameraCells, camPositions);
+  }
+
+  for (KX_GameObject *gameobj : movedObjects) {
+    InsertObject(gameobj);
+    EvaluateObject(gameobj, camPositions);
+  }
+
+  for (const uint64_t key : m_boundaryCells) {
+    for (KX_GameObject *gameobj : m_cells[key].m_objects) {
+      EvaluateObject(gameobj, camPositions);
+    }
+  }
+}
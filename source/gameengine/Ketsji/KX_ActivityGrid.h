@@ -0,0 +1,88 @@
+/** \file KX_ActivityGrid.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "EXP_ListValue.h"
+#include "MT_Vector3.h"
+
+class KX_GameObject;
+
+/** Uniform grid of the objects using activity culling, to avoid computing each frame the
+ * distance between every object and the activity culling cameras.
+ * While the cameras stay in the same cells, an object state can change only if its cell crosses
+ * the activity radius of one of its objects (boundary cell) or if it moved. The other cells are
+ * entirely in or out of the radii and their objects are not visited. When a camera changes of
+ * cell only the cells near the previous and new camera cells are classified again, the objects
+ * of a cell are evaluated if it entered or left the radii.
+ */
+class KX_ActivityGrid {
+ private:
+  struct CellCoord {
+    int x;
+    int y;
+    int z;
+
+    bool operator==(const CellCoord &other) const;
+  };
+
+  struct Cell {
+    CellCoord m_coord;
+    std::vector<KX_GameObject *> m_objects;
+    /// Minimum and maximum squared radii of the objects, only grown until the next rebuild.
+    float m_minRadius;
+    float m_maxRadius;
+    /// True when the cell can cross the radius of one of its objects.
+    bool m_boundary;
+    /// True when the cell is entirely in the radii of its objects.
+    bool m_inside;
+  };
+
+  float m_cellSize;
+  /// Largest squared radius of the objects in the grid, bounding the cells near the cameras.
+  float m_maxRadius;
+  std::unordered_map<uint64_t, Cell> m_cells;
+  /// Cell key of each object in the grid.
+  std::unordered_map<KX_GameObject *, uint64_t> m_objectCells;
+  std::vector<uint64_t> m_boundaryCells;
+  std::vector<CellCoord> m_cameraCells;
+  /// True when the grid must be rebuilt at the next update.
+  bool m_invalid;
+
+  CellCoord GetCellCoord(const MT_Vector3 &position) const;
+  static uint64_t GetCellKey(const CellCoord &coord);
+
+  void InsertObject(KX_GameObject *gameobj);
+  /// Classify a cell from the camera cells, return true if its classification changed.
+  bool ClassifyCell(uint64_t key, Cell &cell);
+  /// Classify again the cells near the previous and new camera cells.
+  void MoveCameras(const std::vector<CellCoord> &cameraCells,
+                   const std::vector<MT_Vector3> &camPositions);
+  void Rebuild(EXP_ListValue<KX_GameObject> *objects, const std::vector<MT_Vector3> &camPositions);
+
+  static void EvaluateObject(KX_GameObject *gameobj, const std::vector<MT_Vector3> &camPositions);
+
+ public:
+  KX_ActivityGrid();
+  ~KX_ActivityGrid();
+
+  /// Rebuild the grid and evaluate all the objects at the next update.
+  void Invalidate();
+
+  void RemoveObject(KX_GameObject *gameobj);
+
+  /** Update the activity of the objects.
+   * \param camPositions The positions of the activity culling cameras.
+   * \param objects All the objects of the scene, used when the grid is rebuilt.
+   * \param movedObjects The objects moved or with activity settings changed since the last
+   * update.
+   */
+  void Update(const std::vector<MT_Vector3> &camPositions,
+              EXP_ListValue<KX_GameObject> *objects,
+              const std::vector<KX_GameObject *> &movedObjects);
+};
@@ -32,7 +32,10 @@
 KX_CollisionContactPoint::KX_CollisionContactPoint(const PHY_ICollData *collData,
                                                    unsigned int index,
                                                    bool firstObject)
-    : m_collData(collData), m_index(index), m_firstObject(firstObject)
+    : m_collData(collData),
+      m_index(index),
+      m_firstObject(firstObject),
+      m_frame(collData->GetFrame())
 {
 }
 
@@ -40,6 +43,11 @@ KX_CollisionContactPoint::~KX_CollisionContactPoint()
 {
 }
 
+bool KX_CollisionContactPoint::IsValid() const
+{
+  return m_collData->GetFrame() == m_frame;
+}
+
 std::string KX_CollisionContactPoint::GetName()
 {
   return "CollisionContactPoint";
@@ -106,10 +114,27 @@ PyAttributeDef KX_CollisionContactPoint::Attributes[] = {
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
+/// Raise an error when the contact point is used after its collision callback.
+static bool kx_collision_contact_point_check_valid(const KX_CollisionContactPoint *self,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  if (!self->IsValid()) {
+    PyErr_Format(PyExc_SystemError,
+                 "KX_CollisionContactPoint.%s, the contact point is only valid during the "
+                 "collision callback",
+                 attrdef->m_name.c_str());
+    return false;
+  }
+  return true;
+}
+
 PyObject *KX_CollisionContactPoint::pyattr_get_local_point_a(EXP_PyObjectPlus *self_v,
                                                              const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyObjectFrom(self->m_collData->GetLocalPointA(self->m_index, self->m_firstObject));
 }
 
@@ -117,6 +142,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_local_point_b(EXP_PyObjectPlus *s
                                                              const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyObjectFrom(self->m_collData->GetLocalPointB(self->m_index, self->m_firstObject));
 }
 
@@ -124,6 +152,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_world_point(EXP_PyObjectPlus *sel
                                                            const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyObjectFrom(self->m_collData->GetWorldPoint(self->m_index, self->m_firstObject));
 }
 
@@ -131,6 +162,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_normal(EXP_PyObjectPlus *self_v,
                                                       const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyObjectFrom(self->m_collData->GetNormal(self->m_index, self->m_firstObject));
 }
 
@@ -138,6 +172,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_combined_friction(
     EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyFloat_FromDouble(
       self->m_collData->GetCombinedFriction(self->m_index, self->m_firstObject));
 }
@@ -146,6 +183,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_combined_rolling_friction(
     EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyFloat_FromDouble(
       self->m_collData->GetCombinedRollingFriction(self->m_index, self->m_firstObject));
 }
@@ -154,6 +194,9 @@ PyObject *KX_CollisionContactPoint::pyattr_get_combined_restitution(
     EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyFloat_FromDouble(
       self->m_collData->GetCombinedRestitution(self->m_index, self->m_firstObject));
 }
@@ -162,10 +205,18 @@ PyObject *KX_CollisionContactPoint::pyattr_get_applied_impulse(EXP_PyObjectPlus
                                                                const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_CollisionContactPoint *self = static_cast<KX_CollisionContactPoint *>(self_v);
+  if (!kx_collision_contact_point_check_valid(self, attrdef)) {
+    return nullptr;
+  }
   return PyFloat_FromDouble(
       self->m_collData->GetAppliedImpulse(self->m_index, self->m_firstObject));
 }
 
+static bool kx_collision_contact_point_list_check_valid_cb(void *self_v)
+{
+  return ((KX_CollisionContactPointList *)self_v)->IsValid();
+}
+
 static int kx_collision_contact_point_list_get_sensors_size_cb(void *self_v)
 {
   return ((KX_CollisionContactPointList *)self_v)->GetNumCollisionContactPoint();
@@ -184,14 +235,15 @@ KX_CollisionContactPointList::KX_CollisionContactPointList(const PHY_ICollData *
 #ifdef WITH_PYTHON
       EXP_ListWrapper(this,
                       nullptr,
-                      nullptr,
+                      kx_collision_contact_point_list_check_valid_cb,
                       kx_collision_contact_point_list_get_sensors_size_cb,
                       kx_collision_contact_point_list_get_sensors_item_cb,
                       nullptr,
                       nullptr),
 #endif  // WITH_PYTHON
       m_collData(collData),
-      m_firstObject(firstObject)
+      m_firstObject(firstObject),
+      m_frame(collData->GetFrame())
 {
 }
 
@@ -199,6 +251,11 @@ KX_CollisionContactPointList::~KX_CollisionContactPointList()
 {
 }
 
+bool KX_CollisionContactPointList::IsValid() const
+{
+  return m_collData->GetFrame() == m_frame;
+}
+
 std::string KX_CollisionContactPointList::GetName()
 {
   return "KX_CollisionContactPointList";
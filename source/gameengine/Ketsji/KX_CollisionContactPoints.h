@@ -37,11 +37,16 @@ class KX_CollisionContactPoint : public EXP_Value {
       const PHY_ICollData *m_collData;
   const unsigned int m_index;
   const bool m_firstObject;
+  /// Frame of the collision data at the creation, the contact point is invalid once it changed.
+  const unsigned int m_frame;
 
  public:
   KX_CollisionContactPoint(const PHY_ICollData *collData, unsigned int index, bool firstObject);
   virtual ~KX_CollisionContactPoint();
 
+  /// Return false once the contact points of the collision data were released.
+  bool IsValid() const;
+
   // stuff for cvalue related things
   std::string GetName();
 
@@ -76,11 +81,15 @@ class KX_CollisionContactPointList
   const PHY_ICollData *m_collData;
   /// The object is the first in the pair or the second ?
   bool m_firstObject;
+  /// Frame of the collision data at the creation, the list is invalid once it changed.
+  const unsigned int m_frame;
 
  public:
   KX_CollisionContactPointList(const PHY_ICollData *collData, bool firstObject);
   virtual ~KX_CollisionContactPointList();
 
+  bool IsValid() const;
+
   virtual std::string GetName();
 
   KX_CollisionContactPoint *GetCollisionContactPoint(unsigned int index);
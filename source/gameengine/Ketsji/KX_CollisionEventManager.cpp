@@ -220,6 +220,8 @@ void KX_CollisionEventManager::NextFrame()
   }
 
   RemoveNewCollisions();
+  // The collision data and its contact points are reused for the next physics steps.
+  m_physEnv->ClearCollisionData();
 }
 
 SCA_LogicManager *KX_CollisionEventManager::GetLogicManager()
@@ -53,12 +53,11 @@ class KX_CollisionEventManager : public SCA_EventManager {
     bool isFirst;
 
     /**
-     * Creates a copy of the given PHY_ICollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
+     * The PHY_ICollData is owned by the physics environment and stays valid until
+     * PHY_IPhysicsEnvironment::ClearCollisionData is called at the end of NextFrame.
      *
-     * This allows us to efficiently store NewCollision objects in a std::set without creating more
-     * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
-     * clone it again. */
+     * This allows us to efficiently store NewCollision objects in a std::set without creating
+     * copies of colldata, as the NewCollision copy constructor reuses the pointer. */
     NewCollision(PHY_IPhysicsController *first,
                  PHY_IPhysicsController *second,
                  const PHY_ICollData *colldata,
@@ -57,6 +57,7 @@
 #include "KX_ClientObjectInfo.h"
 #include "KX_CollisionContactPoints.h"
 #include "KX_Globals.h"
+#include "KX_InstanceBuffer.h"
 #include "KX_LodLevel.h"
 #include "KX_LodManager.h"
 #include "KX_MeshProxy.h"
@@ -85,12 +86,19 @@ KX_GameObject::ActivityCullingInfo::ActivityCullingInfo()
 {
 }
 
+KX_GameObject::ReplicationInfo::ReplicationInfo() : m_enabled(false), m_networkId(0)
+{
+}
+
 KX_GameObject::KX_GameObject()
     : SCA_IObject(),
-      m_isReplica(false),            // eevee
-      m_visibleAtGameStart(false),   // eevee
-      m_forceIgnoreParentTx(false),  // eevee
-      m_previousLodLevel(-1),        // eevee
+      m_isReplica(false),               // eevee
+      m_pBlenderPoolTemplate(nullptr),  // eevee
+      m_instanceBuffer(nullptr),        // eevee
+      m_instanceIndex(0),               // eevee
+      m_visibleAtGameStart(false),      // eevee
+      m_forceIgnoreParentTx(false),     // eevee
+      m_previousLodLevel(-1),           // eevee
       m_layer(0),
       m_lodManager(nullptr),
       m_currentLodLevel(0),
@@ -258,7 +266,7 @@ void KX_GameObject::ForceIgnoreParentTx()
 void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_render_pass)
 {
   float object_to_world[4][4];
-  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
+  NodeGetWorldMatrix(object_to_world);
   bool staticObject = true;
   if (GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER)) {
     staticObject = false;
@@ -272,6 +280,14 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
     }
   }
 
+  // Instanced replicas only write their matrix in the instance buffer, no ID is tagged.
+  if (m_instanceBuffer) {
+    if (!staticObject) {
+      m_instanceBuffer->SetTransform(m_instanceIndex, object_to_world);
+    }
+    return;
+  }
+
   bContext *C = KX_GetActiveEngine()->GetContext();
   Main *bmain = CTX_data_main(C);
   Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
@@ -336,7 +352,11 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
 void KX_GameObject::TagForTransformUpdateEvaluated()
 {
   float object_to_world[4][4];
-  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
+  NodeGetWorldMatrix(object_to_world);
+
+  if (m_instanceBuffer) {
+    return;
+  }
 
   bContext *C = KX_GetActiveEngine()->GetContext();
   Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
@@ -361,6 +381,29 @@ void KX_GameObject::ReplicateBlenderObject()
   Object *ob = GetBlenderObject();
 
   if (ob) {
+    /* Instanced replication keeps the template blender object and draws the replica
+     * through the instance buffer of the template, see KX_InstanceBuffer. */
+    if ((ob->gameflag & OB_GAME_INSTANCING) && ob->type == OB_MESH) {
+      m_pBlenderPoolTemplate = nullptr;
+      // The template can be a replica when converted during the game, it must not be freed.
+      m_isReplica = false;
+      GetScene()->GetInstanceBuffer(ob)->AddObject(this);
+      return;
+    }
+
+    /* Pooled replication reuses a hidden copy left by a previous replica when available,
+     * without any ID copy, collection change or depsgraph relations update. */
+    const bool pooled = GetScene()->IsReplicatingPooled() && !ob->instance_collection;
+    m_pBlenderPoolTemplate = pooled ? ob : nullptr;
+    if (pooled) {
+      Object *pooledob = GetScene()->AcquirePooledObject(ob);
+      if (pooledob) {
+        m_pBlenderObject = pooledob;
+        m_isReplica = true;
+        return;
+      }
+    }
+
     bContext *C = KX_GetActiveEngine()->GetContext();
     Main *bmain = CTX_data_main(C);
     Object *newob;
@@ -409,6 +452,15 @@ void KX_GameObject::RemoveReplicaObject()
 {
   Object *ob = GetBlenderObject();
   if (ob && m_isReplica) {
+    KX_Scene *scene = GetScene();
+    // Keep the blender object hidden in its pool instead of deleting it during the game.
+    if (m_pBlenderPoolTemplate && scene->m_isRuntime &&
+        scene->ReleasePooledObject(m_pBlenderPoolTemplate, ob))
+    {
+      SetBlenderObject(nullptr);
+      return;
+    }
+
     bContext *C = KX_GetActiveEngine()->GetContext();
     Main *bmain = CTX_data_main(C);
     BKE_id_delete(bmain, ob);
@@ -595,6 +647,13 @@ void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enab
       RestoreLogicAndActions(false);
     }
   }
+
+  GetScene()->AddActivityObject(this);
+}
+
+KX_GameObject::ReplicationInfo &KX_GameObject::GetReplicationInfo()
+{
+  return m_replicationInfo;
 }
 
 void KX_GameObject::AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob)
@@ -609,6 +668,22 @@ bool KX_GameObject::IsReplica()
   return m_isReplica;
 }
 
+void KX_GameObject::SetInstanceBuffer(KX_InstanceBuffer *buffer, unsigned int index)
+{
+  m_instanceBuffer = buffer;
+  m_instanceIndex = index;
+}
+
+KX_InstanceBuffer *KX_GameObject::GetInstanceBuffer() const
+{
+  return m_instanceBuffer;
+}
+
+unsigned int KX_GameObject::GetInstanceIndex() const
+{
+  return m_instanceIndex;
+}
+
 void KX_GameObject::SetIsReplicaObject()
 {
   m_isReplica = true;
@@ -757,6 +832,8 @@ void KX_GameObject::SetParent(KX_GameObject *obj, bool addToCompound, bool ghost
     NodeSetLocalPosition(MT_Vector3(newpos[0], newpos[1], newpos[2]));
     NodeSetLocalOrientation(invori * NodeGetWorldOrientation());
     NodeUpdateGS(0.f);
+    // Parented again in game, RemoveParent could have visited it at every render pass.
+    scene->UpdateDepsgraphResetObject(this);
     // object will now be a child, it must be removed from the parent list
     EXP_ListValue<KX_GameObject> *rootlist = scene->GetRootParentList();
     if (rootlist->RemoveValue(this))
@@ -793,6 +870,8 @@ void KX_GameObject::RemoveParent()
     NodeUpdateGS(0.f);
 
     KX_Scene *scene = GetScene();
+    // The depsgraph still evaluates the object with its blender parent.
+    scene->UpdateDepsgraphResetObject(this);
     // the object is now a root object, add it to the parentlist
     EXP_ListValue<KX_GameObject> *rootlist = scene->GetRootParentList();
     if (!rootlist->SearchValue(this))
@@ -886,6 +965,16 @@ void KX_GameObject::UpdateActionManager(float curtime, bool applyToObject)
   GetActionManager()->Update(curtime, applyToObject);
 }
 
+void KX_GameObject::UpdateActions(float curtime, bool applyToObject)
+{
+  GetActionManager()->UpdateActions(curtime, applyToObject);
+}
+
+void KX_GameObject::UpdateActionIPOs()
+{
+  GetActionManager()->UpdateIPOs();
+}
+
 float KX_GameObject::GetActionFrame(short layer)
 {
   return GetActionManager()->GetActionFrame(layer);
@@ -916,7 +1005,10 @@ void KX_GameObject::ProcessReplica()
   KX_PythonProxy::ProcessReplica();
 
   ReplicateBlenderObject();
-  GetScene()->GetBlenderSceneConverter()->RegisterGameObject(this, m_pBlenderObject);
+  // Instanced replicas share the template blender object which stays registered to the template.
+  if (!m_instanceBuffer) {
+    GetScene()->GetBlenderSceneConverter()->RegisterGameObject(this, m_pBlenderObject);
+  }
 
   if (m_lodManager) {
     m_lodManager->AddRef();
@@ -925,6 +1017,8 @@ void KX_GameObject::ProcessReplica()
 
   m_pPhysicsController = nullptr;
   m_pSGNode = nullptr;
+  // A replica is a distinct object for the network peers.
+  m_replicationInfo.m_networkId = 0;
 
   /* Dupli group and instance list are set later in replication.
    * See KX_Scene::DupliGroupRecurse. */
@@ -1273,7 +1367,10 @@ static void setVisible_recursive(SG_Node *node, bool v)
 void KX_GameObject::SetVisible(bool v, bool recursive)
 {
   Object *ob = GetBlenderObject();
-  if (ob) {
+  if (m_instanceBuffer) {
+    m_instanceBuffer->SetVisible(m_instanceIndex, v);
+  }
+  else if (ob) {
     Scene *scene = GetScene()->GetBlenderScene();
     ViewLayer *view_layer = BKE_view_layer_default_view(scene);
     BKE_view_layer_synced_ensure(scene, view_layer);
@@ -1394,6 +1491,11 @@ void KX_GameObject::setAngularVelocity(const MT_Vector3 &ang_vel, bool local)
 void KX_GameObject::SetObjectColor(const MT_Vector4 &rgbavec)
 {
   m_objectColor = rgbavec;
+  if (m_instanceBuffer) {
+    m_instanceBuffer->SetColor(m_instanceIndex, m_objectColor);
+    return;
+  }
+
   Object *ob_orig = GetBlenderObject();
   if (ob_orig && GetScene()->OrigObCanBeTransformedInRealtime(ob_orig) &&
       ELEM(ob_orig->type, OB_MESH, OB_CURVES_LEGACY, OB_SURF, OB_FONT, OB_MBALL)) {
@@ -1724,6 +1826,11 @@ MT_Transform KX_GameObject::NodeGetWorldTransform() const
   return m_pSGNode->GetWorldTransform();
 }
 
+void KX_GameObject::NodeGetWorldMatrix(float mat[4][4]) const
+{
+  m_pSGNode->GetWorldMatrix(&mat[0][0]);
+}
+
 MT_Transform KX_GameObject::NodeGetLocalTransform() const
 {
   return m_pSGNode->GetLocalTransform();
@@ -2276,6 +2383,12 @@ PyAttributeDef KX_GameObject::Attributes[] = {
         "physicsCulling", KX_GameObject, pyattr_get_physicsCulling, pyattr_set_physicsCulling),
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "logicCulling", KX_GameObject, pyattr_get_logicCulling, pyattr_set_logicCulling),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "replicate", KX_GameObject, pyattr_get_replicate, pyattr_set_replicate),
+    EXP_PYATTRIBUTE_RW_FUNCTION("replicateProperties",
+                                KX_GameObject,
+                                pyattr_get_replicateProperties,
+                                pyattr_set_replicateProperties),
 
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "position", KX_GameObject, pyattr_get_worldPosition, pyattr_set_localPosition),
@@ -3224,6 +3337,73 @@ int KX_GameObject::pyattr_set_logicCulling(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_GameObject::pyattr_get_replicate(EXP_PyObjectPlus *self_v,
+                                              const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return PyBool_FromLong(self->GetReplicationInfo().m_enabled);
+}
+
+int KX_GameObject::pyattr_set_replicate(EXP_PyObjectPlus *self_v,
+                                        const EXP_PYATTRIBUTE_DEF *attrdef,
+                                        PyObject *value)
+{
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  int param = PyObject_IsTrue(value);
+  if (param == -1) {
+    PyErr_SetString(PyExc_AttributeError,
+                    "gameOb.replicate = bool: KX_GameObject, expected True or False");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->GetReplicationInfo().m_enabled = param;
+  return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *KX_GameObject::pyattr_get_replicateProperties(EXP_PyObjectPlus *self_v,
+                                                        const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  const std::vector<std::string> &properties = self->GetReplicationInfo().m_properties;
+
+  PyObject *list = PyList_New(properties.size());
+  for (unsigned int i = 0, size = properties.size(); i < size; ++i) {
+    PyList_SET_ITEM(list, i, PyUnicode_FromStdString(properties[i]));
+  }
+  return list;
+}
+
+int KX_GameObject::pyattr_set_replicateProperties(EXP_PyObjectPlus *self_v,
+                                                  const EXP_PYATTRIBUTE_DEF *attrdef,
+                                                  PyObject *value)
+{
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  PyObject *seq = PySequence_Fast(value, "");
+  if (!seq) {
+    PyErr_SetString(PyExc_AttributeError,
+                    "gameOb.replicateProperties = [str, ...]: KX_GameObject, expected a "
+                    "sequence of strings");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  std::vector<std::string> properties;
+  for (Py_ssize_t i = 0, size = PySequence_Fast_GET_SIZE(seq); i < size; ++i) {
+    PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+    if (!PyUnicode_Check(item)) {
+      Py_DECREF(seq);
+      PyErr_SetString(PyExc_AttributeError,
+                      "gameOb.replicateProperties = [str, ...]: KX_GameObject, expected a "
+                      "sequence of strings");
+      return PY_SET_ATTR_FAIL;
+    }
+    properties.push_back(_PyUnicode_AsString(item));
+  }
+  Py_DECREF(seq);
+
+  self->GetReplicationInfo().m_properties = properties;
+  return PY_SET_ATTR_SUCCESS;
+}
+
 PyObject *KX_GameObject::pyattr_get_physicsCullingRadius(EXP_PyObjectPlus *self_v,
                                                          const EXP_PYATTRIBUTE_DEF *attrdef)
 {
@@ -3245,6 +3425,7 @@ int KX_GameObject::pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_physicsRadius = val * val;
+  self->GetScene()->AddActivityObject(self);
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3270,6 +3451,7 @@ int KX_GameObject::pyattr_set_logicCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_logicRadius = val * val;
+  self->GetScene()->AddActivityObject(self);
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -55,6 +55,7 @@
 struct KX_ClientObjectInfo;
 class KX_RayCast;
 class KX_LodManager;
+class KX_InstanceBuffer;
 class KX_PythonComponent;
 class RAS_MeshObject;
 class PHY_IPhysicsController;
@@ -102,10 +103,28 @@ class KX_GameObject : public SCA_IObject {
     float m_logicRadius;
   };
 
+  /// Network replication settings, see KX_NetworkReplication.
+  struct ReplicationInfo {
+
+    ReplicationInfo();
+
+    /// True when the object state is sent to the peers.
+    bool m_enabled;
+    /// Names of the game properties sent with the transform.
+    std::vector<std::string> m_properties;
+    /// Identifier of the object in the snapshots, 0 until the object is first sent.
+    uint32_t m_networkId;
+  };
+
  protected:
   /* EEVEE INTEGRATION */
   float m_prevobject_to_world[4][4];
   bool m_isReplica;
+  /// Template of the scene object pool the replica blender object returns to, nullptr if unpooled.
+  struct Object *m_pBlenderPoolTemplate;
+  /// Instance buffer drawing this replica instead of a blender object, nullptr if not instanced.
+  KX_InstanceBuffer *m_instanceBuffer;
+  unsigned int m_instanceIndex;
   bool m_visibleAtGameStart;
   bool m_forceIgnoreParentTx;
   short m_previousLodLevel;
@@ -131,6 +150,8 @@ class KX_GameObject : public SCA_IObject {
   // Object activity culling settings converted from blender objects.
   ActivityCullingInfo m_activityCullingInfo;
 
+  ReplicationInfo m_replicationInfo;
+
   PHY_IPhysicsController *m_pPhysicsController;
   SG_Node *m_pSGNode;
 
@@ -162,6 +183,9 @@ class KX_GameObject : public SCA_IObject {
   void RestoreLogicAndActions(bool childrenRecursive);
   void AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob);
   bool IsReplica();
+  void SetInstanceBuffer(KX_InstanceBuffer *buffer, unsigned int index);
+  KX_InstanceBuffer *GetInstanceBuffer() const;
+  unsigned int GetInstanceIndex() const;
   void ForceIgnoreParentTx();
   void SyncTransformWithDepsgraph();
   void SetIsReplicaObject();
@@ -335,6 +359,17 @@ class KX_GameObject : public SCA_IObject {
    */
   void UpdateActionManager(float curtime, bool applyObject);
 
+  /**
+   * Kick the object's action manager without syncing the scene graph, this function
+   * can be called from a worker thread, UpdateActionIPOs must be called after from the main thread.
+   * \param curtime The current time used to compute the actions frame.
+   * \param applyObject Set to true if the actions must transform this object, else it only manages
+   * actions' frames.
+   */
+  void UpdateActions(float curtime, bool applyObject);
+  /// Sync the object in the scene graph after UpdateActions.
+  void UpdateActionIPOs();
+
   /*********************************
    * End Animation API
    *********************************/
@@ -478,6 +513,8 @@ class KX_GameObject : public SCA_IObject {
   const MT_Vector3 &NodeGetWorldScaling() const;
   const MT_Vector3 &NodeGetWorldPosition() const;
   MT_Transform NodeGetWorldTransform() const;
+  /// Get the world matrix, read from the scene transform store when the node is stored.
+  void NodeGetWorldMatrix(float mat[4][4]) const;
 
   const MT_Matrix3x3 &NodeGetLocalOrientation() const;
   const MT_Vector3 &NodeGetLocalScaling() const;
@@ -509,6 +546,16 @@ class KX_GameObject : public SCA_IObject {
 
   virtual void SetBlenderObject(struct Object *obj);
 
+  struct Object *GetBlenderPoolTemplate()
+  {
+    return m_pBlenderPoolTemplate;
+  }
+
+  void SetBlenderPoolTemplate(struct Object *obj)
+  {
+    m_pBlenderPoolTemplate = obj;
+  }
+
   struct Object *GetBlenderGroupObject()
   {
     return m_pBlenderGroupObject;
@@ -730,6 +777,8 @@ class KX_GameObject : public SCA_IObject {
   /// Enable or disable a category of object activity culling.
   void SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable);
 
+  ReplicationInfo &GetReplicationInfo();
+
   /**
    * \section Logic bubbling methods.
    */
@@ -910,6 +959,16 @@ class KX_GameObject : public SCA_IObject {
   static int pyattr_set_logicCulling(EXP_PyObjectPlus *self_v,
                                      const EXP_PYATTRIBUTE_DEF *attrdef,
                                      PyObject *value);
+  static PyObject *pyattr_get_replicate(EXP_PyObjectPlus *self_v,
+                                        const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_replicate(EXP_PyObjectPlus *self_v,
+                                  const EXP_PYATTRIBUTE_DEF *attrdef,
+                                  PyObject *value);
+  static PyObject *pyattr_get_replicateProperties(EXP_PyObjectPlus *self_v,
+                                                  const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_replicateProperties(EXP_PyObjectPlus *self_v,
+                                            const EXP_PYATTRIBUTE_DEF *attrdef,
+                                            PyObject *value);
   static PyObject *pyattr_get_physicsCullingRadius(EXP_PyObjectPlus *self_v,
                                                    const EXP_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
@@ -0,0 +1,246 @@
+/** \file gameengine/Ketsji/KX_InstanceBuffer.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_InstanceBuffer.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_collection.hh"
+#include "BKE_context.hh"
+#include "BKE_layer.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main_invariants.hh"
+#include "BKE_node.hh"
+#include "BKE_node_legacy_types.hh"
+#include "BKE_object.hh"
+#include "BKE_pointcloud.hh"
+#include "BLI_string.h"
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DNA_layer_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_scene_types.h"
+#include "ED_object.hh"
+#include "NOD_socket.hh"
+
+#include "KX_GameObject.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_Scene.h"
+
+using namespace blender;
+
+KX_InstanceBuffer::KX_InstanceBuffer(KX_Scene *scene, Object *ob)
+    : m_scene(scene), m_modified(true)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+  Scene *blenderScene = scene->GetBlenderScene();
+  ViewLayer *view_layer = BKE_view_layer_default_view(blenderScene);
+  Object *camera = BKE_view_layer_camera_find(blenderScene, view_layer);
+
+  /* The prototype is hidden from the viewport with BASE_HIDDEN and not OB_HIDE_VIEWPORT
+   * as the latter removes the object from the depsgraph and the instances need its
+   * evaluated data. */
+  BKE_id_copy_ex(bmain, &ob->id, (ID **)&m_prototype, 0);
+  id_us_min(&m_prototype->id);
+  m_prototype->visibility_flag &= ~OB_HIDE_VIEWPORT;
+  BKE_collection_object_add_from(bmain, blenderScene, camera, m_prototype);
+
+  // The instances are placed in world space, keep the instancer at the origin.
+  m_instancer = BKE_object_add_only_object(bmain, OB_POINTCLOUD, "BGE_instancer");
+  m_pointCloud = (PointCloud *)BKE_object_obdata_add_from_type(
+      bmain, OB_POINTCLOUD, "BGE_instances");
+  m_instancer->data = m_pointCloud;
+  BKE_collection_object_add_from(bmain, blenderScene, camera, m_instancer);
+  AddInstancesModifier();
+
+  BKE_view_layer_synced_ensure(blenderScene, view_layer);
+  Base *base = BKE_view_layer_base_find(view_layer, m_prototype);
+  if (base) {
+    base->flag |= BASE_HIDDEN;
+    BKE_layer_collection_sync(blenderScene, view_layer);
+  }
+
+  scene->TagForCollectionRemap();
+  DEG_relations_tag_update(bmain);
+}
+
+void KX_InstanceBuffer::AddInstancesModifier()
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+
+  Scene *blenderScene = m_scene->GetBlenderScene();
+  NodesModifierData *nmd = (NodesModifierData *)ed::object::modifier_add(
+      nullptr, bmain, blenderScene, m_instancer, "BGE_instances", eModifierType_Nodes);
+  bNodeTree *ntree = bke::node_tree_add_tree(bmain, "BGE_instances", "GeometryNodeTree");
+  nmd->node_group = ntree;
+
+  ntree->tree_interface.add_socket(
+      "Geometry", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_OUTPUT, nullptr);
+  ntree->tree_interface.add_socket(
+      "Geometry", "", "NodeSocketGeometry", NODE_INTERFACE_SOCKET_INPUT, nullptr);
+  bNode *groupInput = bke::node_add_static_node(C, ntree, NODE_GROUP_INPUT);
+  bNode *groupOutput = bke::node_add_static_node(C, ntree, NODE_GROUP_OUTPUT);
+  bNode *objectInfo = bke::node_add_static_node(C, ntree, GEO_NODE_OBJECT_INFO);
+  bNode *instanceOnPoints = bke::node_add_static_node(C, ntree, GEO_NODE_INSTANCE_ON_POINTS);
+  bNode *transform = bke::node_add_static_node(C, ntree, GEO_NODE_INPUT_NAMED_ATTRIBUTE);
+  bNode *setTransform = bke::node_add_static_node(C, ntree, GEO_NODE_SET_INSTANCE_TRANSFORM);
+
+  // The prototype geometry is instanced in its own space, the points give the world transform.
+  bNodeSocket *object = bke::node_find_socket(objectInfo, SOCK_IN, "Object");
+  ((bNodeSocketValueObject *)object->default_value)->value = m_prototype;
+  id_us_plus(&m_prototype->id);
+  bNodeSocket *asInstance = bke::node_find_socket(objectInfo, SOCK_IN, "As Instance");
+  ((bNodeSocketValueBoolean *)asInstance->default_value)->value = true;
+
+  ((NodeGeometryInputNamedAttribute *)transform->storage)->data_type = CD_PROP_FLOAT4X4;
+  nodes::update_node_declaration_and_sockets(*ntree, *transform);
+  bNodeSocket *name = bke::node_find_socket(transform, SOCK_IN, "Name");
+  STRNCPY(((bNodeSocketValueString *)name->default_value)->value, "transform");
+
+  BKE_main_ensure_invariants(*bmain, ntree->id);
+
+  bke::node_add_link(ntree,
+                     groupInput,
+                     (bNodeSocket *)groupInput->outputs.first,
+                     instanceOnPoints,
+                     bke::node_find_socket(instanceOnPoints, SOCK_IN, "Points"));
+  bke::node_add_link(ntree,
+                     objectInfo,
+                     bke::node_find_socket(objectInfo, SOCK_OUT, "Geometry"),
+                     instanceOnPoints,
+                     bke::node_find_socket(instanceOnPoints, SOCK_IN, "Instance"));
+  bke::node_add_link(ntree,
+                     instanceOnPoints,
+                     bke::node_find_socket(instanceOnPoints, SOCK_OUT, "Instances"),
+                     setTransform,
+                     bke::node_find_socket(setTransform, SOCK_IN, "Instances"));
+  bke::node_add_link(ntree,
+                     transform,
+                     bke::node_find_socket(transform, SOCK_OUT, "Attribute"),
+                     setTransform,
+                     bke::node_find_socket(setTransform, SOCK_IN, "Transform"));
+  bke::node_add_link(ntree,
+                     setTransform,
+                     bke::node_find_socket(setTransform, SOCK_OUT, "Instances"),
+                     groupOutput,
+                     (bNodeSocket *)groupOutput->inputs.first);
+
+  BKE_main_ensure_invariants(*bmain, ntree->id);
+}
+
+KX_InstanceBuffer::~KX_InstanceBuffer()
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+
+  bNodeTree *ntree = ((NodesModifierData *)m_instancer->modifiers.first)->node_group;
+  BKE_id_delete(bmain, m_instancer);
+  BKE_id_delete(bmain, ntree);
+  BKE_id_delete(bmain, m_pointCloud);
+  BKE_id_delete(bmain, m_prototype);
+  DEG_relations_tag_update(bmain);
+}
+
+void KX_InstanceBuffer::AddObject(KX_GameObject *gameobj)
+{
+  gameobj->SetInstanceBuffer(this, m_objects.size());
+
+  m_objects.push_back(gameobj);
+  m_transforms.push_back(float4x4::identity());
+  const MT_Vector4 &color = gameobj->GetObjectColor();
+  m_colors.emplace_back(color[0], color[1], color[2], color[3]);
+  m_visible.push_back(gameobj->GetVisible());
+
+  m_modified = true;
+}
+
+void KX_InstanceBuffer::RemoveObject(KX_GameObject *gameobj)
+{
+  const unsigned int index = gameobj->GetInstanceIndex();
+  const unsigned int last = m_objects.size() - 1;
+
+  // Move the last instance in the freed slot to keep the buffers contiguous.
+  if (index != last) {
+    m_objects[index] = m_objects[last];
+    m_transforms[index] = m_transforms[last];
+    m_colors[index] = m_colors[last];
+    m_visible[index] = m_visible[last];
+    m_objects[index]->SetInstanceBuffer(this, index);
+  }
+
+  m_objects.pop_back();
+  m_transforms.pop_back();
+  m_colors.pop_back();
+  m_visible.pop_back();
+
+  gameobj->SetInstanceBuffer(nullptr, 0);
+
+  m_modified = true;
+}
+
+void KX_InstanceBuffer::SetTransform(unsigned int index, const float mat[4][4])
+{
+  m_transforms[index] = float4x4(mat);
+  m_modified = true;
+}
+
+void KX_InstanceBuffer::SetColor(unsigned int index, const MT_Vector4 &color)
+{
+  m_colors[index] = ColorGeometry4f(color[0], color[1], color[2], color[3]);
+  m_modified = true;
+}
+
+void KX_InstanceBuffer::SetVisible(unsigned int index, bool visible)
+{
+  m_visible[index] = visible;
+  m_modified = true;
+}
+
+void KX_InstanceBuffer::Update()
+{
+  if (!m_modified) {
+    return;
+  }
+
+  int numVisible = 0;
+  for (const bool visible : m_visible) {
+    numVisible += visible;
+  }
+
+  // Reallocate the points only when their number changed.
+  if (numVisible != m_pointCloud->totpoint) {
+    BKE_pointcloud_nomain_to_pointcloud(BKE_pointcloud_new_nomain(numVisible), m_pointCloud);
+  }
+
+  MutableSpan<float3> positions = m_pointCloud->positions_for_write();
+  bke::MutableAttributeAccessor attributes = m_pointCloud->attributes_for_write();
+  bke::SpanAttributeWriter<float4x4> transforms =
+      attributes.lookup_or_add_for_write_only_span<float4x4>("transform", bke::AttrDomain::Point);
+  /* Propagated to the instances, readable in materials with an attribute node of type
+   * instancer, the object color of the prototype is shared by all the instances. */
+  bke::SpanAttributeWriter<ColorGeometry4f> colors =
+      attributes.lookup_or_add_for_write_only_span<ColorGeometry4f>("color",
+                                                                    bke::AttrDomain::Point);
+
+  for (unsigned int i = 0, j = 0, size = m_objects.size(); i < size; ++i) {
+    if (m_visible[i]) {
+      positions[j] = m_transforms[i].location();
+      transforms.span[j] = m_transforms[i];
+      colors.span[j] = m_colors[i];
+      ++j;
+    }
+  }
+  transforms.finish();
+  colors.finish();
+
+  m_pointCloud->tag_positions_changed();
+  DEG_id_tag_update(&m_pointCloud->id, ID_RECALC_GEOMETRY);
+
+  m_modified = false;
+}
@@ -0,0 +1,60 @@
+/** \file KX_InstanceBuffer.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "BLI_color.hh"
+#include "BLI_math_matrix_types.hh"
+
+#include "MT_Vector4.h"
+
+class KX_GameObject;
+class KX_Scene;
+struct Object;
+struct PointCloud;
+
+/** Draw the replicas of a template object using game instancing (OB_GAME_INSTANCING) as
+ * instances of a single hidden copy of the template instead of one blender object per replica.
+ * The world transform and color of each replica are stored in contiguous buffers and written
+ * at render in the points of a point cloud instancer, a geometry nodes modifier of the
+ * instancer instances the template on the points with their "transform" attribute. The color
+ * is the "color" attribute of the instances, the draw manager draws all the replicas in one
+ * batch per material.
+ */
+class KX_InstanceBuffer {
+ private:
+  KX_Scene *m_scene;
+  /// Hidden copy of the template evaluated by the depsgraph and referenced by the instances.
+  Object *m_prototype;
+  /// Point cloud object instancing the prototype on its points.
+  Object *m_instancer;
+  PointCloud *m_pointCloud;
+
+  std::vector<KX_GameObject *> m_objects;
+  std::vector<blender::float4x4> m_transforms;
+  std::vector<blender::ColorGeometry4f> m_colors;
+  std::vector<bool> m_visible;
+
+  /// True when the buffers changed since they were written in the point cloud.
+  bool m_modified;
+
+  /// Add the geometry nodes modifier instancing the prototype on the points.
+  void AddInstancesModifier();
+
+ public:
+  KX_InstanceBuffer(KX_Scene *scene, Object *ob);
+  ~KX_InstanceBuffer();
+
+  void AddObject(KX_GameObject *gameobj);
+  void RemoveObject(KX_GameObject *gameobj);
+
+  void SetTransform(unsigned int index, const float mat[4][4]);
+  void SetColor(unsigned int index, const MT_Vector4 &color);
+  void SetVisible(unsigned int index, bool visible);
+
+  /// Write the buffers in the point cloud, must be called before the depsgraph update.
+  void Update();
+};
@@ -40,6 +40,7 @@
 
 #include "BKE_context.hh"
 #include "BLI_rect.h"
+#include "BLI_task.h"
 #include "../draw/intern/draw_command.hh"
 #include "DRW_render.hh"
 #include "GPU_context.hh"
@@ -49,10 +50,13 @@
 
 #include "BL_Converter.h"
 #include "BL_SceneConverter.h"
+#include "CM_Message.h"
+#include "CM_Trace.h"
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
 #include "KX_Camera.h"
 #include "KX_Globals.h"
 #include "KX_NetworkMessageScene.h"
+#include "KX_NetworkReplication.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PythonInit.h"  // for updatePythonJoysticks
 #include "PHY_IPhysicsEnvironment.h"
@@ -133,6 +137,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_rasterizer(nullptr),
       m_kxsystem(system),
       m_converter(nullptr),
+      m_networkMessageManager(nullptr),
+      m_networkReplication(nullptr),
       m_inputDevice(nullptr),
       m_bInitialized(false),
       m_flags(AUTO_ADD_DEBUG_PROPERTIES),
@@ -154,14 +160,20 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_cameraZoom(1.0f),
       m_overrideCamZoom(1.0f),
       m_logger(KX_TimeCategoryLogger(m_clock, 25)),
+      m_pythonProfiler(m_clock),
       m_average_framerate(0.0),
+      m_benchmarkFrames(0),
+      m_benchmarkWarmupFrames(0),
+      m_benchmarkFrame(0),
       m_showBoundingBox(KX_DebugOption::DISABLE),
       m_showArmature(KX_DebugOption::DISABLE),
       m_showCameraFrustum(KX_DebugOption::DISABLE),
       m_showShadowFrustum(KX_DebugOption::DISABLE)
 {
   for (int i = tc_first; i < tc_numCategories; i++) {
-    m_logger.AddCategory((KX_TimeCategory)i);
+    const std::string &label = m_profileLabels[i];
+    // Remove the trailing colon of the label.
+    m_logger.AddCategory((KX_TimeCategory)i, label.substr(0, label.size() - 1));
   }
 
 #ifdef WITH_PYTHON
@@ -181,6 +193,8 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
   Py_CLEAR(m_pyprofiledict);
 #endif
 
+  delete m_networkReplication;
+
   m_scenes->Release();
 }
 
@@ -241,6 +255,9 @@ void KX_KetsjiEngine::SetRasterizer(RAS_Rasterizer *rasterizer)
 void KX_KetsjiEngine::SetNetworkMessageManager(KX_NetworkMessageManager *manager)
 {
   m_networkMessageManager = manager;
+
+  delete m_networkReplication;
+  m_networkReplication = new KX_NetworkReplication(manager);
 }
 
 #ifdef WITH_PYTHON
@@ -302,6 +319,7 @@ void KX_KetsjiEngine::EndFrame()
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  UpdateBenchmark();
 
   m_logger.StartLog(tc_rasterizer);
   m_rasterizer->EndFrame();
@@ -347,6 +365,7 @@ void KX_KetsjiEngine::EndFrameViewportRender()
 
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
+  UpdateBenchmark();
 
   m_logger.StartLog(tc_rasterizer);
   // m_rasterizer->EndFrame();
@@ -484,6 +503,12 @@ bool KX_KetsjiEngine::NextFrame()
   }
 
   for (unsigned short i = 0; i < times.frames; ++i) {
+    CM_TraceScope frameTrace("frame", "Logic Frame");
+
+    /* The scenes list can't change before ProcessScheduledScenes, but it can change between the
+     * frames. */
+    const bool parallelScenes = UseParallelScenes();
+
     m_frameTime += times.framestep;
 
     m_converter->MergeAsyncLoads();
@@ -510,6 +535,8 @@ bool KX_KetsjiEngine::NextFrame()
 
     // for each scene, call the proceed functions
     for (KX_Scene *scene : m_scenes) {
+      CM_TraceScope sceneTrace("scene", scene->GetSceneName());
+
       /* Suspension holds the physics and logic processing for an
        * entire scene. Objects can be suspended individually, and
        * the settings for that precede the logic and physics
@@ -546,6 +573,12 @@ bool KX_KetsjiEngine::NextFrame()
       m_logger.StartLog(tc_scenegraph);
       scene->UpdateParents(m_frameTime);
 
+      // Physics of all scenes is proceeded together once all the logic is done.
+      if (parallelScenes) {
+        m_logger.StartLog(tc_services);
+        continue;
+      }
+
       m_logger.StartLog(tc_physics);
 
       // Perform physics calculations on the scene. This can involve
@@ -564,7 +597,15 @@ bool KX_KetsjiEngine::NextFrame()
       m_logger.StartLog(tc_services);
     }
 
+    if (parallelScenes) {
+      m_logger.StartLog(tc_physics);
+      ProceedScenesPhysicsParallel(times, (i == times.frames - 1));
+      m_logger.StartLog(tc_services);
+    }
+
     m_logger.StartLog(tc_network);
+    // The received messages are added before switching to make them visible in this frame.
+    m_networkReplication->Update(m_scenes);
     m_networkMessageManager->ClearMessages();
 
     // update system devices
@@ -581,6 +622,73 @@ bool KX_KetsjiEngine::NextFrame()
   return m_doRender;
 }
 
+struct ParallelScenesPoolData {
+  double frameTime;
+  double timestep;
+  double framestep;
+};
+
+static void proceed_scene_physics_thread_func(TaskPool *__restrict pool, void *taskdata)
+{
+  const ParallelScenesPoolData *data = static_cast<ParallelScenesPoolData *>(
+      BLI_task_pool_user_data(pool));
+  KX_Scene *scene = static_cast<KX_Scene *>(taskdata);
+
+  /* Physics environments of different scenes share nothing but the Bullet global
+   * deactivation settings, equal for all scenes and only read here, and the scene graph
+   * scheduling is already protected by the SG_Node mutexes. */
+  scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+      data->frameTime, data->timestep, data->framestep);
+  scene->UpdateParents(data->frameTime);
+}
+
+bool KX_KetsjiEngine::UseParallelScenes()
+{
+  // Stepping scenes in parallel is only worth with several scenes.
+  if (!(m_flags & PARALLEL_SCENES) || m_scenes->GetCount() < 2) {
+    return false;
+  }
+
+  // The scenes share the physics engine globals, they must use the same values.
+  PHY_IPhysicsEnvironment *firstEnv = m_scenes->GetFront()->GetPhysicsEnvironment();
+  for (KX_Scene *scene : m_scenes) {
+    if (!firstEnv->HasSameGlobalSettings(scene->GetPhysicsEnvironment())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void KX_KetsjiEngine::ProceedScenesPhysicsParallel(const FrameTimes &times, bool updateSoftBodies)
+{
+  ParallelScenesPoolData data;
+  data.frameTime = m_frameTime;
+  data.timestep = times.timestep;
+  data.framestep = times.framestep;
+
+  // The globals are the same for all the scenes, they are written once before the tasks.
+  m_scenes->GetFront()->GetPhysicsEnvironment()->ApplyGlobalSettings();
+
+  TaskPool *taskpool = BLI_task_pool_create(&data, TASK_PRIORITY_HIGH);
+
+  for (KX_Scene *scene : m_scenes) {
+    BLI_task_pool_push(taskpool, proceed_scene_physics_thread_func, scene, false, nullptr);
+  }
+
+  // Barrier, every scene must be updated before the scenes management.
+  BLI_task_pool_work_and_wait(taskpool);
+  BLI_task_pool_free(taskpool);
+
+  /* Soft bodies write into Blender meshes which could be shared between scenes,
+   * keep it serialized. */
+  if (updateSoftBodies) {
+    for (KX_Scene *scene : m_scenes) {
+      scene->GetPhysicsEnvironment()->UpdateSoftBodies();
+    }
+  }
+}
+
 KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
     KX_Scene *scene,
     KX_Camera *camera,
@@ -761,6 +869,8 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
 
 void KX_KetsjiEngine::Render()
 {
+  CM_TraceScope renderTrace("frame", "Render");
+
   m_logger.StartLog(tc_rasterizer);
 
   BeginFrame();
@@ -1309,6 +1419,27 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    // Scripts with the most cumulative time since the Python profiling was enabled.
+    if (m_pythonProfiler.GetEnabled()) {
+      ycoord += title_y_top_margin;
+      debugDraw.RenderText2D(
+          "Python Scripts", MT_Vector2(xcoord + const_xindent + title_xmargin, ycoord), white);
+      ycoord += const_ysize;
+      ycoord += title_y_bottom_margin;
+
+      for (const KX_PythonProfiler::Entry &entry : m_pythonProfiler.GetEntries(5)) {
+        debugDraw.RenderText2D(entry.m_name, MT_Vector2(xcoord + const_xindent, ycoord), white);
+
+        debugtxt = fmt::format("{:>8.1f}ms | max {:.2f}ms | {} calls",
+                               (entry.m_totalTime * 1000.0),
+                               (entry.m_maxTime * 1000.0),
+                               entry.m_calls);
+        debugDraw.RenderText2D(
+            debugtxt, MT_Vector2(xcoord + const_xindent + 2 * profile_indent, ycoord), white);
+        ycoord += const_ysize;
+      }
+    }
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -1595,6 +1726,39 @@ bool KX_KetsjiEngine::GetRender()
   return m_doRender;
 }
 
+void KX_KetsjiEngine::SetBenchmark(int frames, int warmupFrames)
+{
+  m_benchmarkFrames = frames;
+  m_benchmarkWarmupFrames = warmupFrames;
+  m_benchmarkFrame = 0;
+
+  // Keep the measurements of all the benchmarked frames plus the current one.
+  m_logger.SetMaxNumMeasurements(frames + 1);
+}
+
+void KX_KetsjiEngine::UpdateBenchmark()
+{
+  if (m_benchmarkFrames == 0) {
+    return;
+  }
+
+  /* The logger stores the last measured frames, once enough frames are run all the warmup
+   * frames are out of the measurements. */
+  if (++m_benchmarkFrame < (m_benchmarkWarmupFrames + m_benchmarkFrames)) {
+    return;
+  }
+
+  CM_Message("Benchmark: " << m_benchmarkFrames << " frames");
+  for (int i = tc_first; i < tc_numCategories; ++i) {
+    const double time = m_logger.GetAverage((KX_TimeCategory)i);
+    CM_Message("Benchmark " << m_profileLabels[i] << " " << (time * 1000.0) << " ms");
+  }
+  CM_Message("Benchmark Total: " << (m_logger.GetAverage() * 1000.0) << " ms");
+
+  m_benchmarkFrames = 0;
+  RequestExit(KX_ExitRequest::QUIT_GAME);
+}
+
 void KX_KetsjiEngine::ProcessScheduledScenes(void)
 {
   // Check whether there will be changes to the list of scenes
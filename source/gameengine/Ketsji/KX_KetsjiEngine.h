@@ -38,6 +38,7 @@
 #include "CM_Clock.h"
 #include "EXP_Python.h"
 #include "KX_ISystem.h"
+#include "KX_PythonProfiler.h"
 #include "KX_Scene.h"
 #include "KX_TimeCategoryLogger.h"
 #include "MT_Matrix4x4.h"
@@ -47,6 +48,7 @@
 class KX_ISystem;
 class BL_Converter;
 class KX_NetworkMessageManager;
+class KX_NetworkReplication;
 class RAS_ICanvas;
 class RAS_FrameBuffer;
 class SCA_IInputDevice;
@@ -90,7 +92,9 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Step physics and scene graph of independent scenes in parallel?
+    PARALLEL_SCENES = (1 << 8)
   };
 
  private:
@@ -140,6 +144,8 @@ class KX_KetsjiEngine {
   KX_ISystem *m_kxsystem;
   BL_Converter *m_converter;
   KX_NetworkMessageManager *m_networkMessageManager;
+  /// Replication of objects and messages with other engines over the network.
+  KX_NetworkReplication *m_networkReplication;
 #ifdef WITH_PYTHON
   PyObject *m_pyprofiledict;
 #endif
@@ -228,12 +234,21 @@ class KX_KetsjiEngine {
 
   /// Time logger.
   KX_TimeCategoryLogger m_logger;
+  /// Time spent in each Python component and controller script.
+  KX_PythonProfiler m_pythonProfiler;
 
   /// Labels for profiling display.
   static const std::string m_profileLabels[tc_numCategories];
   /// Last estimated framerate
   double m_average_framerate;
 
+  /// Number of frames measured by the benchmark mode, 0 when disabled.
+  int m_benchmarkFrames;
+  /// Number of frames ignored at the start of the benchmark.
+  int m_benchmarkWarmupFrames;
+  /// Number of frames run since the start of the benchmark.
+  int m_benchmarkFrame;
+
   /// Enable debug draw of culling bounding boxes.
   KX_DebugOption m_showBoundingBox;
   /// Enable debug draw armatures.
@@ -264,6 +279,8 @@ class KX_KetsjiEngine {
   /// EEVEE scene rendering
   void RenderCamera(KX_Scene *scene, class RAS_FrameBuffer *background_fb, const CameraRenderData &cameraFrameData, unsigned short pass);
   void RenderDebugProperties();
+  /// Count the frame in the benchmark and print the times and quit when it's finished.
+  void UpdateBenchmark();
   /// Debug draw cameras frustum of a scene.
   void DrawDebugCameraFrustum(KX_Scene *scene,
                               RAS_DebugDraw &debugDraw,
@@ -289,6 +306,18 @@ class KX_KetsjiEngine {
   void BeginFrame();
   FrameTimes GetFrameTimes();
 
+  /** Return true if the physics of the scenes can be proceeded in parallel, with several
+   * scenes sharing the same physics globals.
+   */
+  bool UseParallelScenes();
+  /**
+   * Proceed physics and scene graph update of all scenes at the same time on the task pool.
+   * Logic and python are not executed here, they must be run before for every scenes.
+   * \param updateSoftBodies Also update soft bodies meshes, done serially after the parallel
+   * step.
+   */
+  void ProceedScenesPhysicsParallel(const FrameTimes &times, bool updateSoftBodies);
+
  public:
   KX_KetsjiEngine(KX_ISystem *system,
                   struct bContext *C,
@@ -343,6 +372,14 @@ class KX_KetsjiEngine {
   {
     return m_networkMessageManager;
   }
+  KX_NetworkReplication *GetNetworkReplication() const
+  {
+    return m_networkReplication;
+  }
+  KX_PythonProfiler *GetPythonProfiler()
+  {
+    return &m_pythonProfiler;
+  }
 
   /// returns true if an update happened to indicate -> Render
   bool NextFrame();
@@ -472,6 +509,13 @@ class KX_KetsjiEngine {
    */
   bool GetRender();
 
+  /** Enable the benchmark mode, the game is quit after the measured frames and the average
+   * time of each profiling category is printed.
+   * \param frames The number of measured frames.
+   * \param warmupFrames The number of frames run before the measure.
+   */
+  void SetBenchmark(int frames, int warmupFrames);
+
   /// Allow debug bounding box debug.
   void SetShowBoundingBox(KX_DebugOption mode);
   /// Returns the current setting for bounding box debug.
@@ -28,6 +28,9 @@
 
 #include "BLI_time.h"
 
+/// Part of the global progress used by each stage.
+static const float stageWeights[KX_LibLoadStatus::STAGE_MAX] = {0.1f, 0.3f, 0.5f, 0.1f, 0.0f, 0.0f};
+
 KX_LibLoadStatus::KX_LibLoadStatus(class BL_Converter *kx_converter,
                                    class KX_KetsjiEngine *kx_engine,
                                    class KX_Scene *merge_scene,
@@ -38,6 +41,8 @@ KX_LibLoadStatus::KX_LibLoadStatus(class BL_Converter *kx_converter,
       m_data(nullptr),
       m_libname(path),
       m_progress(0.0f),
+      m_stage(STAGE_READ),
+      m_stageProgress(0.0f),
       m_finished(false)
 #ifdef WITH_PYTHON
       ,
@@ -48,16 +53,48 @@ KX_LibLoadStatus::KX_LibLoadStatus(class BL_Converter *kx_converter,
   m_endtime = m_starttime = BLI_time_now_seconds();
 }
 
+KX_LibLoadStatus::~KX_LibLoadStatus()
+{
+#ifdef WITH_PYTHON
+  Py_XDECREF(m_finish_cb);
+  Py_XDECREF(m_progress_cb);
+#endif
+}
+
 void KX_LibLoadStatus::Finish()
 {
-  m_finished = true;
   m_progress = 1.f;
+  m_stage = STAGE_FINISHED;
+  m_stageProgress = 1.0f;
   m_endtime = BLI_time_now_seconds();
+  m_finished = true;
 
   RunFinishCallback();
   RunProgressCallback();
 }
 
+void KX_LibLoadStatus::Fail()
+{
+  // Finished to stop the scripts waiting for the load, but the progress is left as is.
+  m_stage = STAGE_FAILED;
+  m_endtime = BLI_time_now_seconds();
+  m_finished = true;
+}
+
+void KX_LibLoadStatus::Free()
+{
+#ifdef WITH_PYTHON
+  // A script can still use the status, give its ownership to the proxy.
+  if (m_proxy) {
+    EXP_PROXY_PYOWNS(m_proxy) = true;
+    Py_DECREF(m_proxy);
+    return;
+  }
+#endif
+
+  delete this;
+}
+
 void KX_LibLoadStatus::RunFinishCallback()
 {
 #ifdef WITH_PYTHON
@@ -110,6 +147,11 @@ class KX_Scene *KX_LibLoadStatus::GetMergeScene()
   return m_mergescene;
 }
 
+const std::string &KX_LibLoadStatus::GetLibraryName() const
+{
+  return m_libname;
+}
+
 void KX_LibLoadStatus::SetData(void *data)
 {
   m_data = data;
@@ -133,10 +175,34 @@ float KX_LibLoadStatus::GetProgress()
 
 void KX_LibLoadStatus::AddProgress(float progress)
 {
-  m_progress += progress;
+  // A single thread writes the progress, a load and a store are enough.
+  m_progress = m_progress + progress;
   RunProgressCallback();
 }
 
+void KX_LibLoadStatus::SetStage(Stage stage)
+{
+  float progress = 0.0f;
+  for (unsigned short i = 0; i < stage; ++i) {
+    progress += stageWeights[i];
+  }
+
+  m_stage = stage;
+  m_stageProgress = 0.0f;
+  SetProgress(progress);
+}
+
+KX_LibLoadStatus::Stage KX_LibLoadStatus::GetStage() const
+{
+  return m_stage;
+}
+
+void KX_LibLoadStatus::SetStageProgress(float progress)
+{
+  AddProgress((progress - m_stageProgress) * stageWeights[m_stage.load()]);
+  m_stageProgress = progress;
+}
+
 #ifdef WITH_PYTHON
 
 PyMethodDef KX_LibLoadStatus::Methods[] = {
@@ -148,10 +214,12 @@ PyAttributeDef KX_LibLoadStatus::Attributes[] = {
         "onFinish", KX_LibLoadStatus, pyattr_get_onfinish, pyattr_set_onfinish),
     // EXP_PYATTRIBUTE_RW_FUNCTION("onProgress", KX_LibLoadStatus, pyattr_get_onprogress,
     // pyattr_set_onprogress),
-    EXP_PYATTRIBUTE_FLOAT_RO("progress", KX_LibLoadStatus, m_progress),
+    EXP_PYATTRIBUTE_RO_FUNCTION("progress", KX_LibLoadStatus, pyattr_get_progress),
+    EXP_PYATTRIBUTE_RO_FUNCTION("stage", KX_LibLoadStatus, pyattr_get_stage),
+    EXP_PYATTRIBUTE_RO_FUNCTION("stageProgress", KX_LibLoadStatus, pyattr_get_stage_progress),
     EXP_PYATTRIBUTE_STRING_RO("libraryName", KX_LibLoadStatus, m_libname),
     EXP_PYATTRIBUTE_RO_FUNCTION("timeTaken", KX_LibLoadStatus, pyattr_get_timetaken),
-    EXP_PYATTRIBUTE_BOOL_RO("finished", KX_LibLoadStatus, m_finished),
+    EXP_PYATTRIBUTE_RO_FUNCTION("finished", KX_LibLoadStatus, pyattr_get_finished),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -259,6 +327,41 @@ int KX_LibLoadStatus::pyattr_set_onprogress(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+static const char *stageNames[KX_LibLoadStatus::STAGE_MAX] = {
+    "READ", "LINK", "CONVERT", "MERGE", "FINISHED", "FAILED"};
+
+PyObject *KX_LibLoadStatus::pyattr_get_progress(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_LibLoadStatus *self = static_cast<KX_LibLoadStatus *>(self_v);
+
+  return PyFloat_FromDouble(self->m_progress);
+}
+
+PyObject *KX_LibLoadStatus::pyattr_get_stage(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_LibLoadStatus *self = static_cast<KX_LibLoadStatus *>(self_v);
+
+  return PyUnicode_FromString(stageNames[self->m_stage]);
+}
+
+PyObject *KX_LibLoadStatus::pyattr_get_stage_progress(EXP_PyObjectPlus *self_v,
+                                                      const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_LibLoadStatus *self = static_cast<KX_LibLoadStatus *>(self_v);
+
+  return PyFloat_FromDouble(self->m_stageProgress);
+}
+
+PyObject *KX_LibLoadStatus::pyattr_get_finished(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_LibLoadStatus *self = static_cast<KX_LibLoadStatus *>(self_v);
+
+  return PyBool_FromLong(self->m_finished);
+}
+
 PyObject *KX_LibLoadStatus::pyattr_get_timetaken(EXP_PyObjectPlus *self_v,
                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
 {
@@ -26,21 +26,45 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "EXP_PyObjectPlus.h"
 
 class KX_LibLoadStatus : public EXP_PyObjectPlus {
-  Py_Header private : class BL_Converter *m_converter;
+  Py_Header
+
+ public:
+  /// Stages of a library load, in order.
+  enum Stage {
+    STAGE_READ = 0,
+    STAGE_LINK,
+    STAGE_CONVERT,
+    STAGE_MERGE,
+    STAGE_FINISHED,
+    /// The library couldn't be read, the load is finished without running the finish callback.
+    STAGE_FAILED,
+    STAGE_MAX
+  };
+
+ private:
+  class BL_Converter *m_converter;
   class KX_KetsjiEngine *m_engine;
   class KX_Scene *m_mergescene;
   void *m_data;
   std::string m_libname;
 
-  float m_progress;
+  /* The progress and the stage are written by the loading thread of an asynchronous load and
+   * read by the scripts on the main thread, only the loading thread or the main thread writes
+   * them at a time. */
+  std::atomic<float> m_progress;
+  std::atomic<Stage> m_stage;
+  /// Progress of the current stage from 0.0 to 1.0.
+  std::atomic<float> m_stageProgress;
   double m_starttime;
   double m_endtime;
 
   // The current status of this libload, used by the scene converter.
-  bool m_finished;
+  std::atomic<bool> m_finished;
 
 #ifdef WITH_PYTHON
   PyObject *m_finish_cb;
@@ -52,14 +76,22 @@ class KX_LibLoadStatus : public EXP_PyObjectPlus {
                    class KX_KetsjiEngine *kx_engine,
                    class KX_Scene *merge_scene,
                    const std::string &path);
+  virtual ~KX_LibLoadStatus();
 
   void Finish();  // Called when the libload is done
+  /// Called when the libload failed, the finish callback is not run.
+  void Fail();
+  /** Release the status once the converter doesn't use it anymore, the status is deleted
+   * immediately or when its Python proxy is freed.
+   */
+  void Free();
   void RunFinishCallback();
   void RunProgressCallback();
 
   class BL_Converter *GetConverter();
   class KX_KetsjiEngine *GetEngine();
   class KX_Scene *GetMergeScene();
+  const std::string &GetLibraryName() const;
 
   void SetData(void *data);
   void *GetData();
@@ -73,6 +105,12 @@ class KX_LibLoadStatus : public EXP_PyObjectPlus {
   float GetProgress();
   void AddProgress(float progress);
 
+  /// Start a new stage, the global progress is set to the start of this stage.
+  void SetStage(Stage stage);
+  Stage GetStage() const;
+  /// Set the progress of the current stage and update the global progress.
+  void SetStageProgress(float progress);
+
 #ifdef WITH_PYTHON
   static PyObject *pyattr_get_onfinish(EXP_PyObjectPlus *self_v,
                                        const EXP_PYATTRIBUTE_DEF *attrdef);
@@ -85,6 +123,13 @@ class KX_LibLoadStatus : public EXP_PyObjectPlus {
                                    const EXP_PYATTRIBUTE_DEF *attrdef,
                                    PyObject *value);
 
+  static PyObject *pyattr_get_progress(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_stage(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_stage_progress(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_finished(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_timetaken(EXP_PyObjectPlus *self_v,
                                         const EXP_PYATTRIBUTE_DEF *attrdef);
 #endif
@@ -0,0 +1,127 @@
+/** \file gameengine/Ketsji/KX_NetworkMessageList.cpp
+ *  \ingroup ketsji
+ */
+
+#ifdef WITH_PYTHON
+
+#  include "KX_NetworkMessageList.h"
+
+#  include "EXP_ListWrapper.h"
+
+KX_NetworkMessageList::KX_NetworkMessageList(
+    const KX_NetworkMessageManager::MessageView &messages)
+    : m_messages(messages)
+{
+}
+
+KX_NetworkMessageList::~KX_NetworkMessageList()
+{
+}
+
+PyMethodDef KX_NetworkMessageList::Methods[] = {
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_NetworkMessageList::Attributes[] = {
+    EXP_PYATTRIBUTE_RO_FUNCTION("bodies", KX_NetworkMessageList, pyattr_get_bodies),
+    EXP_PYATTRIBUTE_RO_FUNCTION("subjects", KX_NetworkMessageList, pyattr_get_subjects),
+    EXP_PYATTRIBUTE_RO_FUNCTION("valid", KX_NetworkMessageList, pyattr_get_valid),
+    EXP_PYATTRIBUTE_NULL  // Sentinel
+};
+
+PyTypeObject KX_NetworkMessageList::Type = {
+    PyVarObject_HEAD_INIT(nullptr, 0) "KX_NetworkMessageList",
+    sizeof(EXP_PyObjectPlus_Proxy),
+    0,
+    py_base_dealloc,
+    0,
+    0,
+    0,
+    0,
+    py_base_repr,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Methods,
+    0,
+    0,
+    &EXP_PyObjectPlus::Type,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    py_base_new};
+
+bool KX_NetworkMessageList::check_valid_cb(void *self_v)
+{
+  return ((KX_NetworkMessageList *)self_v)->m_messages.IsValid();
+}
+
+int KX_NetworkMessageList::get_size_cb(void *self_v)
+{
+  return ((KX_NetworkMessageList *)self_v)->m_messages.GetSize();
+}
+
+PyObject *KX_NetworkMessageList::get_bodies_item_cb(void *self_v, int index)
+{
+  const std::string_view body = ((KX_NetworkMessageList *)self_v)->m_messages.GetBody(index);
+  return PyUnicode_FromStringAndSize(body.data(), body.size());
+}
+
+PyObject *KX_NetworkMessageList::get_subjects_item_cb(void *self_v, int index)
+{
+  const std::string &subject = ((KX_NetworkMessageList *)self_v)->m_messages.GetSubject(index);
+  return PyUnicode_FromStringAndSize(subject.c_str(), subject.size());
+}
+
+PyObject *KX_NetworkMessageList::pyattr_get_bodies(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  return (new EXP_ListWrapper(self_v,
+                              ((KX_NetworkMessageList *)self_v)->GetProxy(),
+                              KX_NetworkMessageList::check_valid_cb,
+                              KX_NetworkMessageList::get_size_cb,
+                              KX_NetworkMessageList::get_bodies_item_cb,
+                              nullptr,
+                              nullptr,
+                              EXP_ListWrapper::FLAG_FIND_VALUE))
+      ->NewProxy(true);
+}
+
+PyObject *KX_NetworkMessageList::pyattr_get_subjects(EXP_PyObjectPlus *self_v,
+                                                     const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  return (new EXP_ListWrapper(self_v,
+                              ((KX_NetworkMessageList *)self_v)->GetProxy(),
+                              KX_NetworkMessageList::check_valid_cb,
+                              KX_NetworkMessageList::get_size_cb,
+                              KX_NetworkMessageList::get_subjects_item_cb,
+                              nullptr,
+                              nullptr,
+                              EXP_ListWrapper::FLAG_FIND_VALUE))
+      ->NewProxy(true);
+}
+
+PyObject *KX_NetworkMessageList::pyattr_get_valid(EXP_PyObjectPlus *self_v,
+                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  return PyBool_FromLong(((KX_NetworkMessageList *)self_v)->m_messages.IsValid());
+}
+
+#endif  // WITH_PYTHON
@@ -0,0 +1,36 @@
+/** \file KX_NetworkMessageList.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#ifdef WITH_PYTHON
+
+#  include "EXP_PyObjectPlus.h"
+#  include "KX_NetworkMessageManager.h"
+
+/** Python access to the messages of the last frame, returned by bge.logic.getMessages.
+ * The subjects and bodies are converted to python strings only when accessed.
+ */
+class KX_NetworkMessageList : public EXP_PyObjectPlus {
+  Py_Header
+
+ private:
+  KX_NetworkMessageManager::MessageView m_messages;
+
+ public:
+  KX_NetworkMessageList(const KX_NetworkMessageManager::MessageView &messages);
+  virtual ~KX_NetworkMessageList();
+
+  static bool check_valid_cb(void *self_v);
+  static int get_size_cb(void *self_v);
+  static PyObject *get_bodies_item_cb(void *self_v, int index);
+  static PyObject *get_subjects_item_cb(void *self_v, int index);
+
+  static PyObject *pyattr_get_bodies(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_subjects(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_valid(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+};
+
+#endif  // WITH_PYTHON
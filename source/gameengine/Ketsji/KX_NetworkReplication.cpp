@@ -0,0 +1,927 @@
+/** \file gameengine/Ketsji/KX_NetworkReplication.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_NetworkReplication.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <set>
+
+#include "BLI_time.h"
+
+#include "CM_Message.h"
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_IntValue.h"
+#include "EXP_StringValue.h"
+#include "KX_GameObject.h"
+#include "KX_NetworkMessageManager.h"
+#include "KX_Scene.h"
+
+/// Packets header, "BGEN" and the protocol version.
+static const uint32_t PACKET_MAGIC = 0x4E454742;
+static const uint8_t PACKET_VERSION = 2;
+
+enum PacketType : uint8_t {
+  /// Sent to a new peer until it answers, the only packet adding its sender to the peers.
+  PACKET_HELLO = 0,
+  /// Sent when the replication stops, the peer is removed.
+  PACKET_BYE,
+  PACKET_MESSAGE,
+  PACKET_SNAPSHOT,
+  /// Acknowledge the reception of a snapshot, followed by its sequence.
+  PACKET_ACK
+};
+
+/// Object state fields present in a snapshot packet.
+enum ObjectField : uint8_t {
+  FIELD_POSITION = (1 << 0),
+  FIELD_ORIENTATION = (1 << 1),
+  FIELD_SCALE = (1 << 2),
+  FIELD_PROPERTIES = (1 << 3),
+  /// Name of an object not in the baseline.
+  FIELD_NAME = (1 << 4)
+};
+
+enum PropertyType : uint8_t {
+  PROPERTY_BOOL = 0,
+  PROPERTY_INT,
+  PROPERTY_FLOAT,
+  PROPERTY_STRING
+};
+
+/// Position and scale precision, in units.
+static const double LINEAR_PRECISION = 0.001;
+static const double QUATERNION_PRECISION = 32767.0;
+
+const double KX_NetworkReplication::PEER_TIMEOUT = 10.0;
+
+static int32_t quantize_linear(double value)
+{
+  const double quantized = std::round(value / LINEAR_PRECISION);
+  return (int32_t)std::max(-2147483647.0, std::min(2147483647.0, quantized));
+}
+
+/// Encode an integer of size bytes in little endian, as a property value.
+static std::string encode_integer(uint64_t value, unsigned int size)
+{
+  std::string str(size, '\0');
+  for (unsigned int i = 0; i < size; ++i) {
+    str[i] = (char)((value >> (i * 8)) & 0xFF);
+  }
+  return str;
+}
+
+/// Decode a little endian integer property value, the missing bytes are zero.
+static uint64_t decode_integer(const std::string &str)
+{
+  uint64_t value = 0;
+  for (unsigned int i = 0, size = std::min<size_t>(str.size(), 8); i < size; ++i) {
+    value |= uint64_t((unsigned char)str[i]) << (i * 8);
+  }
+  return value;
+}
+
+/// Little endian writer of a packet.
+class KX_NetworkReplication::PacketWriter {
+ private:
+  std::vector<unsigned char> &m_data;
+
+ public:
+  PacketWriter(std::vector<unsigned char> &data, PacketType type) : m_data(data)
+  {
+    m_data.clear();
+    Uint32(PACKET_MAGIC);
+    Uint8(PACKET_VERSION);
+    Uint8(type);
+  }
+
+  void Uint8(uint8_t value)
+  {
+    m_data.push_back(value);
+  }
+
+  void Uint16(uint16_t value)
+  {
+    m_data.push_back(value & 0xFF);
+    m_data.push_back(value >> 8);
+  }
+
+  void Uint32(uint32_t value)
+  {
+    for (unsigned short i = 0; i < 4; ++i) {
+      m_data.push_back((value >> (i * 8)) & 0xFF);
+    }
+  }
+
+  void Bytes(const std::string &value)
+  {
+    m_data.insert(m_data.end(), value.begin(), value.end());
+  }
+
+  /// String with a 16 bits length, truncated if longer.
+  void String(const std::string &value)
+  {
+    const uint16_t size = std::min<size_t>(value.size(), UINT16_MAX);
+    Uint16(size);
+    m_data.insert(m_data.end(), value.begin(), value.begin() + size);
+  }
+
+  void LongString(const std::string &value)
+  {
+    Uint32(value.size());
+    Bytes(value);
+  }
+
+  size_t GetSize() const
+  {
+    return m_data.size();
+  }
+
+  void SetUint16(size_t offset, uint16_t value)
+  {
+    m_data[offset] = value & 0xFF;
+    m_data[offset + 1] = value >> 8;
+  }
+};
+
+/// Little endian reader of a packet, invalid once reading past the end.
+class KX_NetworkReplication::PacketReader {
+ private:
+  const std::vector<unsigned char> &m_data;
+  size_t m_offset;
+  bool m_valid;
+
+  bool Check(size_t size)
+  {
+    m_valid = m_valid && (m_offset + size <= m_data.size());
+    return m_valid;
+  }
+
+ public:
+  PacketReader(const std::vector<unsigned char> &data) : m_data(data), m_offset(0), m_valid(true)
+  {
+  }
+
+  bool IsValid() const
+  {
+    return m_valid;
+  }
+
+  uint8_t Uint8()
+  {
+    return Check(1) ? m_data[m_offset++] : 0;
+  }
+
+  uint16_t Uint16()
+  {
+    if (!Check(2)) {
+      return 0;
+    }
+    const uint16_t value = m_data[m_offset] | (m_data[m_offset + 1] << 8);
+    m_offset += 2;
+    return value;
+  }
+
+  uint32_t Uint32()
+  {
+    if (!Check(4)) {
+      return 0;
+    }
+    uint32_t value = 0;
+    for (unsigned short i = 0; i < 4; ++i) {
+      value |= uint32_t(m_data[m_offset++]) << (i * 8);
+    }
+    return value;
+  }
+
+  std::string Bytes(size_t size)
+  {
+    if (!Check(size)) {
+      return "";
+    }
+    const std::string value((const char *)m_data.data() + m_offset, size);
+    m_offset += size;
+    return value;
+  }
+
+  std::string String()
+  {
+    return Bytes(Uint16());
+  }
+
+  std::string LongString()
+  {
+    return Bytes(Uint32());
+  }
+};
+
+bool KX_NetworkReplication::PropertyState::operator==(const PropertyState &other) const
+{
+  return (type == other.type && value == other.value);
+}
+
+KX_NetworkReplication::Snapshot::Snapshot() : sequence(0)
+{
+}
+
+KX_NetworkReplication::KX_NetworkReplication(KX_NetworkMessageManager *messageManager)
+    : m_messageManager(messageManager),
+      m_sequence(0),
+      m_lastNetworkId(0),
+      m_rate(20.0),
+      m_lastSnapshotTime(0.0),
+      m_overflowReported(false)
+{
+}
+
+KX_NetworkReplication::~KX_NetworkReplication()
+{
+  Stop();
+}
+
+bool KX_NetworkReplication::Start(const std::string &host,
+                                  unsigned short port,
+                                  double rate,
+                                  std::string &error)
+{
+  Stop();
+
+  if (!m_transport.Open(host, port, error)) {
+    return false;
+  }
+
+  m_rate = rate;
+  m_lastSnapshotTime = 0.0;
+  m_overflowReported = false;
+
+  return true;
+}
+
+void KX_NetworkReplication::Stop()
+{
+  if (!m_transport.IsOpen()) {
+    return;
+  }
+
+  std::vector<unsigned char> data;
+  PacketWriter writer(data, PACKET_BYE);
+  for (Peer *peer : m_peers) {
+    m_transport.Send(peer->address, data);
+    delete peer;
+  }
+  m_peers.clear();
+
+  // The I/O thread sends the bye packets before closing.
+  m_transport.Close();
+
+  for (Snapshot &snapshot : m_sent) {
+    snapshot = Snapshot();
+  }
+  m_sequence = 0;
+}
+
+bool KX_NetworkReplication::IsStarted() const
+{
+  return m_transport.IsOpen();
+}
+
+unsigned short KX_NetworkReplication::GetPort() const
+{
+  return m_transport.GetPort();
+}
+
+bool KX_NetworkReplication::Connect(const std::string &host, unsigned short port)
+{
+  KX_NetworkTransport::Address address;
+  if (!KX_NetworkTransport::ResolveAddress(host, port, address)) {
+    return false;
+  }
+
+  Peer *peer = FindPeer(address, true, BLI_time_now_seconds());
+  if (peer) {
+    SendHello(peer);
+  }
+  return true;
+}
+
+std::vector<std::string> KX_NetworkReplication::GetPeers() const
+{
+  std::vector<std::string> peers;
+  for (const Peer *peer : m_peers) {
+    if (peer->connected) {
+      peers.push_back(peer->address.GetText());
+    }
+  }
+  return peers;
+}
+
+KX_NetworkReplication::Peer *KX_NetworkReplication::FindPeer(
+    const KX_NetworkTransport::Address &address, bool add, double time)
+{
+  for (Peer *peer : m_peers) {
+    if (peer->address == address) {
+      return peer;
+    }
+  }
+
+  if (!add || m_peers.size() >= MAX_PEERS) {
+    return nullptr;
+  }
+
+  Peer *peer = new Peer();
+  peer->address = address;
+  peer->connected = false;
+  peer->lastReceiveTime = time;
+  peer->ackedSequence = 0;
+  peer->receivedSequence = 0;
+  m_peers.push_back(peer);
+
+  return peer;
+}
+
+void KX_NetworkReplication::SendHello(Peer *peer)
+{
+  std::vector<unsigned char> data;
+  PacketWriter writer(data, PACKET_HELLO);
+  m_transport.Send(peer->address, data);
+}
+
+void KX_NetworkReplication::SendRemoteMessage(const std::string &to,
+                                              const std::string &subject,
+                                              const std::string &body)
+{
+  if (!m_transport.IsOpen()) {
+    return;
+  }
+
+  std::vector<unsigned char> data;
+  PacketWriter writer(data, PACKET_MESSAGE);
+  writer.String(to);
+  writer.String(subject);
+  writer.LongString(body);
+
+  for (Peer *peer : m_peers) {
+    m_transport.Send(peer->address, data);
+  }
+}
+
+void KX_NetworkReplication::CaptureSnapshot(EXP_ListValue<KX_Scene> *scenes, Snapshot &snapshot)
+{
+  snapshot.objects.clear();
+
+  for (KX_Scene *scene : scenes) {
+    for (KX_GameObject *gameobj : scene->GetObjectList()) {
+      KX_GameObject::ReplicationInfo &info = gameobj->GetReplicationInfo();
+      if (!info.m_enabled) {
+        continue;
+      }
+
+      // The replicas of an object share its name, they are told apart by their network id.
+      if (info.m_networkId == 0) {
+        info.m_networkId = ++m_lastNetworkId;
+      }
+
+      ObjectState &state = snapshot.objects[info.m_networkId];
+      state.name = gameobj->GetName();
+
+      const MT_Vector3 &position = gameobj->NodeGetWorldPosition();
+      const MT_Vector3 &scale = gameobj->NodeGetWorldScaling();
+      for (unsigned short i = 0; i < 3; ++i) {
+        state.position[i] = quantize_linear(position[i]);
+        state.scale[i] = quantize_linear(scale[i]);
+      }
+
+      MT_Quaternion orientation = gameobj->NodeGetWorldOrientation().getRotation();
+      orientation.normalize();
+      // q and -q are the same rotation, keep w positive to avoid useless changes.
+      const float sign = (orientation[3] < 0.0f) ? -1.0f : 1.0f;
+      for (unsigned short i = 0; i < 4; ++i) {
+        state.orientation[i] = (int16_t)std::round(orientation[i] * sign * QUATERNION_PRECISION);
+      }
+
+      state.properties.clear();
+      for (const std::string &name : info.m_properties) {
+        EXP_Value *prop = gameobj->GetProperty(name);
+        if (!prop) {
+          continue;
+        }
+
+        PropertyState propState;
+        switch (prop->GetValueType()) {
+          case VALUE_BOOL_TYPE: {
+            propState.type = PROPERTY_BOOL;
+            propState.value = std::string(1, static_cast<EXP_BoolValue *>(prop)->GetBool());
+            break;
+          }
+          case VALUE_INT_TYPE: {
+            propState.type = PROPERTY_INT;
+            const int64_t intValue = static_cast<EXP_IntValue *>(prop)->GetInt();
+            propState.value = encode_integer((uint64_t)intValue, sizeof(intValue));
+            break;
+          }
+          case VALUE_FLOAT_TYPE: {
+            propState.type = PROPERTY_FLOAT;
+            const float floatValue = static_cast<EXP_FloatValue *>(prop)->GetFloat();
+            uint32_t bits;
+            memcpy(&bits, &floatValue, sizeof(bits));
+            propState.value = encode_integer(bits, sizeof(bits));
+            break;
+          }
+          case VALUE_STRING_TYPE: {
+            propState.type = PROPERTY_STRING;
+            propState.value = prop->GetText();
+            break;
+          }
+          default: {
+            // Timer and other types are not replicated.
+            continue;
+          }
+        }
+        state.properties.emplace(name, propState);
+      }
+    }
+  }
+}
+
+void KX_NetworkReplication::SendSnapshot(Peer *peer, const Snapshot &snapshot)
+{
+  // Use the last acknowledged snapshot as baseline if it's still in the history.
+  const Snapshot *baseline = nullptr;
+  if (peer->ackedSequence != 0 && snapshot.sequence - peer->ackedSequence < HISTORY_SIZE) {
+    const Snapshot &acked = m_sent[peer->ackedSequence % HISTORY_SIZE];
+    if (acked.sequence == peer->ackedSequence) {
+      baseline = &acked;
+    }
+  }
+
+  std::vector<unsigned char> data;
+  PacketWriter writer(data, PACKET_SNAPSHOT);
+  writer.Uint32(snapshot.sequence);
+  writer.Uint32(baseline ? baseline->sequence : 0);
+
+  // Objects of the baseline not replicated anymore.
+  const size_t removedOffset = writer.GetSize();
+  uint16_t numRemoved = 0;
+  writer.Uint16(0);
+  if (baseline) {
+    for (const auto &pair : baseline->objects) {
+      if (snapshot.objects.find(pair.first) == snapshot.objects.end()) {
+        writer.Uint32(pair.first);
+        ++numRemoved;
+      }
+    }
+  }
+  writer.SetUint16(removedOffset, numRemoved);
+
+  const size_t objectsOffset = writer.GetSize();
+  uint16_t numObjects = 0;
+  writer.Uint16(0);
+  for (const auto &pair : snapshot.objects) {
+    const ObjectState &state = pair.second;
+    const ObjectState *base = nullptr;
+    if (baseline) {
+      const auto it = baseline->objects.find(pair.first);
+      if (it != baseline->objects.end()) {
+        base = &it->second;
+      }
+    }
+
+    uint8_t fields = 0;
+    if (!base || memcmp(state.position, base->position, sizeof(state.position)) != 0) {
+      fields |= FIELD_POSITION;
+    }
+    if (!base || memcmp(state.orientation, base->orientation, sizeof(state.orientation)) != 0) {
+      fields |= FIELD_ORIENTATION;
+    }
+    if (!base || memcmp(state.scale, base->scale, sizeof(state.scale)) != 0) {
+      fields |= FIELD_SCALE;
+    }
+
+    std::vector<const std::pair<const std::string, PropertyState> *> properties;
+    for (const auto &prop : state.properties) {
+      if (base) {
+        const auto it = base->properties.find(prop.first);
+        if (it != base->properties.end() && it->second == prop.second) {
+          continue;
+        }
+      }
+      properties.push_back(&prop);
+    }
+    if (!properties.empty()) {
+      fields |= FIELD_PROPERTIES;
+    }
+    if (!base) {
+      fields |= FIELD_NAME;
+    }
+
+    // Unchanged object.
+    if (fields == 0) {
+      continue;
+    }
+
+    writer.Uint32(pair.first);
+    writer.Uint8(fields);
+    if (fields & FIELD_NAME) {
+      writer.String(state.name);
+    }
+    if (fields & FIELD_POSITION) {
+      for (unsigned short i = 0; i < 3; ++i) {
+        writer.Uint32(state.position[i]);
+      }
+    }
+    if (fields & FIELD_ORIENTATION) {
+      for (unsigned short i = 0; i < 4; ++i) {
+        writer.Uint16(state.orientation[i]);
+      }
+    }
+    if (fields & FIELD_SCALE) {
+      for (unsigned short i = 0; i < 3; ++i) {
+        writer.Uint32(state.scale[i]);
+      }
+    }
+    if (fields & FIELD_PROPERTIES) {
+      writer.Uint8(std::min<size_t>(properties.size(), UINT8_MAX));
+      for (unsigned int i = 0, size = std::min<size_t>(properties.size(), UINT8_MAX); i < size;
+           ++i)
+      {
+        writer.String(properties[i]->first);
+        writer.Uint8(properties[i]->second.type);
+        writer.LongString(properties[i]->second.value);
+      }
+    }
+    ++numObjects;
+  }
+  writer.SetUint16(objectsOffset, numObjects);
+
+  /* A partial snapshot would desynchronize the baselines of the peer, the snapshot
+   * is not sent and the peer will receive the next one. */
+  if (writer.GetSize() > KX_NetworkTransport::MAX_PACKET_SIZE) {
+    if (!m_overflowReported) {
+      CM_Warning("network snapshot of " << snapshot.objects.size()
+                                        << " replicated objects exceeds the datagram size, "
+                                           "reduce the number of replicated objects");
+      m_overflowReported = true;
+    }
+    return;
+  }
+
+  m_transport.Send(peer->address, data);
+}
+
+KX_GameObject *KX_NetworkReplication::FindTarget(Peer *peer,
+                                                 uint32_t networkId,
+                                                 const std::string &name,
+                                                 ReceiveObjects &objects,
+                                                 bool &r_newTarget)
+{
+  r_newTarget = false;
+
+  const auto it = peer->targets.find(networkId);
+  if (it != peer->targets.end()) {
+    if (it->second.name == name) {
+      return it->second.object;
+    }
+    objects.bound.erase(it->second.object);
+    peer->targets.erase(it);
+  }
+
+  // Bind the first object of the same name not receiving another replicated object.
+  const auto candidates = objects.byName.find(name);
+  if (candidates == objects.byName.end()) {
+    return nullptr;
+  }
+
+  for (KX_GameObject *gameobj : candidates->second) {
+    if (objects.bound.insert(gameobj).second) {
+      peer->targets[networkId] = {name, gameobj};
+      r_newTarget = true;
+      return gameobj;
+    }
+  }
+
+  return nullptr;
+}
+
+void KX_NetworkReplication::ReceiveSnapshot(Peer *peer,
+                                            PacketReader &reader,
+                                            ReceiveObjects &objects)
+{
+  const uint32_t sequence = reader.Uint32();
+  const uint32_t baselineSequence = reader.Uint32();
+
+  // Ignore the duplicated and late snapshots.
+  if (!reader.IsValid() || sequence <= peer->receivedSequence) {
+    return;
+  }
+
+  Snapshot snapshot;
+  if (baselineSequence != 0) {
+    const Snapshot &baseline = peer->received[baselineSequence % HISTORY_SIZE];
+    if (baseline.sequence != baselineSequence) {
+      // The baseline is not known anymore, wait for a snapshot with a known baseline.
+      return;
+    }
+    snapshot = baseline;
+  }
+  snapshot.sequence = sequence;
+
+  std::vector<uint32_t> removed;
+  for (unsigned int i = 0, size = reader.Uint16(); i < size; ++i) {
+    const uint32_t networkId = reader.Uint32();
+    snapshot.objects.erase(networkId);
+    removed.push_back(networkId);
+  }
+
+  std::vector<std::pair<uint32_t, uint8_t>> changes;
+  for (unsigned int i = 0, size = reader.Uint16(); i < size && reader.IsValid(); ++i) {
+    const uint32_t networkId = reader.Uint32();
+    const uint8_t fields = reader.Uint8();
+    auto it = snapshot.objects.emplace(networkId, ObjectState()).first;
+    ObjectState &state = it->second;
+
+    if (fields & FIELD_NAME) {
+      state.name = reader.String();
+    }
+    if (fields & FIELD_POSITION) {
+      for (unsigned short j = 0; j < 3; ++j) {
+        state.position[j] = reader.Uint32();
+      }
+    }
+    if (fields & FIELD_ORIENTATION) {
+      for (unsigned short j = 0; j < 4; ++j) {
+        state.orientation[j] = reader.Uint16();
+      }
+    }
+    if (fields & FIELD_SCALE) {
+      for (unsigned short j = 0; j < 3; ++j) {
+        state.scale[j] = reader.Uint32();
+      }
+    }
+    if (fields & FIELD_PROPERTIES) {
+      for (unsigned int j = 0, numProps = reader.Uint8(); j < numProps; ++j) {
+        const std::string propName = reader.String();
+        PropertyState &propState = state.properties[propName];
+        propState.type = reader.Uint8();
+        propState.value = reader.LongString();
+      }
+    }
+
+    changes.emplace_back(networkId, fields);
+  }
+
+  // Don't keep a corrupted snapshot.
+  if (!reader.IsValid()) {
+    return;
+  }
+
+  Snapshot &stored = peer->received[sequence % HISTORY_SIZE];
+  stored = std::move(snapshot);
+  peer->receivedSequence = sequence;
+
+  std::vector<unsigned char> data;
+  PacketWriter writer(data, PACKET_ACK);
+  writer.Uint32(sequence);
+  m_transport.Send(peer->address, data);
+
+  for (const uint32_t networkId : removed) {
+    const auto it = peer->targets.find(networkId);
+    if (it != peer->targets.end()) {
+      objects.bound.erase(it->second.object);
+      peer->targets.erase(it);
+    }
+  }
+
+  // Apply the changes to the objects bound to the replicated objects.
+  for (const auto &change : changes) {
+    const ObjectState &state = stored.objects.at(change.first);
+    bool newTarget;
+    KX_GameObject *gameobj = FindTarget(peer, change.first, state.name, objects, newTarget);
+    if (!gameobj) {
+      continue;
+    }
+
+    // A newly bound object didn't receive the unchanged fields of the previous snapshots.
+    const uint8_t fields = newTarget ?
+                               (FIELD_POSITION | FIELD_ORIENTATION | FIELD_SCALE |
+                                FIELD_PROPERTIES) :
+                               change.second;
+
+    if (fields & FIELD_POSITION) {
+      gameobj->NodeSetWorldPosition(MT_Vector3(state.position[0] * LINEAR_PRECISION,
+                                               state.position[1] * LINEAR_PRECISION,
+                                               state.position[2] * LINEAR_PRECISION));
+    }
+    if (fields & FIELD_ORIENTATION) {
+      MT_Quaternion orientation(state.orientation[0] / QUATERNION_PRECISION,
+                                state.orientation[1] / QUATERNION_PRECISION,
+                                state.orientation[2] / QUATERNION_PRECISION,
+                                state.orientation[3] / QUATERNION_PRECISION);
+      orientation.normalize();
+      gameobj->NodeSetGlobalOrientation(MT_Matrix3x3(orientation));
+    }
+    if (fields & FIELD_SCALE) {
+      gameobj->NodeSetWorldScale(MT_Vector3(state.scale[0] * LINEAR_PRECISION,
+                                            state.scale[1] * LINEAR_PRECISION,
+                                            state.scale[2] * LINEAR_PRECISION));
+    }
+    if (fields & (FIELD_POSITION | FIELD_ORIENTATION | FIELD_SCALE)) {
+      gameobj->NodeUpdateGS(0.0f);
+    }
+
+    if (fields & FIELD_PROPERTIES) {
+      for (const auto &pair : state.properties) {
+        const PropertyState &propState = pair.second;
+        EXP_Value *value = nullptr;
+        switch (propState.type) {
+          case PROPERTY_BOOL: {
+            value = new EXP_BoolValue(!propState.value.empty() && propState.value[0]);
+            break;
+          }
+          case PROPERTY_INT: {
+            value = new EXP_IntValue((int64_t)decode_integer(propState.value));
+            break;
+          }
+          case PROPERTY_FLOAT: {
+            const uint32_t bits = (uint32_t)decode_integer(propState.value);
+            float floatValue;
+            memcpy(&floatValue, &bits, sizeof(floatValue));
+            value = new EXP_FloatValue(floatValue);
+            break;
+          }
+          case PROPERTY_STRING: {
+            value = new EXP_StringValue(propState.value, "");
+            break;
+          }
+          default: {
+            continue;
+          }
+        }
+
+        EXP_Value *oldprop = gameobj->GetProperty(pair.first);
+        if (oldprop) {
+          oldprop->SetValue(value);
+        }
+        else {
+          gameobj->SetProperty(pair.first, value);
+        }
+        value->Release();
+      }
+    }
+  }
+}
+
+void KX_NetworkReplication::ReceivePacket(const KX_NetworkTransport::Packet &packet,
+                                          ReceiveObjects &objects,
+                                          double time)
+{
+  PacketReader reader(packet.data);
+  if (reader.Uint32() != PACKET_MAGIC || reader.Uint8() != PACKET_VERSION) {
+    return;
+  }
+
+  const PacketType type = (PacketType)reader.Uint8();
+  if (!reader.IsValid()) {
+    return;
+  }
+
+  if (type == PACKET_BYE) {
+    for (std::vector<Peer *>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+      if ((*it)->address == packet.address) {
+        delete *it;
+        m_peers.erase(it);
+        break;
+      }
+    }
+    return;
+  }
+
+  /* Only a hello registers its sender as peer, the other packets of unknown senders are
+   * ignored. */
+  Peer *peer = FindPeer(packet.address, (type == PACKET_HELLO), time);
+  if (!peer) {
+    return;
+  }
+  peer->lastReceiveTime = time;
+
+  if (type == PACKET_HELLO && peer->connected) {
+    // The peer restarted, its snapshots sequence and network ids too.
+    peer->ackedSequence = 0;
+    peer->receivedSequence = 0;
+    for (Snapshot &snapshot : peer->received) {
+      snapshot = Snapshot();
+    }
+    for (const auto &pair : peer->targets) {
+      objects.bound.erase(pair.second.object);
+    }
+    peer->targets.clear();
+  }
+  else if (!peer->connected) {
+    peer->connected = true;
+    // Make sure the sender knows us too.
+    SendHello(peer);
+  }
+
+  switch (type) {
+    case PACKET_MESSAGE: {
+      const std::string to = reader.String();
+      const std::string subject = reader.String();
+      const std::string body = reader.LongString();
+      if (reader.IsValid()) {
+        m_messageManager->AddMessage(to, nullptr, subject, body);
+      }
+      break;
+    }
+    case PACKET_SNAPSHOT: {
+      ReceiveSnapshot(peer, reader, objects);
+      break;
+    }
+    case PACKET_ACK: {
+      const uint32_t sequence = reader.Uint32();
+      if (reader.IsValid() && sequence > peer->ackedSequence && sequence <= m_sequence) {
+        peer->ackedSequence = sequence;
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void KX_NetworkReplication::Update(EXP_ListValue<KX_Scene> *scenes)
+{
+  if (!m_transport.IsOpen()) {
+    return;
+  }
+
+  std::vector<KX_NetworkTransport::Packet> packets;
+  m_transport.Receive(packets);
+
+  const double time = BLI_time_now_seconds();
+
+  if (!packets.empty()) {
+    // Objects receiving the snapshots, the replicated objects are owned by this instance.
+    ReceiveObjects objects;
+    std::set<KX_GameObject *> live;
+    for (KX_Scene *scene : scenes) {
+      for (KX_GameObject *gameobj : scene->GetObjectList()) {
+        if (!gameobj->GetReplicationInfo().m_enabled) {
+          objects.byName[gameobj->GetName()].push_back(gameobj);
+          live.insert(gameobj);
+        }
+      }
+    }
+
+    // Unbind the deleted or renamed objects, the others keep receiving the same object.
+    for (Peer *peer : m_peers) {
+      for (auto it = peer->targets.begin(); it != peer->targets.end();) {
+        const Target &target = it->second;
+        if (live.find(target.object) == live.end() || target.object->GetName() != target.name) {
+          it = peer->targets.erase(it);
+        }
+        else {
+          objects.bound.insert(target.object);
+          ++it;
+        }
+      }
+    }
+
+    for (const KX_NetworkTransport::Packet &packet : packets) {
+      ReceivePacket(packet, objects, time);
+    }
+  }
+
+  /* Forget the connected peers silent for too long, they were closed without a bye packet.
+   * The peers of netConnect not answering yet keep receiving hello packets. */
+  for (std::vector<Peer *>::iterator it = m_peers.begin(); it != m_peers.end();) {
+    if ((*it)->connected && (time - (*it)->lastReceiveTime) > PEER_TIMEOUT) {
+      delete *it;
+      it = m_peers.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  if (m_peers.empty() || (time - m_lastSnapshotTime) < (1.0 / m_rate)) {
+    return;
+  }
+  m_lastSnapshotTime = time;
+
+  Snapshot &snapshot = m_sent[(++m_sequence) % HISTORY_SIZE];
+  snapshot.sequence = m_sequence;
+  CaptureSnapshot(scenes, snapshot);
+
+  for (Peer *peer : m_peers) {
+    if (peer->connected) {
+      SendSnapshot(peer, snapshot);
+    }
+    else {
+      // The peer didn't answer yet, the hello packet may be lost.
+      SendHello(peer);
+    }
+  }
+}
@@ -0,0 +1,163 @@
+/** \file KX_NetworkReplication.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "EXP_ListValue.h"
+#include "KX_NetworkTransport.h"
+
+class KX_GameObject;
+class KX_NetworkMessageManager;
+class KX_Scene;
+
+/** Replication of game objects and messages between game engine instances over UDP.
+ * The replicated objects (KX_GameObject::ReplicationInfo) are sent in snapshots at a fixed
+ * rate to all the peers. The transforms are quantized and each snapshot is delta compressed
+ * against the last snapshot acknowledged by the peer, only the changed objects, transforms
+ * and properties are sent. Each replicated object is identified by a network id, the state of
+ * a peer object is applied to a distinct not replicated object of the same name and the
+ * received messages are added to the message manager for the message sensors.
+ * The peers are added by Connect or by their hello packet, and removed when they are silent
+ * for PEER_TIMEOUT seconds.
+ */
+class KX_NetworkReplication {
+ public:
+  /// Quantized state of a property, the value is stored as encoded in the packets.
+  struct PropertyState {
+    uint8_t type;
+    std::string value;
+
+    bool operator==(const PropertyState &other) const;
+  };
+
+  /// Quantized state of an object.
+  struct ObjectState {
+    /// Name of the object, the receiver applies the state to an object of this name.
+    std::string name;
+    int32_t position[3];
+    int16_t orientation[4];
+    int32_t scale[3];
+    std::map<std::string, PropertyState> properties;
+  };
+
+  struct Snapshot {
+    /// Snapshot sequence number, 0 for an unused snapshot.
+    uint32_t sequence;
+    /// Object states by network id.
+    std::map<uint32_t, ObjectState> objects;
+
+    Snapshot();
+  };
+
+  /// Number of snapshots kept to be used as delta baseline.
+  static const unsigned int HISTORY_SIZE = 32;
+  static const unsigned int MAX_PEERS = 32;
+  /// Time in seconds after which a peer sending nothing is removed.
+  static const double PEER_TIMEOUT;
+
+ private:
+  class PacketReader;
+  class PacketWriter;
+
+  /// Local object receiving the states of a peer object.
+  struct Target {
+    std::string name;
+    KX_GameObject *object;
+  };
+
+  struct Peer {
+    KX_NetworkTransport::Address address;
+    /// True once a packet was received from this peer.
+    bool connected;
+    /// Time of the last packet received from the peer, or of its creation.
+    double lastReceiveTime;
+    /// Last sent snapshot acknowledged by the peer.
+    uint32_t ackedSequence;
+    /// Last snapshot received from the peer.
+    uint32_t receivedSequence;
+    /// Snapshots received from the peer, baselines of the next ones.
+    Snapshot received[HISTORY_SIZE];
+    /// Local objects receiving the states of the peer objects, by network id.
+    std::map<uint32_t, Target> targets;
+  };
+
+  /// Local objects able to receive the states of the peers objects.
+  struct ReceiveObjects {
+    /// Not replicated objects by name.
+    std::map<std::string, std::vector<KX_GameObject *>> byName;
+    /// Objects already receiving the states of a peer object.
+    std::set<KX_GameObject *> bound;
+  };
+
+  KX_NetworkMessageManager *m_messageManager;
+  KX_NetworkTransport m_transport;
+
+  std::vector<Peer *> m_peers;
+  /// Snapshots sent, indexed by sequence modulo the history size.
+  Snapshot m_sent[HISTORY_SIZE];
+  uint32_t m_sequence;
+  /// Last network id given to a replicated object.
+  uint32_t m_lastNetworkId;
+
+  /// Snapshots sent per second.
+  double m_rate;
+  double m_lastSnapshotTime;
+  /// True when a snapshot was too large for a datagram, to warn only once.
+  bool m_overflowReported;
+
+  Peer *FindPeer(const KX_NetworkTransport::Address &address, bool add, double time);
+  void SendHello(Peer *peer);
+
+  /** Get the local object receiving the states of a peer object, the first not bound object of
+   * the same name is bound to the network id.
+   */
+  KX_GameObject *FindTarget(Peer *peer,
+                            uint32_t networkId,
+                            const std::string &name,
+                            ReceiveObjects &objects,
+                            bool &r_newTarget);
+  void ReceivePacket(const KX_NetworkTransport::Packet &packet,
+                     ReceiveObjects &objects,
+                     double time);
+  void ReceiveSnapshot(Peer *peer, PacketReader &reader, ReceiveObjects &objects);
+
+  void CaptureSnapshot(EXP_ListValue<KX_Scene> *scenes, Snapshot &snapshot);
+  void SendSnapshot(Peer *peer, const Snapshot &snapshot);
+
+ public:
+  KX_NetworkReplication(KX_NetworkMessageManager *messageManager);
+  ~KX_NetworkReplication();
+
+  /** Open the socket and start replicating.
+   * \param host The local IPv4 address to bind, "0.0.0.0" for all the interfaces.
+   * \param port The local port, 0 for any available port.
+   * \param rate The number of snapshots sent per second.
+   * \param error The error description when failing.
+   */
+  bool Start(const std::string &host, unsigned short port, double rate, std::string &error);
+  /// Notify the peers and close the socket.
+  void Stop();
+  bool IsStarted() const;
+  unsigned short GetPort() const;
+
+  /// Add a peer to replicate with, return false if the host can't be resolved.
+  bool Connect(const std::string &host, unsigned short port);
+  std::vector<std::string> GetPeers() const;
+
+  /// Send a message to the message sensors of all the peers.
+  void SendRemoteMessage(const std::string &to,
+                         const std::string &subject,
+                         const std::string &body);
+
+  /** Receive the messages and snapshots from the peers and send a snapshot of the
+   * replicated objects if needed.
+   */
+  void Update(EXP_ListValue<KX_Scene> *scenes);
+};
@@ -103,11 +103,14 @@
 #include "BL_Converter.h"
 #include "BL_Shader.h"
 #include "CM_Message.h"
+#include "CM_Trace.h"
 #include "KX_Globals.h"
 #include "KX_LibLoadStatus.h"
 #include "KX_MeshProxy.h" /* for creating a new library of mesh objects */
 #include "KX_NavMeshObject.h"
+#include "KX_NetworkMessageList.h"
 #include "KX_NetworkMessageScene.h"  //Needed for sendMessage()
+#include "KX_NetworkReplication.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PyMath.h"
 #include "KX_PythonInitTypes.h"
@@ -282,6 +285,111 @@ static PyObject *gPyGetProfileInfo(PyObject *)
   return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPySetPythonProfiling_doc,
+             "setPythonProfiling(enabled)\n"
+             "enables the measure of the time spent in each Python component class and "
+             "controller script, enabling clears the previous measures");
+static PyObject *gPySetPythonProfiling(PyObject *, PyObject *args)
+{
+  int enabled;
+
+  if (!PyArg_ParseTuple(args, "p:setPythonProfiling", &enabled))
+    return nullptr;
+
+  KX_GetActiveEngine()->GetPythonProfiler()->SetEnabled(enabled);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyGetPythonProfileInfo_doc,
+             "getPythonProfileInfo([maxEntries])\n"
+             "returns a list of (name, calls, total time, maximum time) tuples sorted by "
+             "decreasing total time, the times are in milliseconds"
+             " maxEntries = The number of returned scripts, all of them if 0");
+static PyObject *gPyGetPythonProfileInfo(PyObject *, PyObject *args)
+{
+  int maxEntries = 0;
+
+  if (!PyArg_ParseTuple(args, "|i:getPythonProfileInfo", &maxEntries))
+    return nullptr;
+
+  if (maxEntries < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "getPythonProfileInfo([maxEntries]): expected a positive number of entries");
+    return nullptr;
+  }
+
+  const std::vector<KX_PythonProfiler::Entry> entries =
+      KX_GetActiveEngine()->GetPythonProfiler()->GetEntries(maxEntries);
+
+  PyObject *list = PyList_New(entries.size());
+  for (unsigned int i = 0, size = entries.size(); i < size; ++i) {
+    const KX_PythonProfiler::Entry &entry = entries[i];
+    PyList_SET_ITEM(list,
+                    i,
+                    Py_BuildValue("(sIdd)",
+                                  entry.m_name.c_str(),
+                                  entry.m_calls,
+                                  entry.m_totalTime * 1000.0,
+                                  entry.m_maxTime * 1000.0));
+  }
+
+  return list;
+}
+
+PyDoc_STRVAR(gPyStartTrace_doc,
+             "startTrace([maxEvents])\n"
+             "starts recording the frame spans, clearing the previous ones"
+             " maxEvents = The number of spans kept, the oldest are overwritten");
+static PyObject *gPyStartTrace(PyObject *, PyObject *args)
+{
+  int maxEvents = CM_TraceRecorder::DEFAULT_MAX_EVENTS;
+
+  if (!PyArg_ParseTuple(args, "|i:startTrace", &maxEvents))
+    return nullptr;
+
+  if (maxEvents <= 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "startTrace([maxEvents]): expected a positive number of events");
+    return nullptr;
+  }
+
+  CM_TraceRecorder::Get().Start(maxEvents);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyStopTrace_doc,
+             "stopTrace()\n"
+             "stops recording the frame spans, the recorded spans are kept");
+static PyObject *gPyStopTrace(PyObject *)
+{
+  CM_TraceRecorder::Get().Stop();
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyDumpTrace_doc,
+             "dumpTrace(path)\n"
+             "writes the recorded spans in a Chrome trace event JSON file"
+             " path = The file path, relative to the blend file if starting with //");
+static PyObject *gPyDumpTrace(PyObject *, PyObject *args)
+{
+  char *path;
+
+  if (!PyArg_ParseTuple(args, "s:dumpTrace", &path))
+    return nullptr;
+
+  char expanded[FILE_MAX];
+  BLI_strncpy(expanded, path, FILE_MAX);
+  BLI_path_abs(expanded, KX_GetMainPath().c_str());
+
+  std::string error;
+  if (!CM_TraceRecorder::Get().Dump(expanded, error)) {
+    PyErr_Format(PyExc_OSError, "dumpTrace(path): can't write \"%s\", %s", expanded, error.c_str());
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
              "sendMessage(subject, [body, to, from])\n"
              "sends a message in same manner as a message actuator"
@@ -314,6 +422,129 @@ static PyObject *gPySendMessage(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(gPyGetMessages_doc,
+             "getMessages([subject, to])\n"
+             "returns the messages of the last frame in same manner as a message sensor"
+             " subject = Subject of the messages, all subjects if empty"
+             " to = Name of the receiver object, only messages to all objects if empty");
+static PyObject *gPyGetMessages(PyObject *, PyObject *args)
+{
+  char *subject = (char *)"";
+  char *to = (char *)"";
+
+  if (!PyArg_ParseTuple(args, "|ss:getMessages", &subject, &to))
+    return nullptr;
+
+  KX_Scene *scene = KX_GetActiveScene();
+  const KX_NetworkMessageManager::MessageView messages =
+      scene->GetNetworkMessageScene()->FindMessages(to, subject);
+
+  return (new KX_NetworkMessageList(messages))->NewProxy(true);
+}
+
+PyDoc_STRVAR(gPyNetStart_doc,
+             "netStart([port, rate, host])\n"
+             "starts the network replication and returns the bound port"
+             " port = The local UDP port, any available port if 0"
+             " rate = The number of snapshots sent per second"
+             " host = The local IPv4 address to bind, the loopback address by default");
+static PyObject *gPyNetStart(PyObject *, PyObject *args)
+{
+  int port = 0;
+  double rate = 20.0;
+  const char *host = "127.0.0.1";
+
+  if (!PyArg_ParseTuple(args, "|ids:netStart", &port, &rate, &host))
+    return nullptr;
+
+  if (port < 0 || port > 65535 || rate <= 0.0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "netStart([port, rate, host]): expected a port in [0, 65535] and a positive "
+                    "rate");
+    return nullptr;
+  }
+
+  KX_NetworkReplication *replication = KX_GetActiveEngine()->GetNetworkReplication();
+  std::string error;
+  if (!replication->Start(host, port, rate, error)) {
+    PyErr_Format(PyExc_RuntimeError, "netStart([port, rate, host]): %s", error.c_str());
+    return nullptr;
+  }
+
+  return PyLong_FromLong(replication->GetPort());
+}
+
+PyDoc_STRVAR(gPyNetStop_doc,
+             "netStop()\n"
+             "stops the network replication and disconnects all the peers");
+static PyObject *gPyNetStop(PyObject *)
+{
+  KX_GetActiveEngine()->GetNetworkReplication()->Stop();
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyNetConnect_doc,
+             "netConnect(host, port)\n"
+             "adds a peer to replicate with"
+             " host = The peer host name or IPv4 address"
+             " port = The peer UDP port");
+static PyObject *gPyNetConnect(PyObject *, PyObject *args)
+{
+  char *host;
+  int port;
+
+  if (!PyArg_ParseTuple(args, "si:netConnect", &host, &port))
+    return nullptr;
+
+  KX_NetworkReplication *replication = KX_GetActiveEngine()->GetNetworkReplication();
+  if (!replication->IsStarted()) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "netConnect(host, port): the network is not started, use netStart first");
+    return nullptr;
+  }
+
+  if (port <= 0 || port > 65535 || !replication->Connect(host, port)) {
+    PyErr_Format(PyExc_ValueError, "netConnect(host, port): invalid address %s:%i", host, port);
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyNetGetPeers_doc,
+             "netGetPeers()\n"
+             "returns the addresses of the connected peers");
+static PyObject *gPyNetGetPeers(PyObject *)
+{
+  const std::vector<std::string> peers = KX_GetActiveEngine()->GetNetworkReplication()->GetPeers();
+
+  PyObject *list = PyList_New(peers.size());
+  for (unsigned int i = 0, size = peers.size(); i < size; ++i) {
+    PyList_SET_ITEM(list, i, PyUnicode_FromStdString(peers[i]));
+  }
+  return list;
+}
+
+PyDoc_STRVAR(gPyNetSendMessage_doc,
+             "netSendMessage(subject, [body, to])\n"
+             "sends a message to the message sensors of all the peers"
+             " subject = Subject of the message"
+             " body = Message body"
+             " to = Name of object to send the message to");
+static PyObject *gPyNetSendMessage(PyObject *, PyObject *args)
+{
+  char *subject = (char *)"";
+  char *body = (char *)"";
+  char *to = (char *)"";
+
+  if (!PyArg_ParseTuple(args, "s|ss:netSendMessage", &subject, &body, &to))
+    return nullptr;
+
+  KX_GetActiveEngine()->GetNetworkReplication()->SendRemoteMessage(to, subject, body);
+
+  Py_RETURN_NONE;
+}
+
 // this gets a pointer to an array filled with floats
 static PyObject *gPyGetSpectrum(PyObject *)
 {
@@ -446,6 +677,22 @@ static PyObject *gPySetUseExternalClock(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *gPyGetUseParallelScenes(PyObject *)
+{
+  return PyBool_FromLong(KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::PARALLEL_SCENES));
+}
+
+static PyObject *gPySetUseParallelScenes(PyObject *, PyObject *args)
+{
+  int useParallelScenes;
+
+  if (!PyArg_ParseTuple(args, "p:setUseParallelScenes", &useParallelScenes))
+    return nullptr;
+
+  KX_GetActiveEngine()->SetFlag(KX_KetsjiEngine::PARALLEL_SCENES, (bool)useParallelScenes);
+  Py_RETURN_NONE;
+}
+
 static PyObject *gPyGetClockTime(PyObject *)
 {
   return PyFloat_FromDouble(KX_GetActiveEngine()->GetClockTime());
@@ -757,6 +1004,27 @@ static PyObject *gLibList(PyObject *, PyObject *args)
   return list;
 }
 
+static PyObject *gLibSetMergeBudget(PyObject *, PyObject *args)
+{
+  float budget;
+  if (!PyArg_ParseTuple(args, "f:setLibLoadMergeBudget", &budget))
+    return nullptr;
+
+  if (budget < 0.0f) {
+    PyErr_SetString(PyExc_ValueError,
+                    "setLibLoadMergeBudget(ms): expected a positive budget or 0 for no limit");
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->GetConverter()->SetMergeBudget(budget / 1000.0);
+  Py_RETURN_NONE;
+}
+
+static PyObject *gLibGetMergeBudget(PyObject *)
+{
+  return PyFloat_FromDouble(KX_GetActiveEngine()->GetConverter()->GetMergeBudget() * 1000.0);
+}
+
 struct PyNextFrameState pynextframestate;
 static PyObject *gPyNextFrame(PyObject *)
 {
@@ -789,6 +1057,15 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)gPyLoadGlobalDict_doc},
     {"sendMessage", (PyCFunction)gPySendMessage, METH_VARARGS, (const char *)gPySendMessage_doc},
+    {"getMessages", (PyCFunction)gPyGetMessages, METH_VARARGS, (const char *)gPyGetMessages_doc},
+    {"netStart", (PyCFunction)gPyNetStart, METH_VARARGS, (const char *)gPyNetStart_doc},
+    {"netStop", (PyCFunction)gPyNetStop, METH_NOARGS, (const char *)gPyNetStop_doc},
+    {"netConnect", (PyCFunction)gPyNetConnect, METH_VARARGS, (const char *)gPyNetConnect_doc},
+    {"netGetPeers", (PyCFunction)gPyNetGetPeers, METH_NOARGS, (const char *)gPyNetGetPeers_doc},
+    {"netSendMessage",
+     (PyCFunction)gPyNetSendMessage,
+     METH_VARARGS,
+     (const char *)gPyNetSendMessage_doc},
     {"getCurrentController",
      (PyCFunction)SCA_PythonController::sPyGetCurrentController,
      METH_NOARGS,
@@ -861,6 +1138,14 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPySetUseExternalClock,
      METH_VARARGS,
      (const char *)"Set if we use the time provided by an external clock"},
+    {"getUseParallelScenes",
+     (PyCFunction)gPyGetUseParallelScenes,
+     METH_NOARGS,
+     (const char *)"Get if the physics of the scenes are proceeded in parallel"},
+    {"setUseParallelScenes",
+     (PyCFunction)gPySetUseParallelScenes,
+     METH_VARARGS,
+     (const char *)"Set if the physics of the scenes are proceeded in parallel"},
     {"getClockTime",
      (PyCFunction)gPyGetClockTime,
      METH_NOARGS,
@@ -917,11 +1202,24 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)"Render next frame (if Python has control)"},
     {"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+    {"setPythonProfiling",
+     (PyCFunction)gPySetPythonProfiling,
+     METH_VARARGS,
+     (const char *)gPySetPythonProfiling_doc},
+    {"getPythonProfileInfo",
+     (PyCFunction)gPyGetPythonProfileInfo,
+     METH_VARARGS,
+     (const char *)gPyGetPythonProfileInfo_doc},
+    {"startTrace", (PyCFunction)gPyStartTrace, METH_VARARGS, (const char *)gPyStartTrace_doc},
+    {"stopTrace", (PyCFunction)gPyStopTrace, METH_NOARGS, (const char *)gPyStopTrace_doc},
+    {"dumpTrace", (PyCFunction)gPyDumpTrace, METH_VARARGS, (const char *)gPyDumpTrace_doc},
     /* library functions */
     {"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS | METH_KEYWORDS, (const char *)""},
     {"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
     {"LibFree", (PyCFunction)gLibFree, METH_VARARGS, (const char *)""},
     {"LibList", (PyCFunction)gLibList, METH_VARARGS, (const char *)""},
+    {"setLibLoadMergeBudget", (PyCFunction)gLibSetMergeBudget, METH_VARARGS, (const char *)""},
+    {"getLibLoadMergeBudget", (PyCFunction)gLibGetMergeBudget, METH_NOARGS, (const char *)""},
 
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
 
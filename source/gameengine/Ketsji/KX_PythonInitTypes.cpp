@@ -57,6 +57,7 @@
 #  include "KX_LodManager.h"
 #  include "KX_MeshProxy.h"
 #  include "KX_NavMeshObject.h"
+#  include "KX_NetworkMessageList.h"
 #  include "KX_PolyProxy.h"
 #  include "KX_PythonComponent.h"
 #  include "KX_VehicleWrapper.h"
@@ -256,6 +257,7 @@ PyMODINIT_FUNC initGameTypesPythonBinding(void)
     PyType_Ready_Attr(dict, SCA_ReplaceMeshActuator, init_getset);
     PyType_Ready_Attr(dict, KX_Scene, init_getset);
     PyType_Ready_Attr(dict, KX_NavMeshObject, init_getset);
+    PyType_Ready_Attr(dict, KX_NetworkMessageList, init_getset);
     PyType_Ready_Attr(dict, SCA_SceneActuator, init_getset);
     PyType_Ready_Attr(dict, SCA_SoundActuator, init_getset);
     PyType_Ready_Attr(dict, SCA_StateActuator, init_getset);
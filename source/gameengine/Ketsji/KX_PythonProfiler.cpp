@@ -0,0 +1,80 @@
+/** \file gameengine/Ketsji/KX_PythonProfiler.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_PythonProfiler.h"
+
+#include <algorithm>
+
+KX_PythonProfiler::Scope::Scope(KX_PythonProfiler *profiler, const char *name)
+    : m_profiler(profiler->m_enabled ? profiler : nullptr), m_name(name), m_begin(0.0)
+{
+  if (m_profiler) {
+    m_begin = m_profiler->m_clock.GetTimeSecond();
+  }
+}
+
+KX_PythonProfiler::Scope::~Scope()
+{
+  // The measure is dropped if the script disabled the profiling meanwhile.
+  if (m_profiler && m_profiler->m_enabled) {
+    m_profiler->AddTime(m_name, m_profiler->m_clock.GetTimeSecond() - m_begin);
+  }
+}
+
+KX_PythonProfiler::KX_PythonProfiler(const CM_Clock &clock) : m_clock(clock), m_enabled(false)
+{
+}
+
+KX_PythonProfiler::~KX_PythonProfiler()
+{
+}
+
+bool KX_PythonProfiler::GetEnabled() const
+{
+  return m_enabled;
+}
+
+void KX_PythonProfiler::SetEnabled(bool enabled)
+{
+  if (enabled && !m_enabled) {
+    Clear();
+  }
+  m_enabled = enabled;
+}
+
+void KX_PythonProfiler::Clear()
+{
+  m_indices.clear();
+  m_entries.clear();
+}
+
+void KX_PythonProfiler::AddTime(const std::string &name, double time)
+{
+  const auto it = m_indices.find(name);
+  if (it == m_indices.end()) {
+    m_indices.emplace(name, m_entries.size());
+    m_entries.push_back({name, 1, time, time});
+    return;
+  }
+
+  Entry &entry = m_entries[it->second];
+  ++entry.m_calls;
+  entry.m_totalTime += time;
+  entry.m_maxTime = std::max(entry.m_maxTime, time);
+}
+
+std::vector<KX_PythonProfiler::Entry> KX_PythonProfiler::GetEntries(unsigned int maxEntries) const
+{
+  std::vector<Entry> entries = m_entries;
+  const unsigned int size = (maxEntries == 0) ? entries.size() :
+                                                std::min<unsigned int>(maxEntries, entries.size());
+
+  std::partial_sort(entries.begin(),
+                    entries.begin() + size,
+                    entries.end(),
+                    [](const Entry &a, const Entry &b) { return a.m_totalTime > b.m_totalTime; });
+  entries.resize(size);
+
+  return entries;
+}
@@ -0,0 +1,63 @@
+/** \file KX_PythonProfiler.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CM_Clock.h"
+
+/** Measures the time spent in each Python component class and each Python controller script
+ * or module function, to find the scripts responsible of the slow frames.
+ * The profiling is disabled by default, a disabled profiler only costs a test per script call.
+ */
+class KX_PythonProfiler {
+ public:
+  struct Entry {
+    /// Component class name or controller script name.
+    std::string m_name;
+    unsigned int m_calls;
+    /// Cumulative time in seconds.
+    double m_totalTime;
+    /// Longest call time in seconds.
+    double m_maxTime;
+  };
+
+  /// Measure the time from the construction to the destruction when the profiler is enabled.
+  class Scope {
+   private:
+    KX_PythonProfiler *m_profiler;
+    const char *m_name;
+    double m_begin;
+
+   public:
+    Scope(KX_PythonProfiler *profiler, const char *name);
+    ~Scope();
+  };
+
+ private:
+  const CM_Clock &m_clock;
+  bool m_enabled;
+  /// Index of the entry of each name.
+  std::unordered_map<std::string, unsigned int> m_indices;
+  std::vector<Entry> m_entries;
+
+ public:
+  KX_PythonProfiler(const CM_Clock &clock);
+  ~KX_PythonProfiler();
+
+  bool GetEnabled() const;
+  /// Enable or disable the profiling, enabling clears the previous measures.
+  void SetEnabled(bool enabled);
+  void Clear();
+
+  void AddTime(const std::string &name, double time);
+
+  /** Get the entries sorted by decreasing cumulative time.
+   * \param maxEntries The number of entries returned, all of them if 0.
+   */
+  std::vector<Entry> GetEntries(unsigned int maxEntries) const;
+};
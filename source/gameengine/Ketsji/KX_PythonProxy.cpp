@@ -27,6 +27,8 @@
 #include "BKE_python_proxy.hh"
 #include "CM_Message.h"
 #include "DNA_python_proxy_types.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 KX_PythonProxy::KX_PythonProxy()
     : EXP_Value(),
@@ -99,8 +101,17 @@ void KX_PythonProxy::Update()
 
   if (m_init) {
 #ifdef WITH_PYTHON
-    if (m_update && !PyObject_CallNoArgs(m_update) && PyErr_Occurred()) {
-      LogError("Failed to invoke the update callback.");
+    if (m_update) {
+      /* Measured by the Python class name to group the components of the same class, the name
+       * is only looked up when the profiler is enabled. */
+      KX_PythonProfiler *profiler = KX_GetActiveEngine()->GetPythonProfiler();
+      const char *name = profiler->GetEnabled() ?
+                             Py_TYPE(EXP_PROXY_FROM_REF_BORROW(this))->tp_name :
+                             nullptr;
+      KX_PythonProfiler::Scope profile(profiler, name);
+      if (!PyObject_CallNoArgs(m_update) && PyErr_Occurred()) {
+        LogError("Failed to invoke the update callback.");
+      }
     }
 #endif
   }
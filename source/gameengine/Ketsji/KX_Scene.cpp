@@ -36,6 +36,8 @@
 
 #include "KX_Scene.h"
 
+#include <algorithm>
+
 #include "BKE_duplilist.hh"
 #include "BKE_layer.hh"
 #include "BKE_lib_id.hh"
@@ -46,10 +48,13 @@
 #include "BKE_screen.hh"
 #include "BLI_math_matrix.h"
 #include "BLI_task.h"
+#include "BLI_time.h"
+#include "BLI_utildefines.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_camera_types.h"
 #include "DNA_collection_types.h"
 #include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
 #include "DNA_property_types.h"
 #include "DNA_rigidbody_types.h"
 #include "DRW_render.hh"
@@ -65,17 +70,20 @@
 #include "wm_event_system.hh"
 #include "xr/wm_xr.hh"
 
+#include "BL_ArmatureObject.h"
 #include "BL_Converter.h"
 #include "BL_DataConversion.h"
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
 #include "EXP_FloatValue.h"
+#include "EXP_IntValue.h"
 #include "KX_2DFilterManager.h"
 #include "KX_BlenderCanvas.h"
 #include "KX_Camera.h"
 #include "KX_CollisionEventManager.h"
 #include "KX_FontObject.h"
 #include "KX_Globals.h"
+#include "KX_InstanceBuffer.h"
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
@@ -95,6 +103,7 @@
 #include "SCA_MouseManager.h"
 #include "SCA_TimeEventManager.h"
 #include "SG_Controller.h"
+#include "SG_TransformStore.h"
 
 #ifdef WITH_PYTHON
 #  include "EXP_PythonCallBack.h"
@@ -129,11 +138,30 @@ bool KX_Scene::KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *s
   return node->Reschedule(((KX_Scene *)scene)->m_sghead);
 }
 
+void KX_Scene::KX_ScenegraphDirtyFunc(SG_Node *node,
+                                      void *gameobj,
+                                      void *scene,
+                                      unsigned int flags)
+{
+  // Nodes without game object (e.g parent inverse nodes) are not rendered.
+  if (!gameobj) {
+    return;
+  }
+
+  if (flags & SG_Node::DIRTY_RENDER) {
+    ((KX_Scene *)scene)->AddDirtyRenderObject((KX_GameObject *)gameobj);
+  }
+  if (flags & SG_Node::DIRTY_ACTIVITY) {
+    ((KX_Scene *)scene)->AddActivityObject((KX_GameObject *)gameobj);
+  }
+}
+
 SG_Callbacks KX_Scene::m_callbacks = SG_Callbacks(KX_SceneReplicationFunc,
                                                   KX_SceneDestructionFunc,
                                                   KX_GameObject::UpdateTransformFunc,
                                                   KX_Scene::KX_ScenegraphUpdateFunc,
-                                                  KX_Scene::KX_ScenegraphRescheduleFunc);
+                                                  KX_Scene::KX_ScenegraphRescheduleFunc,
+                                                  KX_Scene::KX_ScenegraphDirtyFunc);
 
 KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
                    const std::string &sceneName,
@@ -148,6 +176,8 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_sceneConverter(nullptr),              // eevee
       m_isPythonMainLoop(false),              // eevee
       m_collectionRemap(false),               // eevee (to uncheck viewport restrictflag)
+      m_objectPoolSize(64),                   // eevee
+      m_replicatePooled(false),               // eevee
       m_keyboardmgr(nullptr),
       m_mousemgr(nullptr),
       m_physicsEnvironment(0),
@@ -164,6 +194,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activityCulling = false;
+  m_parallelSceneGraph = (scene->gm.flag & GAME_USE_PARALLEL_SCENEGRAPH) != 0;
   m_objectlist = new EXP_ListValue<KX_GameObject>();
   m_parentlist = new EXP_ListValue<KX_GameObject>();
   m_lightlist = new EXP_ListValue<KX_LightObject>();
@@ -212,6 +243,13 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 
   m_animationPool = BLI_task_pool_create(&m_animationPoolData, TASK_PRIORITY_LOW);
 
+  if (scene->gm.flag & GAME_USE_TRANSFORM_STORE) {
+    m_transformStore = new SG_TransformStore();
+  }
+  else {
+    m_transformStore = nullptr;
+  }
+
 #ifdef WITH_PYTHON
   m_attr_dict = nullptr;
   m_removeCallbacks = nullptr;
@@ -386,6 +424,13 @@ KX_Scene::~KX_Scene()
     BKE_view_layer_synced_ensure(scene, BKE_view_layer_default_view(scene));
   }
 
+  FreeObjectPools(false);
+  FreeInstanceBuffers(false);
+
+  if (m_transformStore) {
+    delete m_transformStore;
+  }
+
   if (m_obstacleSimulation)
     delete m_obstacleSimulation;
 
@@ -730,12 +775,25 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
   }
 
   /* Notify the depsgraph if object transform changed in the scene
-   * for next drawing loop. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    /* Update compatibles blender physics simulations */
-    Object *ob = gameobj->GetBlenderObject();
-    TagBlenderPhysicsObject(scene, ob);
-    gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
+   * for next drawing loop. Only the objects moved since the last frame
+   * and the always updated objects (animated or synchronized from blender)
+   * are visited, except when blender physics simulations are interacting
+   * as they can move any object. */
+  const bool tagBlenderPhysics = scene->gm.flag & (GAME_USE_INTERACTIVE_DYNAPAINT |
+                                                   GAME_USE_INTERACTIVE_RIGIDBODY);
+  const std::vector<KX_GameObject *> dirtyObjects = GetDirtyRenderObjects(is_last_render_pass);
+  if (tagBlenderPhysics) {
+    for (KX_GameObject *gameobj : GetObjectList()) {
+      /* Update compatibles blender physics simulations */
+      Object *ob = gameobj->GetBlenderObject();
+      TagBlenderPhysicsObject(scene, ob);
+      gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
+    }
+  }
+  else {
+    for (KX_GameObject *gameobj : dirtyObjects) {
+      gameobj->TagForTransformUpdate(is_overlay_pass, is_last_render_pass);
+    }
   }
 
   /* Notify depsgraph for other changes */
@@ -745,12 +803,24 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam,
     m_idsToUpdateInAllRenderPasses.clear();
   }
 
+  /* Write the instanced replicas transforms in the points of their instancers. */
+  for (const std::pair<Object *const, KX_InstanceBuffer *> &pair : m_instanceBuffers) {
+    pair.second->Update();
+  }
+
   /* We need the changes to be flushed before each draw loop! */
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
   /* Update evaluated object object_to_world according to SceneGraph. */
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->TagForTransformUpdateEvaluated();
+  if (tagBlenderPhysics) {
+    for (KX_GameObject *gameobj : GetObjectList()) {
+      gameobj->TagForTransformUpdateEvaluated();
+    }
+  }
+  else {
+    for (KX_GameObject *gameobj : dirtyObjects) {
+      gameobj->TagForTransformUpdateEvaluated();
+    }
   }
 
   engine->EndCountDepsgraphTime();
@@ -1212,6 +1282,166 @@ void KX_Scene::TagForCollectionRemap()
   m_collectionRemap = true;
 }
 
+bool KX_Scene::IsReplicatingPooled() const
+{
+  return m_replicatePooled;
+}
+
+Object *KX_Scene::AcquirePooledObject(Object *ob)
+{
+  // Create the pool entry now to let ReleasePooledObject know the template is still valid.
+  std::vector<Object *> &pool = m_objectPools[ob];
+  if (pool.empty()) {
+    return nullptr;
+  }
+
+  Object *pooledob = pool.back();
+  pool.pop_back();
+  SetPooledObjectVisible(pooledob, true);
+
+  return pooledob;
+}
+
+bool KX_Scene::ReleasePooledObject(Object *ob, Object *pooledob)
+{
+  std::map<Object *, std::vector<Object *>>::iterator it = m_objectPools.find(ob);
+  // The template was freed (LibFree) or the pool is full.
+  if (it == m_objectPools.end() || int(it->second.size()) >= m_objectPoolSize) {
+    return false;
+  }
+
+  // The object data was replaced while in use, the copy doesn't match its template anymore.
+  if (pooledob->data != ob->data) {
+    return false;
+  }
+
+  SetPooledObjectVisible(pooledob, false);
+  it->second.push_back(pooledob);
+
+  return true;
+}
+
+void KX_Scene::SetPooledObjectVisible(Object *pooledob, bool visible)
+{
+  Scene *scene = GetBlenderScene();
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+
+  BKE_view_layer_synced_ensure(scene, view_layer);
+  Base *base = BKE_view_layer_base_find(view_layer, pooledob);
+  if (!base) {
+    return;
+  }
+
+  /* Hide the base instead of the object to not modify the object data and only evaluate
+   * the flags of this base instead of syncing all the collections. The pooled objects
+   * share a single base flags update per frame. */
+  if (visible) {
+    base->flag &= ~BASE_HIDDEN;
+  }
+  else {
+    base->flag |= BASE_HIDDEN;
+  }
+  BKE_base_eval_flags(base);
+  BKE_scene_object_base_flag_sync_from_base(base);
+
+  AppendToIdsToUpdateInAllRenderPasses(&scene->id, ID_RECALC_BASE_FLAGS);
+}
+
+void KX_Scene::PrewarmObjectPool(Object *ob, int count)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = GetBlenderScene();
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+
+  std::vector<Object *> &pool = m_objectPools[ob];
+  count = std::min(count, m_objectPoolSize);
+  if (int(pool.size()) >= count) {
+    return;
+  }
+
+  const int first = pool.size();
+  while (int(pool.size()) < count) {
+    Object *newob;
+    BKE_id_copy_ex(bmain, &ob->id, (ID **)&newob, 0);
+    id_us_min(&newob->id);
+    // Same collection and visibility than in KX_GameObject::ReplicateBlenderObject.
+    BKE_collection_object_add_from(
+        bmain, scene, BKE_view_layer_camera_find(scene, view_layer), newob);
+    newob->visibility_flag &= ~OB_HIDE_VIEWPORT;
+    pool.push_back(newob);
+  }
+
+  // The bases of the copies are created by the collection sync, hide them once created.
+  for (int i = first; i < count; ++i) {
+    SetPooledObjectVisible(pool[i], false);
+  }
+
+  TagForCollectionRemap();
+  DEG_relations_tag_update(bmain);
+}
+
+KX_InstanceBuffer *KX_Scene::GetInstanceBuffer(Object *ob)
+{
+  KX_InstanceBuffer *&buffer = m_instanceBuffers[ob];
+  if (!buffer) {
+    buffer = new KX_InstanceBuffer(this, ob);
+  }
+  return buffer;
+}
+
+void KX_Scene::FreeInstanceBuffers(bool onlyTagged)
+{
+  for (std::map<Object *, KX_InstanceBuffer *>::iterator it = m_instanceBuffers.begin();
+       it != m_instanceBuffers.end();)
+  {
+    if (onlyTagged && !(it->first->id.tag & ID_TAG_DOIT)) {
+      ++it;
+      continue;
+    }
+
+    delete it->second;
+    it = m_instanceBuffers.erase(it);
+  }
+}
+
+void KX_Scene::FreeObjectPools(bool onlyTagged)
+{
+  bContext *C = KX_GetActiveEngine()->GetContext();
+  Main *bmain = CTX_data_main(C);
+  bool freed = false;
+
+  for (std::map<Object *, std::vector<Object *>>::iterator it = m_objectPools.begin();
+       it != m_objectPools.end();)
+  {
+    if (onlyTagged && !(it->first->id.tag & ID_TAG_DOIT)) {
+      ++it;
+      continue;
+    }
+
+    for (Object *pooledob : it->second) {
+      BKE_id_delete(bmain, pooledob);
+      freed = true;
+    }
+    it = m_objectPools.erase(it);
+  }
+
+  // The replicas in use must not return their blender object to a freed template.
+  if (onlyTagged) {
+    for (EXP_ListValue<KX_GameObject> *objects : {m_objectlist, m_inactivelist}) {
+      for (KX_GameObject *gameobj : objects) {
+        if (IS_TAGGED(gameobj->GetBlenderPoolTemplate())) {
+          gameobj->SetBlenderPoolTemplate(nullptr);
+        }
+      }
+    }
+  }
+
+  if (freed) {
+    DEG_relations_tag_update(bmain);
+  }
+}
+
 KX_GameObject *KX_Scene::GetGameObjectFromObject(Object *ob)
 {
   return m_sceneConverter->FindGameObject(ob);
@@ -1330,21 +1560,26 @@ bool KX_Scene::SomethingIsMoving()
 void KX_Scene::AppendToIdsToUpdateInAllRenderPasses(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  // Armature actions are updated in parallel.
+  m_idsToUpdateMutex.Lock();
   if (std::find(m_idsToUpdateInAllRenderPasses.begin(),
                 m_idsToUpdateInAllRenderPasses.end(),
                 it) == m_idsToUpdateInAllRenderPasses.end()) {
     m_idsToUpdateInAllRenderPasses.push_back(it);
   }
+  m_idsToUpdateMutex.Unlock();
 }
 
 void KX_Scene::AppendToIdsToUpdateInOverlayPass(ID *id, IDRecalcFlag flag)
 {
   std::pair<ID *, IDRecalcFlag> it = {id, flag};
+  m_idsToUpdateMutex.Lock();
   if (std::find(m_idsToUpdateInOverlayPass.begin(),
                 m_idsToUpdateInOverlayPass.end(),
                 it) == m_idsToUpdateInOverlayPass.end()) {
     m_idsToUpdateInOverlayPass.push_back(it);
   }
+  m_idsToUpdateMutex.Unlock();
 }
 
 void KX_Scene::TagForExtraIdsUpdate(Main *bmain, KX_Camera *cam)
@@ -1478,6 +1713,11 @@ std::string KX_Scene::GetName()
   return m_sceneName;
 }
 
+const std::string &KX_Scene::GetSceneName() const
+{
+  return m_sceneName;
+}
+
 /// Set the name of the value
 void KX_Scene::SetName(const std::string &name)
 {
@@ -1558,6 +1798,8 @@ const RAS_FrameSettings &KX_Scene::GetFramingType() const
 void KX_Scene::SetActivityCulling(bool b)
 {
   m_activityCulling = b;
+  // The moved objects were not recorded while disabled.
+  m_activityGrid.Invalidate();
 }
 
 void KX_Scene::AddObjectDebugProperties(class KX_GameObject *gameobj)
@@ -1647,6 +1889,10 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
 
   // this is the list of object that are send to the graphics pipeline
   m_objectlist->Add(CM_AddRef(newobj));
+  // The new hierarchy is appended to the store at the next scene graph update.
+  if (m_transformStore) {
+    m_transformStore->AddNode(replicanode);
+  }
   switch (newobj->GetGameObjectType()) {
     case SCA_IObject::OBJ_LIGHT: {
       m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(newobj)));
@@ -1666,6 +1912,11 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
     }
   }
 
+  Object *blenderobj = newobj->GetBlenderObject();
+  if (blenderobj && (blenderobj->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY)) {
+    AddAlwaysDirtyRenderObject(newobj);
+  }
+
   // logic cannot be replicated, until the whole hierarchy is replicated.
   m_logicHierarchicalGameObjects.push_back(newobj);
   // replicate controllers of this node
@@ -1804,6 +2055,11 @@ static void remap_parents_recursive(KX_GameObject *parent)
 {
   std::vector<KX_GameObject *>children = parent->GetChildren();
   for (KX_GameObject *child : children) {
+    // Instanced replicas share the template blender object.
+    if (child->GetInstanceBuffer() || parent->GetInstanceBuffer()) {
+      remap_parents_recursive(child);
+      continue;
+    }
     child->GetBlenderObject()->parent = parent->GetBlenderObject();
     if (parent->GetBlenderObject()->type == OB_ARMATURE) {
       ModifierData *mod;
@@ -1933,6 +2189,8 @@ void KX_Scene::DupliGroupRecurse(KX_GameObject *groupobj, int level)
     gameobj->Relink(m_map_gameobject_to_replica);
     // add the object in the layer of the parent
     gameobj->SetLayer(groupobj->GetLayer());
+    // The hierarchy is complete, the parents are known.
+    UpdateDepsgraphResetObject(gameobj);
   }
 
   // replicate crosslinks etc. between logic bricks
@@ -1977,7 +2235,8 @@ void KX_Scene::DupliGroupRecurse(KX_GameObject *groupobj, int level)
 
 KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
                                           KX_GameObject *referenceobject,
-                                          float lifespan)
+                                          float lifespan,
+                                          bool pooled)
 {
   m_logicHierarchicalGameObjects.clear();
   m_map_gameobject_to_replica.clear();
@@ -1988,8 +2247,10 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
 
   m_ueberExecutionPriority++;
 
-  // lets create a replica
+  // lets create a replica, the blender objects of the hierarchy are replicated in ProcessReplica
+  m_replicatePooled = pooled;
   KX_GameObject *replica = (KX_GameObject *)AddNodeReplicaObject(nullptr, originalobj);
+  m_replicatePooled = false;
 
   // add a timebomb to this object
   // lifespan of zero means 'this object lives forever'
@@ -2052,6 +2313,8 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
       // We don't know what layer set, so we set all visible layers in the blender scene.
       gameobj->SetLayer(m_blenderScene->lay);
     }
+    // The hierarchy is complete, the parents are known.
+    UpdateDepsgraphResetObject(gameobj);
   }
 
   // replicate crosslinks etc. between logic bricks
@@ -2183,6 +2446,11 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   m_proxyManager.Unregister(gameobj);
 
+  KX_InstanceBuffer *instanceBuffer = gameobj->GetInstanceBuffer();
+  if (instanceBuffer) {
+    instanceBuffer->RemoveObject(gameobj);
+  }
+
   gameobj->RemoveMeshes();
 
   bool ret = true;
@@ -2207,6 +2475,13 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   // WARNING: 'gameobj' maybe be freed now, only compare, don't access.
   CM_ListRemoveIfFound(m_animatedlist, gameobj);
+  m_dirtyRenderMutex.Lock();
+  CM_ListRemoveIfFound(m_dirtyRenderObjects, gameobj);
+  CM_ListRemoveIfFound(m_alwaysDirtyRenderObjects, gameobj);
+  CM_ListRemoveIfFound(m_depsgraphResetObjects, gameobj);
+  CM_ListRemoveIfFound(m_activityObjects, gameobj);
+  m_dirtyRenderMutex.Unlock();
+  m_activityGrid.RemoveObject(gameobj);
   CM_ListRemoveIfFound(m_euthanasyobjects, gameobj);
   CM_ListRemoveIfFound(m_tempObjectList, gameobj);
 
@@ -2382,70 +2657,158 @@ void KX_Scene::LogicBeginFrame(double curtime, double framestep)
 void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
 {
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
+  AddAlwaysDirtyRenderObject(gameobj);
 }
 
-// static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
-//{
-//  KX_GameObject *gameobj, *parent;
-//  bool needs_update;
-//  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData
-//  *)BLI_task_pool_user_data(pool); double curtime = data->curtime;
+void KX_Scene::AddDirtyRenderObject(KX_GameObject *gameobj)
+{
+  // The scene graph notifies only once per object until its render flag is cleared.
+  m_dirtyRenderMutex.Lock();
+  m_dirtyRenderObjects.push_back(gameobj);
+  m_dirtyRenderMutex.Unlock();
+}
+
+void KX_Scene::AddAlwaysDirtyRenderObject(KX_GameObject *gameobj)
+{
+  m_dirtyRenderMutex.Lock();
+  CM_ListAddIfNotFound(m_alwaysDirtyRenderObjects, gameobj);
+  m_dirtyRenderMutex.Unlock();
+}
+
+void KX_Scene::UpdateDepsgraphResetObject(KX_GameObject *gameobj)
+{
+  Object *ob = gameobj->GetBlenderObject();
+  if (!ob) {
+    return;
+  }
+
+  const bool reset = !OrigObCanBeTransformedInRealtime(ob) ||
+                     (ob->parent && !gameobj->GetSGNode()->GetSGParent());
+
+  m_dirtyRenderMutex.Lock();
+  if (reset) {
+    CM_ListAddIfNotFound(m_depsgraphResetObjects, gameobj);
+  }
+  else {
+    CM_ListRemoveIfFound(m_depsgraphResetObjects, gameobj);
+  }
+  m_dirtyRenderMutex.Unlock();
+}
 
-//  gameobj = (KX_GameObject *)taskdata;
+void KX_Scene::AddActivityObject(KX_GameObject *gameobj)
+{
+  if (!m_activityCulling) {
+    return;
+  }
 
-//  // Non-armature updates are fast enough, so just update them
-//  needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+  m_dirtyRenderMutex.Lock();
+  m_activityObjects.push_back(gameobj);
+  m_dirtyRenderMutex.Unlock();
+}
+
+std::vector<KX_GameObject *> KX_Scene::GetDirtyRenderObjects(bool is_last_render_pass)
+{
+  std::vector<KX_GameObject *> objects;
 
-//  if (!needs_update) {
-//    // If we got here, we're looking to update an armature, so check its children meshes
-//    // to see if we need to bother with a more expensive pose update
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
+  m_dirtyRenderMutex.Lock();
+  /* The render flag of the objects is cleared at the last render pass, the objects
+   * moving after are notified again and added to the new list. */
+  if (is_last_render_pass) {
+    objects.swap(m_dirtyRenderObjects);
+  }
+  else {
+    objects = m_dirtyRenderObjects;
+  }
+  // The dirty objects are already in the list, checked before their render flag is cleared.
+  for (KX_GameObject *gameobj : m_alwaysDirtyRenderObjects) {
+    if (!gameobj->GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER)) {
+      objects.push_back(gameobj);
+    }
+  }
+  for (KX_GameObject *gameobj : m_depsgraphResetObjects) {
+    if (!gameobj->GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER)) {
+      objects.push_back(gameobj);
+    }
+  }
+  m_dirtyRenderMutex.Unlock();
 
-//    bool has_mesh = false, has_non_mesh = false;
+  return objects;
+}
 
-//    // Check for meshes that haven't been culled
-//    for (KX_GameObject *child : children) {
-//      // if (!child->GetCulled()) { // eevee disable armature animation culling
-//      needs_update = true;
-//      break;
-//      //}
+/// Return true if the armature pose must be evaluated, false if only the actions time is needed.
+static bool armature_needs_pose_update(KX_GameObject *gameobj)
+{
+  const std::vector<KX_GameObject *> children = gameobj->GetChildren();
 
-//      if (child->GetMeshCount() == 0)
-//        has_non_mesh = true;
-//      else
-//        has_mesh = true;
-//    }
+  bool has_mesh = false;
+  for (KX_GameObject *child : children) {
+    // Non mesh children (e.g bone parented objects) rely on the pose.
+    if (child->GetMeshCount() == 0) {
+      return true;
+    }
+    // A visible mesh needs the deformation.
+    if (child->GetVisible()) {
+      return true;
+    }
+    has_mesh = true;
+  }
 
-//    // If we didn't find a non-culled mesh, check to see
-//    // if we even have any meshes, and update if this
-//    // armature has only non-mesh children.
-//    if (!needs_update && !has_mesh && has_non_mesh)
-//      needs_update = true;
-//  }
+  /* Without any mesh the pose could be used by something else than a deformation, python
+   * for example, only skip the armatures deforming invisible meshes. */
+  return !has_mesh;
+}
 
-//  // If the object is a culled armature, then we manage only the animation time and end of its
-//  // animations.
-//  gameobj->UpdateActionManager(curtime, needs_update);
+static void update_anim_thread_func(TaskPool *__restrict pool, void *taskdata)
+{
+  KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData *)BLI_task_pool_user_data(
+      pool);
+  KX_GameObject *gameobj = (KX_GameObject *)taskdata;
 
-//  if (needs_update) {
-//    const std::vector<KX_GameObject *> children = gameobj->GetChildren();
-//    parent = gameobj->GetParent();
-//  }
-//}
+  /* If the object is a culled armature, then we manage only the animation time and end of its
+   * animations. */
+  gameobj->UpdateActions(data->curtime, armature_needs_pose_update(gameobj));
+}
 
 void KX_Scene::UpdateAnimations(double curtime)
 {
-  // m_animationPoolData.curtime = curtime;
+  m_animationPoolData.curtime = curtime;
+
+  /* Armature poses are evaluated in parallel, each action working on the pose of its own
+   * armature. The other actions write in shared blender data (node trees, shape keys...) and
+   * are updated serially. */
+  std::vector<KX_GameObject *> armatures;
 
   for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    if (!gameobj->IsActionsSuspended()) {
+    if (gameobj->IsActionsSuspended()) {
+      continue;
+    }
+
+    if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+      // The pose channels hash is lazily created by lookups, create it before any thread.
+      static_cast<BL_ArmatureObject *>(gameobj)->EnsurePoseChannelsHash();
+      armatures.push_back(gameobj);
+    }
+    else {
       gameobj->UpdateActionManager(curtime, true);
     }
   }
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
+  if (armatures.size() > 1) {
+    for (KX_GameObject *gameobj : armatures) {
+      BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false, nullptr);
+    }
+    BLI_task_pool_work_and_wait(m_animationPool);
+  }
+  else {
+    for (KX_GameObject *gameobj : armatures) {
+      gameobj->UpdateActions(curtime, armature_needs_pose_update(gameobj));
+    }
+  }
+
+  // The scene graph update touches the children nodes, it's done after all the actions.
+  for (KX_GameObject *gameobj : armatures) {
+    gameobj->UpdateActionIPOs();
+  }
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
@@ -2486,8 +2849,25 @@ void KX_Scene::UpdateParents(double curtime)
   // we use the SG dynamic list
   SG_Node *node;
 
-  while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
-    node->UpdateWorldData(curtime);
+  if (m_transformStore) {
+    if (!m_transformStore->IsValid()) {
+      BuildTransformStore();
+    }
+    else {
+      m_transformStore->StorePending();
+    }
+  }
+
+  if (m_parallelSceneGraph) {
+    UpdateParentsParallel(curtime);
+  }
+  else if (m_transformStore) {
+    m_transformStore->Update(m_sghead, curtime);
+  }
+  else {
+    while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
+      node->UpdateWorldData(curtime);
+    }
   }
 
   // the list must be empty here
@@ -2498,6 +2878,90 @@ void KX_Scene::UpdateParents(double curtime)
   }
 }
 
+void KX_Scene::BuildTransformStore()
+{
+  std::vector<SG_Node *> roots;
+  for (KX_GameObject *gameobj : *m_objectlist) {
+    SG_Node *node = gameobj->GetSGNode();
+    if (node) {
+      roots.push_back(const_cast<SG_Node *>(node->GetRootSGParent()));
+    }
+  }
+
+  // The roots shared by several objects are stored once.
+  std::sort(roots.begin(), roots.end());
+  roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+
+  m_transformStore->Build(roots);
+}
+
+struct UpdateParentsData {
+  double time;
+  const NodeList *roots;
+  std::vector<NodeList> *updatedNodes;
+};
+
+static void update_parents_func(void *__restrict userdata,
+                                const int index,
+                                const TaskParallelTLS *__restrict /*tls*/)
+{
+  UpdateParentsData *data = (UpdateParentsData *)userdata;
+  (*data->roots)[index]->UpdateWorldDataDeferred(data->time, (*data->updatedNodes)[index]);
+}
+
+void KX_Scene::UpdateParentsParallel(double curtime)
+{
+  SG_Node *node;
+
+  // The controllers can schedule nodes during the update, they are updated in a next pass.
+  while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
+    m_updateRoots.clear();
+    do {
+      m_updateRoots.push_back(node);
+    } while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr);
+
+    m_scheduledNodes = m_updateRoots;
+    std::sort(m_scheduledNodes.begin(), m_scheduledNodes.end());
+
+    /* A node with a scheduled ancestor is updated with the subtree of this ancestor, the
+     * remaining subtrees are independent or locked by their family. */
+    const auto hasScheduledAncestor = [this](SG_Node *scheduled) {
+      for (SG_Node *parent = scheduled->GetSGParent(); parent; parent = parent->GetSGParent()) {
+        if (std::binary_search(m_scheduledNodes.begin(), m_scheduledNodes.end(), parent)) {
+          return true;
+        }
+      }
+      return false;
+    };
+    m_updateRoots.erase(
+        std::remove_if(m_updateRoots.begin(), m_updateRoots.end(), hasScheduledAncestor),
+        m_updateRoots.end());
+
+    const unsigned int numRoots = m_updateRoots.size();
+    if (m_updatedNodes.size() < numRoots) {
+      m_updatedNodes.resize(numRoots);
+    }
+    for (unsigned int i = 0; i < numRoots; ++i) {
+      m_updatedNodes[i].clear();
+    }
+
+    UpdateParentsData data = {curtime, &m_updateRoots, &m_updatedNodes};
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    // Most subtrees are a single node, avoid to schedule too small chunks.
+    settings.min_iter_per_thread = 32;
+
+    BLI_task_parallel_range(0, numRoots, &data, update_parents_func, &settings);
+
+    /* The update transform callbacks only synchronize the physics, they are called from this
+     * thread in the schedule order. */
+    for (unsigned int i = 0; i < numRoots; ++i) {
+      SG_Node::ActivateUpdateTransformCallbacks(m_updatedNodes[i]);
+    }
+  }
+}
+
 RAS_MaterialBucket *KX_Scene::FindBucket(class RAS_IPolyMaterial *polymat, bool &bucketCreated)
 {
   return m_bucketmanager->FindBucket(polymat, bucketCreated);
@@ -2539,6 +3003,19 @@ void KX_Scene::UpdateObjectActivity(void)
     return;
   }
 
+  std::vector<KX_GameObject *> movedObjects;
+  m_dirtyRenderMutex.Lock();
+  movedObjects.swap(m_activityObjects);
+  m_dirtyRenderMutex.Unlock();
+
+  // The scene graph notifies the moved objects again once their activity flag is cleared.
+  for (KX_GameObject *gameobj : movedObjects) {
+    SG_Node *node = gameobj->GetSGNode();
+    if (node) {
+      node->ClearDirty(SG_Node::DIRTY_ACTIVITY);
+    }
+  }
+
   std::vector<MT_Vector3> camPositions;
 
   for (KX_Camera *cam : m_cameralist) {
@@ -2549,25 +3026,12 @@ void KX_Scene::UpdateObjectActivity(void)
 
   // None cameras are using object activity culling?
   if (camPositions.size() == 0) {
+    // The moved objects are dropped, evaluate all objects when a camera is using culling again.
+    m_activityGrid.Invalidate();
     return;
   }
 
-  for (KX_GameObject *gameobj : m_objectlist) {
-    // If the object doesn't manage activity culling we don't compute distance.
-    if (gameobj->GetActivityCullingInfo().m_flags ==
-        KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
-      continue;
-    }
-
-    // For each camera compute the distance to objects and keep the minimum distance.
-    const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
-    float dist = FLT_MAX;
-    for (const MT_Vector3 &campos : camPositions) {
-      // Keep the minimum distance.
-      dist = min_ff((obpos - campos).length2(), dist);
-    }
-    gameobj->UpdateActivity(dist);
-  }
+  m_activityGrid.Update(camPositions, m_objectlist, movedObjects);
 }
 
 KX_NetworkMessageScene *KX_Scene::GetNetworkMessageScene()
@@ -2630,23 +3094,9 @@ static void MergeScene_LogicBrick(SCA_ILogicBrick *brick, KX_Scene *from, KX_Sce
   }
 }
 
-static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene *from)
+/// Move the physics controller and the scene graph of a merged object.
+static void MergeScene_PhysicsController(KX_GameObject *gameobj, KX_Scene *to, KX_Scene *from)
 {
-  SCA_ActuatorList &actuators = gameobj->GetActuators();
-  for (SCA_IActuator *actuator : actuators) {
-    MergeScene_LogicBrick(actuator, from, to);
-  }
-
-  SCA_SensorList &sensors = gameobj->GetSensors();
-  for (SCA_ISensor *sensor : sensors) {
-    MergeScene_LogicBrick(sensor, from, to);
-  }
-
-  SCA_ControllerList &controllers = gameobj->GetControllers();
-  for (SCA_IController *controller : controllers) {
-    MergeScene_LogicBrick(controller, from, to);
-  }
-
   /* graphics controller */
   PHY_IController *ctrl = gameobj->GetPhysicsController();
   if (ctrl) {
@@ -2666,12 +3116,31 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
       }
     }
   }
+}
 
-  // All armatures should be in the animated object list to be umpdated.
-  if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE)
-    to->AddAnimatedObject(gameobj);
+/// Move the logic bricks of a merged object, after its physics controller.
+static void MergeScene_LogicBricks(KX_GameObject *gameobj, KX_Scene *to, KX_Scene *from)
+{
+  SCA_ActuatorList &actuators = gameobj->GetActuators();
+  for (SCA_IActuator *actuator : actuators) {
+    MergeScene_LogicBrick(actuator, from, to);
+  }
 
-  /* Add the object to the scene's logic manager */
+  SCA_SensorList &sensors = gameobj->GetSensors();
+  for (SCA_ISensor *sensor : sensors) {
+    MergeScene_LogicBrick(sensor, from, to);
+  }
+
+  SCA_ControllerList &controllers = gameobj->GetControllers();
+  for (SCA_IController *controller : controllers) {
+    MergeScene_LogicBrick(controller, from, to);
+  }
+}
+
+/// Register the names of a merged object, the object is not yet in the scene lists.
+static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to)
+{
+  /* Add the object to the scene's logic manager */
   to->GetLogicManager()->RegisterGameObjectName(gameobj->GetName(), gameobj);
   to->GetLogicManager()->RegisterGameObj(gameobj->GetBlenderObject(), gameobj);
 
@@ -2683,54 +3152,208 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
   }
 }
 
+/// Register a merged object in the scene updates, done once the object is in the scene lists.
+static void MergeScene_UpdateGameObject(KX_GameObject *gameobj, KX_Scene *to)
+{
+  // All armatures should be in the animated object list to be umpdated.
+  if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE)
+    to->AddAnimatedObject(gameobj);
+
+  Object *blenderobj = gameobj->GetBlenderObject();
+  if (blenderobj && (blenderobj->transflag & OB_TRANSFLAG_OVERRIDE_GAME_PRIORITY)) {
+    to->AddAlwaysDirtyRenderObject(gameobj);
+  }
+  to->UpdateDepsgraphResetObject(gameobj);
+
+  // The object could be already dirty for render in the previous scene.
+  SG_Node *sg = gameobj->GetSGNode();
+  if (sg && sg->IsDirty(SG_Node::DIRTY_RENDER)) {
+    to->AddDirtyRenderObject(gameobj);
+  }
+
+  // Insert the object in the activity grid of the scene, moved or not.
+  to->AddActivityObject(gameobj);
+
+  // The merged hierarchies are appended to the store at the next scene graph update.
+  SG_TransformStore *transformStore = to->GetTransformStore();
+  if (transformStore && sg) {
+    transformStore->AddNode(sg);
+  }
+}
+
+KX_Scene::MergeState::MergeState() : m_stage(MERGE_BEGIN), m_index(0), m_success(true)
+{
+}
+
 bool KX_Scene::MergeScene(KX_Scene *other)
+{
+  MergeState state;
+  MergeSceneStep(other, state, 0.0);
+  return state.m_success;
+}
+
+bool KX_Scene::MergeSceneStep(KX_Scene *other, MergeState &state, double endTime)
 {
   PHY_IPhysicsEnvironment *env = this->GetPhysicsEnvironment();
   PHY_IPhysicsEnvironment *env_other = other->GetPhysicsEnvironment();
 
-  if ((env == nullptr) !=
-      (env_other == nullptr)) /* TODO - even when both scenes have NONE physics, the other is
-                                 loaded with bullet enabled, ??? */
-  {
-    CM_FunctionError("physics scenes type differ, aborting\n\tsource "
-                     << (int)(env != nullptr) << ", target " << (int)(env_other != nullptr));
-    return false;
-  }
+  // At least one object is merged per call to always progress.
+  const auto timeout = [endTime]() {
+    return (endTime > 0.0 && BLI_time_now_seconds() > endTime);
+  };
+
+  if (state.m_stage == MergeState::MERGE_BEGIN) {
+    if ((env == nullptr) !=
+        (env_other == nullptr)) /* TODO - even when both scenes have NONE physics, the other is
+                                   loaded with bullet enabled, ??? */
+    {
+      CM_FunctionError("physics scenes type differ, aborting\n\tsource "
+                       << (int)(env != nullptr) << ", target " << (int)(env_other != nullptr));
+      state.m_stage = MergeState::MERGE_FINISHED;
+      state.m_success = false;
+      return true;
+    }
 
-  GetBucketManager()->MergeBucketManager(other->GetBucketManager());
+    state.m_stage = MergeState::MERGE_OBJECTS;
+    state.m_index = 0;
+  }
 
   /* active + inactive == all ??? - lets hope so */
-  for (KX_GameObject *gameobj : *other->GetObjectList()) {
-    MergeScene_GameObject(gameobj, this, other);
+  if (state.m_stage == MergeState::MERGE_OBJECTS) {
+    EXP_ListValue<KX_GameObject> *objects = other->GetObjectList();
+    while (state.m_index < objects->GetCount()) {
+      KX_GameObject *gameobj = objects->GetValue(state.m_index++);
+      MergeScene_GameObject(gameobj, this);
+
+      /* add properties to debug list for LibLoad objects */
+      if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
+        AddObjectDebugProperties(gameobj);
+      }
 
-    /* add properties to debug list for LibLoad objects */
-    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
-      AddObjectDebugProperties(gameobj);
+      // The object stays inactive until it is added to the scene lists in the end stage.
+      if (!gameobj->IsLogicSuspended()) {
+        gameobj->SuspendLogic();
+        state.m_suspendedLogic.push_back(gameobj);
+      }
+
+      PHY_IPhysicsController *ctrl = gameobj->GetPhysicsController();
+      if (ctrl) {
+        state.m_physicsObjects.push_back(gameobj);
+        // The constraints are kept, they are restored with the controllers.
+        if (!ctrl->IsPhysicsSuspended()) {
+          ctrl->SuspendPhysics(false);
+          state.m_suspendedPhysics.push_back(gameobj);
+        }
+      }
+
+      if (timeout()) {
+        return false;
+      }
     }
+
+    state.m_stage = MergeState::MERGE_INACTIVE_OBJECTS;
+    state.m_index = 0;
   }
 
-  for (KX_GameObject *gameobj : *other->GetInactiveList()) {
-    MergeScene_GameObject(gameobj, this, other);
+  if (state.m_stage == MergeState::MERGE_INACTIVE_OBJECTS) {
+    EXP_ListValue<KX_GameObject> *objects = other->GetInactiveList();
+    while (state.m_index < objects->GetCount()) {
+      MergeScene_GameObject(objects->GetValue(state.m_index++), this);
+
+      if (timeout()) {
+        return false;
+      }
+    }
+
+    state.m_stage = MergeState::MERGE_BUCKETS;
   }
 
-  if (env) {
-    env->MergeEnvironment(env_other);
-    EXP_ListValue<KX_GameObject> *otherObjects = other->GetObjectList();
+  if (state.m_stage == MergeState::MERGE_BUCKETS) {
+    GetBucketManager()->MergeBucketManager(other->GetBucketManager());
 
-    // List of all physics objects to merge (needed by ReplicateConstraints).
-    std::vector<KX_GameObject *> physicsObjects;
-    for (KX_GameObject *gameobj : *otherObjects) {
-      if (gameobj->GetPhysicsController()) {
-        physicsObjects.push_back(gameobj);
+    state.m_stage = MergeState::MERGE_PHYSICS_CONTROLLERS;
+    state.m_index = 0;
+    if (timeout()) {
+      return false;
+    }
+  }
+
+  // The active objects followed by the inactive objects.
+  EXP_ListValue<KX_GameObject> *objects = other->GetObjectList();
+  EXP_ListValue<KX_GameObject> *inactiveObjects = other->GetInactiveList();
+  const unsigned int numObjects = objects->GetCount();
+  const unsigned int numAllObjects = numObjects + inactiveObjects->GetCount();
+  const auto objectAt = [objects, inactiveObjects, numObjects](unsigned int index) {
+    return (index < numObjects) ? objects->GetValue(index) :
+                                  inactiveObjects->GetValue(index - numObjects);
+  };
+
+  if (state.m_stage == MergeState::MERGE_PHYSICS_CONTROLLERS) {
+    while (state.m_index < numAllObjects) {
+      MergeScene_PhysicsController(objectAt(state.m_index++), this, other);
+
+      if (timeout()) {
+        return false;
       }
     }
 
-    for (unsigned int i = 0; i < physicsObjects.size(); ++i) {
-      KX_GameObject *gameobj = physicsObjects[i];
-      // Replicate all constraints in the right physics environment.
-      gameobj->GetPhysicsController()->ReplicateConstraints(gameobj, physicsObjects);
+    state.m_stage = MergeState::MERGE_LOGIC_BRICKS;
+    state.m_index = 0;
+  }
+
+  if (state.m_stage == MergeState::MERGE_LOGIC_BRICKS) {
+    while (state.m_index < numAllObjects) {
+      MergeScene_LogicBricks(objectAt(state.m_index++), this, other);
+
+      if (timeout()) {
+        return false;
+      }
+    }
+
+    state.m_stage = MergeState::MERGE_CONSTRAINTS;
+    state.m_index = 0;
+  }
+
+  if (state.m_stage == MergeState::MERGE_CONSTRAINTS) {
+    /* Replicate all constraints in the right physics environment, the constraints of the
+     * suspended controllers are added to the simulation when they are restored. */
+    while (env && state.m_index < state.m_physicsObjects.size()) {
+      KX_GameObject *gameobj = state.m_physicsObjects[state.m_index++];
+      gameobj->GetPhysicsController()->ReplicateConstraints(gameobj, state.m_physicsObjects);
       gameobj->ClearConstraints();
+
+      if (timeout()) {
+        return false;
+      }
+    }
+
+    state.m_stage = MergeState::MERGE_PHYSICS_ENVIRONMENT;
+  }
+
+  if (state.m_stage == MergeState::MERGE_PHYSICS_ENVIRONMENT) {
+    if (env) {
+      // Move the controllers not owned by a game object.
+      env->MergeEnvironment(env_other);
     }
+
+    state.m_stage = MergeState::MERGE_END;
+    if (timeout()) {
+      return false;
+    }
+  }
+
+  /* The objects are added to the scene lists and activated at once, an object rendered,
+   * simulated or running its logic in this scene must be in its lists. */
+
+  // The grids reference the moved objects.
+  m_activityGrid.Invalidate();
+  other->m_activityGrid.Invalidate();
+
+  for (KX_GameObject *gameobj : *other->GetObjectList()) {
+    MergeScene_UpdateGameObject(gameobj, this);
+  }
+  for (KX_GameObject *gameobj : *other->GetInactiveList()) {
+    MergeScene_UpdateGameObject(gameobj, this);
   }
 
   GetObjectList()->MergeList(other->GetObjectList());
@@ -2786,6 +3409,16 @@ bool KX_Scene::MergeScene(KX_Scene *other)
       timemgr->AddTimeProperty(times[i]);
     }
   }
+
+  // Activate the objects now in the scene lists.
+  for (KX_GameObject *gameobj : state.m_suspendedPhysics) {
+    gameobj->GetPhysicsController()->RestorePhysics();
+  }
+  for (KX_GameObject *gameobj : state.m_suspendedLogic) {
+    gameobj->ResumeLogic();
+  }
+
+  state.m_stage = MergeState::MERGE_FINISHED;
   return true;
 }
 
@@ -2880,7 +3513,7 @@ PyTypeObject KX_Scene::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Scene",
                                py_base_new};
 
 PyMethodDef KX_Scene::Methods[] = {
-    EXP_PYMETHODTABLE(KX_Scene, addObject),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, addObject),
     EXP_PYMETHODTABLE(KX_Scene, end),
     EXP_PYMETHODTABLE(KX_Scene, restart),
     EXP_PYMETHODTABLE(KX_Scene, replace),
@@ -2893,6 +3526,13 @@ PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, removeOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, getGameObjectFromObject),
+    EXP_PYMETHODTABLE(KX_Scene, prewarmObjectPool),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, rayCastBatch),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, getTransforms),
+    EXP_PYMETHODTABLE(KX_Scene, setTransforms),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, getWorldMatrices),
+    EXP_PYMETHODTABLE_KEYWORDS(KX_Scene, getProperties),
+    EXP_PYMETHODTABLE(KX_Scene, setProperties),
 
     /* dict style access */
     EXP_PYMETHODTABLE(KX_Scene, get),
@@ -3234,6 +3874,7 @@ PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
+    EXP_PYATTRIBUTE_INT_RW("objectPoolSize", 0, INT_MAX, true, KX_Scene, m_objectPoolSize),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
@@ -3243,7 +3884,7 @@ PyAttributeDef KX_Scene::Attributes[] = {
 
 EXP_PYMETHODDEF_DOC(KX_Scene,
                     addObject,
-                    "addObject(object, other, time=0, dupli=0)\n"
+                    "addObject(object, other, time=0, dupli=0, pooled=False)\n"
                     "Returns the added object.\n")
 {
   PyObject *pyob, *pyreference = Py_None;
@@ -3254,7 +3895,19 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   // Full duplication of ob->data
   int duplicate = 0;
 
-  if (!PyArg_ParseTuple(args, "O|Ofi:addObject", &pyob, &pyreference, &time, &duplicate))
+  // Reuse the blender objects of ended pooled replicas
+  int pooled = 0;
+
+  static const char *kwlist[] = {"object", "reference", "time", "dupli", "pooled", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "O|Ofii:addObject",
+                                   const_cast<char **>(kwlist),
+                                   &pyob,
+                                   &pyreference,
+                                   &time,
+                                   &duplicate,
+                                   &pooled))
     return nullptr;
 
   if (!ConvertPythonToGameObject(
@@ -3279,7 +3932,7 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
     return nullptr;
   }
   bool dupli = duplicate == 1;
-  KX_GameObject *replica = !dupli ? AddReplicaObject(ob, reference, time) :
+  KX_GameObject *replica = !dupli ? AddReplicaObject(ob, reference, time, pooled != 0) :
                                     AddDuplicaObject(ob, reference, time);
 
   /* Can happen when trying to Duplicate an instance_collection */
@@ -3587,6 +4240,684 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+static void prewarm_object_pool_recursive(KX_Scene *scene, SG_Node *node, int count)
+{
+  KX_GameObject *gameobj = static_cast<KX_GameObject *>(node->GetSGClientObject());
+  if (gameobj) {
+    Object *ob = gameobj->GetBlenderObject();
+    // Same condition than in KX_GameObject::ReplicateBlenderObject.
+    if (ob && !ob->instance_collection) {
+      scene->PrewarmObjectPool(ob, count);
+    }
+  }
+
+  for (SG_Node *child : node->GetSGChildren()) {
+    prewarm_object_pool_recursive(scene, child, count);
+  }
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    prewarmObjectPool,
+                    "prewarmObjectPool(object, count)\n"
+                    "Fill the pools of the object hierarchy used by addObject(pooled=True).\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int count;
+
+  if (!PyArg_ParseTuple(args, "Oi:prewarmObjectPool", &pyob, &count)) {
+    return nullptr;
+  }
+
+  if (!ConvertPythonToGameObject(
+          m_logicmgr, pyob, &ob, false, "scene.prewarmObjectPool(object, count): KX_Scene")) {
+    return nullptr;
+  }
+
+  if (!m_inactivelist->SearchValue(ob)) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.prewarmObjectPool(object, count): KX_Scene: object must be in an inactive "
+                 "layer");
+    return nullptr;
+  }
+
+  prewarm_object_pool_recursive(this, ob->GetSGNode(), count);
+
+  Py_RETURN_NONE;
+}
+
+/** Read the ray points from a float or double buffer (e.g. numpy array) of 3D coordinates, or
+ * from a sequence of vectors. */
+static bool ray_points_from_py(PyObject *value,
+                               std::vector<float> &points,
+                               const char *error_prefix)
+{
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(value, &buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+      return false;
+    }
+
+    // Skip the native byte order character.
+    const char *format = buffer.format ? buffer.format : "B";
+    if (ELEM(format[0], '@', '=', '<')) {
+      ++format;
+    }
+
+    const bool isFloat = STREQ(format, "f");
+    const bool isDouble = STREQ(format, "d");
+    const Py_ssize_t size = buffer.len / buffer.itemsize;
+    if ((!isFloat && !isDouble) || (size % 3) != 0) {
+      PyErr_Format(PyExc_ValueError,
+                   "%s, expected a buffer of float or double 3D coordinates",
+                   error_prefix);
+      PyBuffer_Release(&buffer);
+      return false;
+    }
+
+    points.resize(size);
+    if (isFloat) {
+      memcpy(points.data(), buffer.buf, size * sizeof(float));
+    }
+    else {
+      const double *data = (const double *)buffer.buf;
+      for (Py_ssize_t i = 0; i < size; ++i) {
+        points[i] = data[i];
+      }
+    }
+
+    PyBuffer_Release(&buffer);
+    return true;
+  }
+
+  PyObject *fast = PySequence_Fast(value, error_prefix);
+  if (!fast) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  PyObject **items = PySequence_Fast_ITEMS(fast);
+  points.resize(size * 3);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    MT_Vector3 point;
+    if (!PyVecTo(items[i], point)) {
+      Py_DECREF(fast);
+      return false;
+    }
+    point.getValue(&points[i * 3]);
+  }
+
+  Py_DECREF(fast);
+  return true;
+}
+
+/** Return a float memory view of shape (rows, columns), readable without copy by numpy.
+ * \return A new reference, or nullptr with an exception set.
+ */
+static PyObject *float_array_to_py(const std::vector<float> &values, int rows, int columns)
+{
+  PyObject *bytes = PyByteArray_FromStringAndSize((const char *)values.data(),
+                                                  values.size() * sizeof(float));
+  if (!bytes) {
+    return nullptr;
+  }
+
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (!view) {
+    return nullptr;
+  }
+
+  // A view can't be cast to a shape containing zero, no rows give an empty flat view.
+  PyObject *ret = (rows == 0) ?
+                      PyObject_CallMethod(view, "cast", "s", "f") :
+                      PyObject_CallMethod(view, "cast", "s(ii)", "f", rows, columns);
+  Py_DECREF(view);
+  return ret;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    rayCastBatch,
+                    "rayCastBatch(fromArray, toArray, mask)\n"
+                    "Cast a ray for each pair of points and return the tuple (objects, points, "
+                    "normals) of the closest hits.\n")
+{
+  PyObject *pyfrom;
+  PyObject *pyto;
+  int mask = (1u << OB_MAX_COL_MASKS) - 1;
+
+  static const char *kwlist[] = {"fromArray", "toArray", "mask", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "OO|i:rayCastBatch", const_cast<char **>(kwlist), &pyfrom, &pyto, &mask)) {
+    return nullptr;
+  }
+
+  if ((mask == 0) || (mask & ~((1u << OB_MAX_COL_MASKS) - 1))) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.rayCastBatch(fromArray, toArray, mask): KX_Scene, mask argument to "
+                 "rayCastBatch must be a int bitfield, 0 < mask < %i",
+                 (1 << OB_MAX_COL_MASKS));
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.rayCastBatch(fromArray, toArray, mask): KX_Scene";
+  std::vector<float> from;
+  std::vector<float> to;
+  if (!ray_points_from_py(pyfrom, from, error_prefix) ||
+      !ray_points_from_py(pyto, to, error_prefix)) {
+    return nullptr;
+  }
+
+  if (from.size() != to.size()) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(fromArray, toArray, mask): KX_Scene, fromArray and "
+                    "toArray must have the same number of points");
+    return nullptr;
+  }
+
+  const int numRays = from.size() / 3;
+  if (numRays == 0) {
+    // Nothing to cast, the points and normals are empty flat views.
+    PyObject *pypoints = float_array_to_py(from, 0, 3);
+    PyObject *pynormals = pypoints ? float_array_to_py(to, 0, 3) : nullptr;
+    if (!pynormals) {
+      Py_XDECREF(pypoints);
+      return nullptr;
+    }
+    return Py_BuildValue("(NNN)", PyList_New(0), pypoints, pynormals);
+  }
+
+  std::vector<PHY_RayCastResult> results(numRays);
+  if (m_physicsEnvironment) {
+    m_physicsEnvironment->RayTestBatch(from.data(), to.data(), numRays, mask, results.data());
+  }
+
+  PyObject *objects = PyList_New(numRays);
+  if (!objects) {
+    return nullptr;
+  }
+  std::vector<float> points(numRays * 3);
+  std::vector<float> normals(numRays * 3, 0.0f);
+
+  for (int i = 0; i < numRays; ++i) {
+    const PHY_RayCastResult &result = results[i];
+    KX_GameObject *gameobj = nullptr;
+    if (result.m_controller) {
+      KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+          result.m_controller->GetNewClientInfo());
+      gameobj = KX_GameObject::GetClientObject(info);
+    }
+    // The hit objects without game object (e.g being removed) are reported as no hit.
+
+    if (gameobj) {
+      PyList_SET_ITEM(objects, i, gameobj->GetProxy());
+      result.m_hitPoint.getValue(&points[i * 3]);
+      result.m_hitNormal.getValue(&normals[i * 3]);
+    }
+    else {
+      Py_INCREF(Py_None);
+      PyList_SET_ITEM(objects, i, Py_None);
+      // No hit, the point is the end of the ray.
+      memcpy(&points[i * 3], &to[i * 3], sizeof(float) * 3);
+    }
+  }
+
+  PyObject *pypoints = float_array_to_py(points, numRays, 3);
+  PyObject *pynormals = pypoints ? float_array_to_py(normals, numRays, 3) : nullptr;
+  if (!pynormals) {
+    Py_DECREF(objects);
+    Py_XDECREF(pypoints);
+    return nullptr;
+  }
+
+  // The references are stolen even on failure.
+  return Py_BuildValue("(NNN)", objects, pypoints, pynormals);
+}
+
+/// Number of floats per object in the transform arrays: the position then the orientation rows.
+static const int TRANSFORM_SIZE = 12;
+
+/// Read a sequence of game objects or object names.
+static bool game_objects_from_py(SCA_LogicManager *logicmgr,
+                                 PyObject *value,
+                                 std::vector<KX_GameObject *> &objects,
+                                 const char *error_prefix)
+{
+  PyObject *fast = PySequence_Fast(value, error_prefix);
+  if (!fast) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  PyObject **items = PySequence_Fast_ITEMS(fast);
+  objects.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (!ConvertPythonToGameObject(logicmgr, items[i], &objects[i], false, error_prefix)) {
+      Py_DECREF(fast);
+      return false;
+    }
+  }
+
+  Py_DECREF(fast);
+  return true;
+}
+
+/** Get a C contiguous buffer of float, double or signed integer numbers.
+ * \param writable True to get a buffer written by the function.
+ * \param allowInteger True to accept the signed integer formats.
+ * \param type The buffer item type: 'f', 'd', 'i' (32 bits integer) or 'q' (64 bits integer).
+ */
+static bool number_buffer_from_py(PyObject *value,
+                                  Py_buffer &buffer,
+                                  bool writable,
+                                  bool allowInteger,
+                                  char &type,
+                                  const char *error_prefix)
+{
+  const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+  if (!PyObject_CheckBuffer(value) || PyObject_GetBuffer(value, &buffer, flags) == -1) {
+    PyErr_Clear();
+    PyErr_Format(PyExc_TypeError,
+                 "%s, expected a contiguous%s buffer of numbers (e.g. numpy array)",
+                 error_prefix,
+                 writable ? " writable" : "");
+    return false;
+  }
+
+  // Skip the native byte order character.
+  const char *format = buffer.format ? buffer.format : "B";
+  if (ELEM(format[0], '@', '=', '<')) {
+    ++format;
+  }
+
+  if (STREQ(format, "f") || STREQ(format, "d")) {
+    type = format[0];
+    return true;
+  }
+  // The size of the signed integer formats depends on the platform.
+  if (allowInteger && ELEM(format[0], 'i', 'l', 'q') && format[1] == '\0' &&
+      ELEM(buffer.itemsize, sizeof(int32_t), sizeof(int64_t)))
+  {
+    type = (buffer.itemsize == sizeof(int32_t)) ? 'i' : 'q';
+    return true;
+  }
+
+  PyErr_Format(PyExc_ValueError,
+               "%s, expected a buffer of %s",
+               error_prefix,
+               allowInteger ? "float, double or integer numbers" : "float or double numbers");
+  PyBuffer_Release(&buffer);
+  return false;
+}
+
+/// Read the item of a buffer returned by number_buffer_from_py.
+static double number_buffer_get(const Py_buffer &buffer, char type, Py_ssize_t index)
+{
+  switch (type) {
+    case 'f':
+      return ((const float *)buffer.buf)[index];
+    case 'd':
+      return ((const double *)buffer.buf)[index];
+    case 'i':
+      return ((const int32_t *)buffer.buf)[index];
+    default:
+      return ((const int64_t *)buffer.buf)[index];
+  }
+}
+
+/** Write the floats computed for each object in a float or double buffer of the same size.
+ * \return The buffer with a new reference, or nullptr with an exception set.
+ */
+static PyObject *float_array_write_py(PyObject *pyout,
+                                      const std::vector<float> &values,
+                                      int columns,
+                                      const char *error_prefix)
+{
+  Py_buffer buffer;
+  char type;
+  if (!number_buffer_from_py(pyout, buffer, true, false, type, error_prefix)) {
+    return nullptr;
+  }
+
+  if (buffer.len / buffer.itemsize != (Py_ssize_t)values.size()) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s, out must contain %i numbers, %i per object",
+                 error_prefix,
+                 (int)values.size(),
+                 columns);
+    PyBuffer_Release(&buffer);
+    return nullptr;
+  }
+
+  if (type == 'f') {
+    memcpy(buffer.buf, values.data(), values.size() * sizeof(float));
+  }
+  else {
+    double *data = (double *)buffer.buf;
+    for (unsigned int i = 0, size = values.size(); i < size; ++i) {
+      data[i] = values[i];
+    }
+  }
+  PyBuffer_Release(&buffer);
+
+  Py_INCREF(pyout);
+  return pyout;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    getTransforms,
+                    "getTransforms(objects, out)\n"
+                    "Return the world position and orientation of the objects in a (n, 12) float "
+                    "array, or write them in out.\n")
+{
+  PyObject *pyobjects;
+  PyObject *pyout = Py_None;
+
+  static const char *kwlist[] = {"objects", "out", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|O:getTransforms", const_cast<char **>(kwlist), &pyobjects, &pyout)) {
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.getTransforms(objects, out): KX_Scene";
+  std::vector<KX_GameObject *> objects;
+  if (!game_objects_from_py(m_logicmgr, pyobjects, objects, error_prefix)) {
+    return nullptr;
+  }
+
+  const int numObjects = objects.size();
+  std::vector<float> transforms(numObjects * TRANSFORM_SIZE);
+  for (int i = 0; i < numObjects; ++i) {
+    KX_GameObject *gameobj = objects[i];
+    float *transform = &transforms[i * TRANSFORM_SIZE];
+    gameobj->NodeGetWorldPosition().getValue(transform);
+    const MT_Matrix3x3 &orientation = gameobj->NodeGetWorldOrientation();
+    for (unsigned short row = 0; row < 3; ++row) {
+      orientation[row].getValue(&transform[3 + row * 3]);
+    }
+  }
+
+  if (pyout == Py_None) {
+    return float_array_to_py(transforms, numObjects, TRANSFORM_SIZE);
+  }
+  return float_array_write_py(pyout, transforms, TRANSFORM_SIZE, error_prefix);
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    setTransforms,
+                    "setTransforms(objects, transforms)\n"
+                    "Set the world position and orientation of the objects from a (n, 12) array, "
+                    "or only the world position from a (n, 3) array.\n")
+{
+  PyObject *pyobjects;
+  PyObject *pytransforms;
+
+  if (!PyArg_ParseTuple(args, "OO:setTransforms", &pyobjects, &pytransforms)) {
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.setTransforms(objects, transforms): KX_Scene";
+  std::vector<KX_GameObject *> objects;
+  if (!game_objects_from_py(m_logicmgr, pyobjects, objects, error_prefix)) {
+    return nullptr;
+  }
+
+  Py_buffer buffer;
+  char type;
+  if (!number_buffer_from_py(pytransforms, buffer, false, false, type, error_prefix)) {
+    return nullptr;
+  }
+
+  const int numObjects = objects.size();
+  const Py_ssize_t size = buffer.len / buffer.itemsize;
+  int stride;
+  if (size == numObjects * TRANSFORM_SIZE) {
+    stride = TRANSFORM_SIZE;
+  }
+  else if (size == numObjects * 3) {
+    stride = 3;
+  }
+  else {
+    PyErr_Format(PyExc_ValueError,
+                 "%s, transforms must contain 12 or 3 numbers per object",
+                 error_prefix);
+    PyBuffer_Release(&buffer);
+    return nullptr;
+  }
+
+  float transform[TRANSFORM_SIZE];
+  for (int i = 0; i < numObjects; ++i) {
+    KX_GameObject *gameobj = objects[i];
+    for (int j = 0; j < stride; ++j) {
+      transform[j] = number_buffer_get(buffer, type, i * stride + j);
+    }
+
+    gameobj->NodeSetWorldPosition(MT_Vector3(transform));
+    if (stride == TRANSFORM_SIZE) {
+      gameobj->NodeSetGlobalOrientation(MT_Matrix3x3(transform[3],
+                                                     transform[4],
+                                                     transform[5],
+                                                     transform[6],
+                                                     transform[7],
+                                                     transform[8],
+                                                     transform[9],
+                                                     transform[10],
+                                                     transform[11]));
+    }
+    // Same as the attributes, the world transform is visible immediately to the next objects.
+    gameobj->NodeUpdateGS(0.0f);
+  }
+
+  PyBuffer_Release(&buffer);
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    getWorldMatrices,
+                    "getWorldMatrices(objects, out)\n"
+                    "Return the world matrices of the objects in a (n, 16) float array, each "
+                    "matrix stored by columns, or write them in out.\n")
+{
+  PyObject *pyobjects;
+  PyObject *pyout = Py_None;
+
+  static const char *kwlist[] = {"objects", "out", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "O|O:getWorldMatrices", const_cast<char **>(kwlist), &pyobjects, &pyout)) {
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.getWorldMatrices(objects, out): KX_Scene";
+  std::vector<KX_GameObject *> objects;
+  if (!game_objects_from_py(m_logicmgr, pyobjects, objects, error_prefix)) {
+    return nullptr;
+  }
+
+  // The matrices are copied from the transform store when the scene uses it.
+  const int numObjects = objects.size();
+  std::vector<float> matrices(numObjects * 16);
+  for (int i = 0; i < numObjects; ++i) {
+    float(*matrix)[4] = (float(*)[4])(&matrices[i * 16]);
+    objects[i]->NodeGetWorldMatrix(matrix);
+  }
+
+  if (pyout == Py_None) {
+    return float_array_to_py(matrices, numObjects, 16);
+  }
+  return float_array_write_py(pyout, matrices, 16, error_prefix);
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    getProperties,
+                    "getProperties(objects, name, out)\n"
+                    "Return the values of a game property of the objects, or write them as numbers "
+                    "in out.\n")
+{
+  PyObject *pyobjects;
+  const char *name;
+  PyObject *pyout = Py_None;
+
+  static const char *kwlist[] = {"objects", "name", "out", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   "Os|O:getProperties",
+                                   const_cast<char **>(kwlist),
+                                   &pyobjects,
+                                   &name,
+                                   &pyout))
+  {
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.getProperties(objects, name, out): KX_Scene";
+  std::vector<KX_GameObject *> objects;
+  if (!game_objects_from_py(m_logicmgr, pyobjects, objects, error_prefix)) {
+    return nullptr;
+  }
+
+  const std::string propname(name);
+  const int numObjects = objects.size();
+
+  if (pyout == Py_None) {
+    PyObject *list = PyList_New(numObjects);
+    for (int i = 0; i < numObjects; ++i) {
+      EXP_Value *prop = objects[i]->GetProperty(propname);
+      PyObject *item = prop ? prop->ConvertValueToPython() : nullptr;
+      if (!item) {
+        item = Py_None;
+        Py_INCREF(item);
+      }
+      PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+  }
+
+  Py_buffer buffer;
+  char type;
+  if (!number_buffer_from_py(pyout, buffer, true, false, type, error_prefix)) {
+    return nullptr;
+  }
+
+  if (buffer.len / buffer.itemsize != numObjects) {
+    PyErr_Format(PyExc_ValueError, "%s, out must contain one number per object", error_prefix);
+    PyBuffer_Release(&buffer);
+    return nullptr;
+  }
+
+  for (int i = 0; i < numObjects; ++i) {
+    // Objects without the property get NaN.
+    EXP_Value *prop = objects[i]->GetProperty(propname);
+    const double value = prop ? prop->GetNumber() : NAN;
+    if (type == 'f') {
+      ((float *)buffer.buf)[i] = value;
+    }
+    else {
+      ((double *)buffer.buf)[i] = value;
+    }
+  }
+  PyBuffer_Release(&buffer);
+
+  Py_INCREF(pyout);
+  return pyout;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    setProperties,
+                    "setProperties(objects, name, values)\n"
+                    "Set a game property of the objects from a sequence of values or a buffer of "
+                    "numbers.\n")
+{
+  PyObject *pyobjects;
+  const char *name;
+  PyObject *pyvalues;
+
+  if (!PyArg_ParseTuple(args, "OsO:setProperties", &pyobjects, &name, &pyvalues)) {
+    return nullptr;
+  }
+
+  const char *error_prefix = "scene.setProperties(objects, name, values): KX_Scene";
+  std::vector<KX_GameObject *> objects;
+  if (!game_objects_from_py(m_logicmgr, pyobjects, objects, error_prefix)) {
+    return nullptr;
+  }
+
+  const std::string propname(name);
+  const int numObjects = objects.size();
+
+  // Numbers are converted without Python objects.
+  if (PyObject_CheckBuffer(pyvalues)) {
+    Py_buffer buffer;
+    char type;
+    if (!number_buffer_from_py(pyvalues, buffer, false, true, type, error_prefix)) {
+      return nullptr;
+    }
+
+    if (buffer.len / buffer.itemsize != numObjects) {
+      PyErr_Format(
+          PyExc_ValueError, "%s, values must contain one number per object", error_prefix);
+      PyBuffer_Release(&buffer);
+      return nullptr;
+    }
+
+    const bool isFloat = ELEM(type, 'f', 'd');
+    for (int i = 0; i < numObjects; ++i) {
+      const double number = number_buffer_get(buffer, type, i);
+      EXP_Value *value = isFloat ? (EXP_Value *)new EXP_FloatValue(number) :
+                                   (EXP_Value *)new EXP_IntValue((cInt)number);
+      EXP_Value *prop = objects[i]->GetProperty(propname);
+      if (prop) {
+        prop->SetValue(value);
+      }
+      else {
+        objects[i]->SetProperty(propname, value);
+      }
+      value->Release();
+    }
+
+    PyBuffer_Release(&buffer);
+    Py_RETURN_NONE;
+  }
+
+  PyObject *fast = PySequence_Fast(pyvalues, error_prefix);
+  if (!fast) {
+    return nullptr;
+  }
+
+  if (PySequence_Fast_GET_SIZE(fast) != numObjects) {
+    PyErr_Format(PyExc_ValueError, "%s, values must contain one value per object", error_prefix);
+    Py_DECREF(fast);
+    return nullptr;
+  }
+
+  PyObject **items = PySequence_Fast_ITEMS(fast);
+  for (int i = 0; i < numObjects; ++i) {
+    // Same as gameOb[key] = value, the engine objects can't be properties.
+    if (PyObject_TypeCheck(items[i], &EXP_PyObjectPlus::Type)) {
+      PyErr_Format(PyExc_TypeError, "%s, values can't contain engine objects", error_prefix);
+      Py_DECREF(fast);
+      return nullptr;
+    }
+
+    EXP_Value *value = objects[i]->ConvertPythonToValue(items[i], true, error_prefix);
+    if (!value) {
+      Py_DECREF(fast);
+      return nullptr;
+    }
+
+    EXP_Value *prop = objects[i]->GetProperty(propname);
+    if (prop) {
+      prop->SetValue(value);
+    }
+    else {
+      objects[i]->SetProperty(propname, value);
+    }
+    value->Release();
+  }
+
+  Py_DECREF(fast);
+  Py_RETURN_NONE;
+}
+
 bool ConvertPythonToScene(PyObject *value,
                           KX_Scene **scene,
                           bool py_none_ok,
@@ -32,6 +32,7 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -39,6 +40,7 @@
 
 #include "EXP_PyObjectPlus.h"
 #include "EXP_Value.h"
+#include "KX_ActivityGrid.h"
 #include "KX_PhysicsEngineEnums.h"
 #include "KX_PythonProxy.h"
 #include "KX_PythonProxyManager.h"
@@ -67,9 +69,11 @@ class KX_NetworkMessageScene;
 class KX_NetworkMessageManager;
 class SG_Node;
 class SG_Node;
+class SG_TransformStore;
 class KX_Camera;
 class KX_FontObject;
 class KX_GameObject;
+class KX_InstanceBuffer;
 class KX_LightObject;
 class RAS_MeshObject;
 class RAS_BucketManager;
@@ -108,6 +112,39 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     double curtime;
   };
 
+  /** Progress of a scene merged over several calls to MergeSceneStep. The active objects are
+   * suspended in the first stage, their physics controllers, logic bricks and constraints are
+   * moved in the next stages while they are inactive, the end stage adds all the objects to the
+   * scene lists and resumes them at once.
+   */
+  struct MergeState {
+    enum Stage {
+      MERGE_BEGIN = 0,
+      MERGE_OBJECTS,
+      MERGE_INACTIVE_OBJECTS,
+      MERGE_BUCKETS,
+      MERGE_PHYSICS_CONTROLLERS,
+      MERGE_LOGIC_BRICKS,
+      MERGE_CONSTRAINTS,
+      MERGE_PHYSICS_ENVIRONMENT,
+      MERGE_END,
+      MERGE_FINISHED
+    };
+
+    Stage m_stage;
+    /// Index of the next object to merge in the current stage.
+    unsigned int m_index;
+    /// All physics objects to merge, needed by ReplicateConstraints.
+    std::vector<KX_GameObject *> m_physicsObjects;
+    /// Objects which logic or physics was suspended for the merge, resumed in the end stage.
+    std::vector<KX_GameObject *> m_suspendedLogic;
+    std::vector<KX_GameObject *> m_suspendedPhysics;
+    /// False if the scenes couldn't be merged.
+    bool m_success;
+
+    MergeState();
+  };
+
  private:
   Py_Header
 
@@ -147,6 +184,21 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInAllRenderPasses;
   std::vector<std::pair<ID *, IDRecalcFlag>> m_idsToUpdateInOverlayPass;
+  /// Protect the lists of ids to update filled by the parallel animation update.
+  CM_ThreadMutex m_idsToUpdateMutex;
+
+  /* Hidden replica blender objects per template object, reused by pooled AddReplicaObject
+   * to avoid an ID copy and a depsgraph relations update per spawned object. */
+  std::map<Object *, std::vector<Object *>> m_objectPools;
+  /// Maximum number of hidden objects kept in each pool.
+  int m_objectPoolSize;
+  /// True while AddReplicaObject replicates a pooled hierarchy.
+  bool m_replicatePooled;
+
+  /// Instance buffers of the templates using game instancing.
+  std::map<Object *, KX_InstanceBuffer *> m_instanceBuffers;
+  /// Contiguous world matrices of the nodes, nullptr if GAME_USE_TRANSFORM_STORE is unset.
+  SG_TransformStore *m_transformStore;
   /*************************************************/
 
   RAS_BucketManager *m_bucketmanager;
@@ -166,6 +218,24 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_ListValue<KX_GameObject> *m_inactivelist;  // all objects that are not in the active layer
   /// All animated objects, no need of EXP_ListValue because the list isn't exposed in python.
   std::vector<KX_GameObject *> m_animatedlist;
+  /** Objects which transform changed since the last render pass, used to notify the depsgraph
+   * without scanning all the objects. Filled by the scene graph which can run in several
+   * threads (asynchronous conversion) then protected by m_dirtyRenderMutex.
+   */
+  std::vector<KX_GameObject *> m_dirtyRenderObjects;
+  /** Objects visited at every render pass as their transform can change without moving their
+   * node: animated objects (armature poses, actions calling ForceIgnoreParentTx) and objects
+   * synchronized from blender (override_game_transform_priority). Protected by
+   * m_dirtyRenderMutex.
+   */
+  std::vector<KX_GameObject *> m_alwaysDirtyRenderObjects;
+  /** Objects visited at every render pass as the depsgraph resets their evaluated transform,
+   * see UpdateDepsgraphResetObject. Protected by m_dirtyRenderMutex.
+   */
+  std::vector<KX_GameObject *> m_depsgraphResetObjects;
+  /// Objects moved since the last activity culling update, protected by m_dirtyRenderMutex.
+  std::vector<KX_GameObject *> m_activityObjects;
+  CM_ThreadMutex m_dirtyRenderMutex;
 
   /// The set of cameras for this scene
   EXP_ListValue<KX_Camera> *m_cameralist;
@@ -176,6 +246,14 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
                       // the Dlist is not object that must be updated
                       // the Qlist is for objects that needs to be rescheduled
                       // for updates after udpate is over (slow parent, bone parent)
+  /// Update the scheduled subtrees on several threads, see GAME_USE_PARALLEL_SCENEGRAPH.
+  bool m_parallelSceneGraph;
+  /// Nodes scheduled for the parallel update sorted by address, reused every frame.
+  NodeList m_scheduledNodes;
+  /// Scheduled nodes without scheduled ancestor, each one is updated by a task.
+  NodeList m_updateRoots;
+  /// Nodes updated under each root, their callbacks are called after the parallel update.
+  std::vector<NodeList> m_updatedNodes;
 
   /**
    * Various SCA managers used by the scene
@@ -263,6 +341,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    * Toggle to enable or disable activity culling.
    */
   bool m_activityCulling;
+  /// Grid of the objects using activity culling, updated incrementally from m_activityObjects.
+  KX_ActivityGrid m_activityGrid;
 
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
@@ -353,6 +433,20 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void BackupRestrictFlag(Object *ob, char restrictFlag);
   void RestoreRestrictFlags();
   void TagForCollectionRemap();
+  bool IsReplicatingPooled() const;
+  /// Return a hidden pooled copy of ob made visible, or nullptr if its pool is empty.
+  Object *AcquirePooledObject(Object *ob);
+  /// Hide and store pooledob in the pool of ob, return false if it must be deleted instead.
+  bool ReleasePooledObject(Object *ob, Object *pooledob);
+  void SetPooledObjectVisible(Object *pooledob, bool visible);
+  /// Fill the pool of ob with hidden copies up to count objects.
+  void PrewarmObjectPool(Object *ob, int count);
+  /// Delete the pooled objects, only the ones of templates tagged ID_TAG_DOIT if onlyTagged.
+  void FreeObjectPools(bool onlyTagged);
+  /// Return the instance buffer of a template using game instancing, created if needed.
+  KX_InstanceBuffer *GetInstanceBuffer(Object *ob);
+  /// Delete the instance buffers, only the ones of templates tagged ID_TAG_DOIT if onlyTagged.
+  void FreeInstanceBuffers(bool onlyTagged);
   KX_GameObject *GetGameObjectFromObject(Object *ob);
   void BackupObjectsMatToWorld(BackupObj *back);
   void RestoreObjectsMatToWorld();
@@ -384,7 +478,15 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   static bool KX_ScenegraphUpdateFunc(SG_Node *node, void *gameobj, void *scene);
   static bool KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *scene);
+  static void KX_ScenegraphDirtyFunc(SG_Node *node,
+                                     void *gameobj,
+                                     void *scene,
+                                     unsigned int flags);
   void UpdateParents(double curtime);
+  /// Update the world data of the scheduled nodes, the independent subtrees in parallel.
+  void UpdateParentsParallel(double curtime);
+  /// Store the hierarchies of the active objects in the transform store after they changed.
+  void BuildTransformStore();
   void DupliGroupRecurse(KX_GameObject *groupobj, int level);
   bool IsObjectInGroup(KX_GameObject *gameobj)
   {
@@ -392,9 +494,13 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
             m_groupGameObjects.find(gameobj) != m_groupGameObjects.end());
   }
   void AddObjectDebugProperties(KX_GameObject *gameobj);
+  /** Replicate gameobj and its children, when pooled is true the replica blender objects
+   * are taken from and returned to the object pools of the scene.
+   */
   KX_GameObject *AddReplicaObject(KX_GameObject *gameobj,
                                   KX_GameObject *locationobj,
-                                  float lifespan = 0.0f);
+                                  float lifespan = 0.0f,
+                                  bool pooled = false);
   KX_GameObject *AddNodeReplicaObject(SG_Node *node, KX_GameObject *gameobj);
   void RemoveNodeDestructObject(SG_Node *node, KX_GameObject *gameobj);
   void RemoveObject(KX_GameObject *gameobj);
@@ -405,6 +511,21 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
 
   void AddAnimatedObject(KX_GameObject *gameobj);
+  void AddDirtyRenderObject(KX_GameObject *gameobj);
+  /// Visit the object at every render pass, even if its node doesn't move.
+  void AddAlwaysDirtyRenderObject(KX_GameObject *gameobj);
+  /** Visit the object at every render pass while the depsgraph resets its evaluated transform:
+   * the objects not transformed in their blender object (e.g fluid) and the objects without
+   * parent in game keeping their blender parent. Called when the object is added to the scene
+   * and when its parent changed.
+   */
+  void UpdateDepsgraphResetObject(KX_GameObject *gameobj);
+  /** Return the objects to notify to the depsgraph for the current render pass,
+   * the list is consumed at the last render pass.
+   */
+  std::vector<KX_GameObject *> GetDirtyRenderObjects(bool is_last_render_pass);
+  /// Re-evaluate the object activity culling at the next update, e.g. when its radii changed.
+  void AddActivityObject(KX_GameObject *gameobj);
 
   /**
    * \section Logic stuff
@@ -548,8 +669,15 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_obstacleSimulation;
   }
 
+  SG_TransformStore *GetTransformStore()
+  {
+    return m_transformStore;
+  }
+
   /**  Inherited from EXP_Value -- returns the name of this object. */
   virtual std::string GetName();
+  /// Same as GetName without copy.
+  const std::string &GetSceneName() const;
 
   /** Inherited from EXP_Value -- set the name of this object. */
   virtual void SetName(const std::string &name);
@@ -575,6 +703,13 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_PYMETHOD_DOC(KX_Scene, addOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, removeOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, getGameObjectFromObject);
+  EXP_PYMETHOD_DOC(KX_Scene, prewarmObjectPool);
+  EXP_PYMETHOD_DOC(KX_Scene, rayCastBatch);
+  EXP_PYMETHOD_DOC(KX_Scene, getTransforms);
+  EXP_PYMETHOD_DOC(KX_Scene, setTransforms);
+  EXP_PYMETHOD_DOC(KX_Scene, getWorldMatrices);
+  EXP_PYMETHOD_DOC(KX_Scene, getProperties);
+  EXP_PYMETHOD_DOC(KX_Scene, setProperties);
 
   /* attributes */
   static PyObject *pyattr_get_name(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
@@ -634,6 +769,13 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   }
 
   bool MergeScene(KX_Scene *other);
+  /** Merge a part of a scene, the objects are added to the scene lists and activated only in
+   * the last step, until then the other scene must not be used.
+   * \param state The merge progress, default constructed before the first call.
+   * \param endTime The time in seconds after which the merge is interrupted, 0 to merge all.
+   * \return True when the merge is finished, see MergeState::m_success for the result.
+   */
+  bool MergeSceneStep(KX_Scene *other, MergeState &state, double endTime);
 
   // void PrintStats(int verbose_level) {
   //	m_bucketmanager->PrintStats(verbose_level)
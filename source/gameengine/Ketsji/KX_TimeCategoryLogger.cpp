@@ -31,10 +31,13 @@
 
 #include "KX_TimeCategoryLogger.h"
 
+#include "CM_Trace.h"
+
 KX_TimeCategoryLogger::KX_TimeCategoryLogger(const CM_Clock &clock,
                                              unsigned int maxNumMeasurements)
 
-    : m_clock(clock), m_maxNumMeasurements(maxNumMeasurements), m_lastCategory(-1)
+    : m_clock(clock), m_maxNumMeasurements(maxNumMeasurements), m_lastCategory(-1),
+      m_traceBegin(-1)
 {
 }
 
@@ -55,12 +58,32 @@ unsigned int KX_TimeCategoryLogger::GetMaxNumMeasurements() const
   return m_maxNumMeasurements;
 }
 
-void KX_TimeCategoryLogger::AddCategory(TimeCategory tc)
+void KX_TimeCategoryLogger::AddCategory(TimeCategory tc, const std::string &name)
 {
   // Only add if not already present
   if (m_loggers.find(tc) == m_loggers.end()) {
     m_loggers.emplace(TimeLoggerMap::value_type(tc, KX_TimeLogger(m_maxNumMeasurements)));
+    m_names.emplace(tc, name);
+  }
+}
+
+void KX_TimeCategoryLogger::TraceLastCategory()
+{
+  if (!CM_TraceRecorder::IsEnabled()) {
+    m_traceBegin = -1;
+    return;
+  }
+
+  CM_TraceRecorder &recorder = CM_TraceRecorder::Get();
+  const CM_Clock::Rep now = recorder.GetTime();
+  if (m_lastCategory != -1 && m_traceBegin != -1) {
+    recorder.AddSpan("category",
+                     recorder.RegisterName(m_names[m_lastCategory]),
+                     m_traceBegin,
+                     now,
+                     CM_TraceRecorder::CATEGORIES_THREAD);
   }
+  m_traceBegin = now;
 }
 
 void KX_TimeCategoryLogger::StartLog(TimeCategory tc)
@@ -69,6 +92,7 @@ void KX_TimeCategoryLogger::StartLog(TimeCategory tc)
   if (m_lastCategory != -1) {
     m_loggers[m_lastCategory].EndLog(now);
   }
+  TraceLastCategory();
   m_loggers[tc].StartLog(now);
   m_lastCategory = tc;
 }
@@ -83,6 +107,7 @@ void KX_TimeCategoryLogger::EndLog()
 {
   const double now = m_clock.GetTimeSecond();
   m_loggers[m_lastCategory].EndLog(now);
+  TraceLastCategory();
   m_lastCategory = -1;
 }
 
@@ -36,6 +36,7 @@
 #endif
 
 #include <map>
+#include <string>
 
 #include "CM_Clock.h"
 #include "KX_TimeLogger.h"
@@ -75,8 +76,9 @@ class KX_TimeCategoryLogger {
   /**
    * Adds a category.
    * \param category	The new category.
+   * \param name The category name used in the recorded traces.
    */
-  void AddCategory(TimeCategory tc);
+  void AddCategory(TimeCategory tc, const std::string &name);
 
   /**
    * Starts logging in current measurement for the given category.
@@ -121,4 +123,12 @@ class KX_TimeCategoryLogger {
   unsigned int m_maxNumMeasurements;
 
   TimeCategory m_lastCategory;
+
+  /// Names of the categories in the traces.
+  std::map<TimeCategory, std::string> m_names;
+  /// Start time of the last category span in the traces, -1 when not recorded.
+  CM_Clock::Rep m_traceBegin;
+
+  /// Record the span of the last category in the trace recorder.
+  void TraceLastCategory();
 };
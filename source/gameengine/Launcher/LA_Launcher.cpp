@@ -30,6 +30,8 @@
 
 #include "LA_Launcher.h"
 
+#include <algorithm>
+
 #include "BKE_context.hh"
 #include "BKE_main.hh"
 #include "BKE_sound.h"
@@ -39,6 +41,7 @@
 #include "BL_Converter.h"
 #include "BL_DataConversion.h"
 #include "CM_Message.h"
+#include "CM_Trace.h"
 #include "DEV_EventConsumer.h"
 #include "DEV_InputDevice.h"
 #include "DEV_Joystick.h"
@@ -142,6 +145,23 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool parallelScenes = (gm.flag & GAME_USE_PARALLEL_SCENES) != 0;
+  const int benchmarkFrames = SYS_GetCommandLineInt(syshandle, "benchmark_frames", 0);
+  const int benchmarkWarmupFrames = SYS_GetCommandLineInt(syshandle, "benchmark_warmup", 10);
+  const bool profilePython = (SYS_GetCommandLineInt(syshandle, "profile_python", 0) != 0);
+  const std::string traceFile = SYS_GetCommandLineString(syshandle, "trace_file", "");
+  const int traceEvents = SYS_GetCommandLineInt(
+      syshandle, "trace_events", CM_TraceRecorder::DEFAULT_MAX_EVENTS);
+
+  // The trace continues over the game restarts and is written at each engine exit.
+  if (!traceFile.empty() && !CM_TraceRecorder::IsEnabled()) {
+    CM_TraceRecorder::Get().Start(std::max(traceEvents, 1));
+  }
+
+  // The benchmark runs all the frames as fast as possible.
+  if (benchmarkFrames > 0) {
+    fixed_framerate = false;
+  }
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -155,6 +175,7 @@ void LA_Launcher::InitEngine()
       (KX_KetsjiEngine::FlagType)((fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
                                   (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
                                   (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
+                                  (parallelScenes ? KX_KetsjiEngine::PARALLEL_SCENES : 0) |
                                   (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
                                   (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
 
@@ -175,7 +196,10 @@ void LA_Launcher::InitEngine()
   // Copy current vsync mode to restore at the game end.
   m_canvas->GetSwapInterval(m_savedData.vsync);
 
-  if (gm.vsync == VSYNC_ADAPTIVE) {
+  if (benchmarkFrames > 0) {
+    m_canvas->SetSwapInterval(0);
+  }
+  else if (gm.vsync == VSYNC_ADAPTIVE) {
     m_canvas->SetSwapInterval(-1);
   }
   else {
@@ -225,6 +249,10 @@ void LA_Launcher::InitEngine()
 
   m_ketsjiEngine->SetFlag(flags, true);
   m_ketsjiEngine->SetRender(true);
+  m_ketsjiEngine->GetPythonProfiler()->SetEnabled(profilePython);
+  if (benchmarkFrames > 0) {
+    m_ketsjiEngine->SetBenchmark(benchmarkFrames, benchmarkWarmupFrames);
+  }
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
@@ -295,6 +323,17 @@ void LA_Launcher::ExitEngine()
   DEV_Joystick::Close();
   m_ketsjiEngine->StopEngine();
 
+  const std::string traceFile = SYS_GetCommandLineString(SYS_GetSystem(), "trace_file", "");
+  if (!traceFile.empty()) {
+    std::string error;
+    if (CM_TraceRecorder::Get().Dump(traceFile, error)) {
+      CM_Message("Trace written to \"" << traceFile << "\"");
+    }
+    else {
+      CM_Error("can't write the trace to \"" << traceFile << "\", " << error);
+    }
+  }
+
 #ifdef WITH_PYTHON
 
   /* Clears the dictionary by hand:
@@ -0,0 +1,255 @@
+/** \file gameengine/Physics/Bullet/CcdBvhCache.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdBvhCache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "BulletCollision/CollisionShapes/btStridingMeshInterface.h"
+#include "LinearMath/btAlignedAllocator.h"
+
+#include "BLI_fileops.h"
+#include "BLI_hash_md5.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.h"
+
+#include BLI_SYSTEM_PID_H
+
+#include "CM_Message.h"
+
+/// Header of a BVH file, its size keeps the BVH data 16 bytes aligned in the file.
+struct CcdBvhCacheHeader {
+  char m_magic[4];
+  uint32_t m_version;
+  uint32_t m_bulletVersion;
+  /// Size of btScalar and of a pointer, the BVH data is stored in memory layout.
+  uint32_t m_scalarSize;
+  uint32_t m_pointerSize;
+  uint32_t m_dataSize;
+  uint32_t m_pad[2];
+};
+
+static const char cacheMagic[4] = {'B', 'G', 'B', 'V'};
+static const uint32_t cacheVersion = 1;
+/// Size of the BVH files kept in a cache directory, the least recently used are deleted above.
+static const uint64_t cacheMaxSize = 256 * 1024 * 1024;
+
+static void bvh_cache_header_init(CcdBvhCacheHeader &header, uint32_t dataSize)
+{
+  memset(&header, 0, sizeof(header));
+  memcpy(header.m_magic, cacheMagic, sizeof(cacheMagic));
+  header.m_version = cacheVersion;
+  header.m_bulletVersion = BT_BULLET_VERSION;
+  header.m_scalarSize = sizeof(btScalar);
+  header.m_pointerSize = sizeof(void *);
+  header.m_dataSize = dataSize;
+}
+
+/// Hash the triangles and the scaling of a mesh, the result is the name of its BVH file.
+static std::string bvh_cache_mesh_hash(btStridingMeshInterface *meshInterface)
+{
+  // Hash each vertex and index array separately and then the list of their hashes.
+  std::vector<unsigned char> digests;
+  const auto add_digest = [&digests](const void *data, size_t size) {
+    unsigned char digest[16];
+    BLI_hash_md5_buffer((const char *)data, size, digest);
+    digests.insert(digests.end(), digest, digest + sizeof(digest));
+  };
+
+  const btVector3 &scaling = meshInterface->getScaling();
+  const double scale[3] = {scaling.x(), scaling.y(), scaling.z()};
+  add_digest(scale, sizeof(scale));
+
+  for (int part = 0, numParts = meshInterface->getNumSubParts(); part < numParts; ++part) {
+    const unsigned char *vertexBase;
+    const unsigned char *indexBase;
+    int numVerts, vertexStride, indexStride, numFaces;
+    PHY_ScalarType vertexType, indexType;
+    meshInterface->getLockedReadOnlyVertexIndexBase(&vertexBase,
+                                                    numVerts,
+                                                    vertexType,
+                                                    vertexStride,
+                                                    &indexBase,
+                                                    indexStride,
+                                                    numFaces,
+                                                    indexType,
+                                                    part);
+
+    const int layout[6] = {numVerts, vertexStride, vertexType, numFaces, indexStride, indexType};
+    add_digest(layout, sizeof(layout));
+    add_digest(vertexBase, size_t(numVerts) * vertexStride);
+    add_digest(indexBase, size_t(numFaces) * indexStride);
+
+    meshInterface->unLockReadOnlyVertexBase(part);
+  }
+
+  unsigned char digest[16];
+  BLI_hash_md5_buffer((const char *)digests.data(), digests.size(), digest);
+
+  char hex[33];
+  BLI_hash_md5_to_hexdigest(digest, hex);
+  return std::string(hex);
+}
+
+/// Read a BVH file, return nullptr if it doesn't exist or was written by another build.
+static btOptimizedBvh *bvh_cache_read(const std::string &path, void *&r_buffer)
+{
+  FILE *file = BLI_fopen(path.c_str(), "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  CcdBvhCacheHeader header;
+  CcdBvhCacheHeader expected;
+  btOptimizedBvh *bvh = nullptr;
+  if (fread(&header, sizeof(header), 1, file) == 1) {
+    bvh_cache_header_init(expected, header.m_dataSize);
+    if (memcmp(&header, &expected, sizeof(header)) == 0 && header.m_dataSize > 0) {
+      void *buffer = btAlignedAlloc(header.m_dataSize, 16);
+      if (fread(buffer, header.m_dataSize, 1, file) == 1) {
+        bvh = btOptimizedBvh::deSerializeInPlace(buffer, header.m_dataSize, false);
+      }
+
+      if (bvh) {
+        r_buffer = buffer;
+      }
+      else {
+        btAlignedFree(buffer);
+      }
+    }
+  }
+
+  fclose(file);
+
+  return bvh;
+}
+
+void CcdBvhCache::Evict(const std::string &directory)
+{
+  if (!BLI_is_dir(directory.c_str())) {
+    return;
+  }
+
+  direntry *entries;
+  const unsigned int numEntries = BLI_filelist_dir_contents(directory.c_str(), &entries);
+
+  std::vector<const direntry *> files;
+  uint64_t size = 0;
+  for (unsigned int i = 0; i < numEntries; ++i) {
+    const direntry &entry = entries[i];
+    if (S_ISREG(entry.type) && BLI_path_extension_check(entry.relname, ".bvh")) {
+      files.push_back(&entry);
+      size += entry.s.st_size;
+    }
+  }
+
+  if (size > cacheMaxSize) {
+    // The reads of the cache touch the files, the oldest modification is the least recent use.
+    std::sort(files.begin(), files.end(), [](const direntry *a, const direntry *b) {
+      return a->s.st_mtime < b->s.st_mtime;
+    });
+
+    for (const direntry *entry : files) {
+      if (size <= cacheMaxSize) {
+        break;
+      }
+      if (BLI_delete(entry->path, false, false) == 0) {
+        size -= entry->s.st_size;
+      }
+    }
+  }
+
+  BLI_filelist_free(entries, numEntries);
+}
+
+/** Write a BVH file, through a temporary file to never leave a truncated file readable by
+ * another game instance.
+ * \return True if the file was written.
+ */
+static bool bvh_cache_write(const std::string &directory,
+                            const std::string &path,
+                            const void *buffer,
+                            unsigned int size)
+{
+  if (!BLI_dir_create_recursive(directory.c_str())) {
+    CM_Warning("can't create the BVH cache directory " << directory);
+    return false;
+  }
+
+  /* The temporary file is unique per process and thread, the same mesh can be built by two
+   * LibLoad threads or two game instances at once. */
+  const std::string tmpPath = path + "." + std::to_string(abs(getpid())) + "." +
+                              std::to_string(std::hash<std::thread::id>()(
+                                  std::this_thread::get_id())) +
+                              ".tmp";
+  FILE *file = BLI_fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    CM_Warning("can't write the BVH cache file " << tmpPath);
+    return false;
+  }
+
+  CcdBvhCacheHeader header;
+  bvh_cache_header_init(header, size);
+  const bool success = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+                        fwrite(buffer, size, 1, file) == 1);
+  fclose(file);
+
+  if (!success || BLI_rename_overwrite(tmpPath.c_str(), path.c_str()) != 0) {
+    CM_Warning("can't write the BVH cache file " << path);
+    BLI_delete(tmpPath.c_str(), false, false);
+    return false;
+  }
+
+  return true;
+}
+
+btOptimizedBvh *CcdBvhCache::GetBvh(const std::string &directory,
+                                    btStridingMeshInterface *meshInterface,
+                                    const btVector3 &aabbMin,
+                                    const btVector3 &aabbMax,
+                                    void *&r_buffer)
+{
+  char path[FILE_MAX];
+  BLI_path_join(path,
+                sizeof(path),
+                directory.c_str(),
+                (bvh_cache_mesh_hash(meshInterface) + ".bvh").c_str());
+
+  btOptimizedBvh *bvh = bvh_cache_read(path, r_buffer);
+  if (bvh) {
+    // Mark the file as recently used for the eviction.
+    BLI_file_touch(path);
+    return bvh;
+  }
+
+  btOptimizedBvh *builtBvh = new btOptimizedBvh();
+  builtBvh->build(meshInterface, true, aabbMin, aabbMax);
+
+  /* The built BVH is serialized and used in place, as a BVH read from the cache, to give the
+   * same ownership to the caller in both cases. */
+  const unsigned int size = builtBvh->calculateSerializeBufferSize();
+  void *buffer = btAlignedAlloc(size, 16);
+  builtBvh->serializeInPlace(buffer, size, false);
+  delete builtBvh;
+
+  bvh_cache_write(directory, path, buffer, size);
+
+  r_buffer = buffer;
+  return btOptimizedBvh::deSerializeInPlace(buffer, size, false);
+}
+
+void CcdBvhCache::FreeBvh(btOptimizedBvh *bvh, void *buffer)
+{
+  // The BVH arrays point into the buffer and don't own their memory.
+  static_cast<btQuantizedBvh *>(bvh)->~btQuantizedBvh();
+  btAlignedFree(buffer);
+}
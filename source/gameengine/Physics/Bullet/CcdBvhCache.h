@@ -0,0 +1,39 @@
+/** \file CcdBvhCache.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <string>
+
+#include "LinearMath/btVector3.h"
+
+class btOptimizedBvh;
+class btStridingMeshInterface;
+
+/** On-disk cache of the quantized BVHs of the static triangle mesh shapes, to skip their
+ * construction at the next game start. A BVH file is named after the hash of the triangles of
+ * its mesh, a modified mesh uses a new file and a stale file is never read. The least recently
+ * used files are deleted by Evict when the directory exceeds a size limit. The files are only valid for
+ * the Bullet version, precision and architecture writing them.
+ */
+class CcdBvhCache {
+ public:
+  /** Read the BVH of a mesh from the cache, or build it and write it to the cache.
+   * \param directory The directory of the BVH files, resolved by the caller.
+   * \param aabbMin, aabbMax The local bounds of the mesh, used for the quantization.
+   * \param r_buffer The 16 bytes aligned buffer the BVH lives in, to free with btAlignedFree
+   * after the destruction of the BVH and of the shapes using it.
+   */
+  static btOptimizedBvh *GetBvh(const std::string &directory,
+                                btStridingMeshInterface *meshInterface,
+                                const btVector3 &aabbMin,
+                                const btVector3 &aabbMax,
+                                void *&r_buffer);
+  /// Destruct a BVH returned by GetBvh and free its buffer.
+  static void FreeBvh(btOptimizedBvh *bvh, void *buffer);
+  /** Delete the least recently used BVH files when the directory exceeds the cache size limit,
+   * called once when the game ends and not per written file.
+   */
+  static void Evict(const std::string &directory);
+};
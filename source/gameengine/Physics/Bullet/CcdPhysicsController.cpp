@@ -28,6 +28,7 @@
 #include "BKE_context.hh"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_legacy_convert.hh"
+#include "BLI_task.h"
 #include "DEG_depsgraph_query.hh"
 #include "DNA_meshdata_types.h"
 
@@ -38,6 +39,7 @@
 #include "LinearMath/btConvexHull.h"
 
 #include "CcdPhysicsEnvironment.h"
+#include "CcdSharedMeshShape.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
 #include "RAS_MeshObject.h"
@@ -191,6 +193,7 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
 {
   m_prototypeTransformInitialized = false;
   m_softbodyMappingDone = false;
+  m_softBodyVertexMapDone = false;
   m_newClientInfo = 0;
   m_registerCount = 0;
   m_softBodyTransformInitialized = false;
@@ -311,7 +314,7 @@ bool CcdPhysicsController::CreateSoftbody()
   }
 
   btSoftBody *psb = nullptr;
-  btSoftBodyWorldInfo &worldInfo = m_cci.m_physicsEnv->GetDynamicsWorld()->getWorldInfo();
+  btSoftBodyWorldInfo &worldInfo = m_cci.m_physicsEnv->GetSoftBodyWorld()->getWorldInfo();
 
   if (m_cci.m_collisionShape->getShapeType() ==
       CONVEX_HULL_SHAPE_PROXYTYPE) {  // Disabled in upbge 0.3
@@ -531,6 +534,9 @@ bool CcdPhysicsController::CreateSoftbody()
     }
   }
   m_softbodyMappingDone = true;
+  // The node indices of the new soft body may differ.
+  m_softBodyVertexMap.clear();
+  m_softBodyVertexMapDone = false;
 
   btTransform startTrans;
   m_bulletMotionState->getWorldTransform(startTrans);
@@ -659,8 +665,15 @@ static void DeleteBulletShape(btCollisionShape *shape, bool free)
      * free the child of the unscaled shape (btTriangleMeshShape) here.
      */
     btTriangleMeshShape *meshShape = ((btScaledBvhTriangleMeshShape *)shape)->getChildShape();
-    if (meshShape)
-      delete meshShape;
+    if (meshShape) {
+      CcdSharedMeshShape *sharedShape = CcdSharedMeshShape::FromShape(meshShape);
+      if (sharedShape) {
+        CcdSharedMeshShape::ReleaseShape(sharedShape);
+      }
+      else {
+        delete meshShape;
+      }
+    }
   }
   if (free) {
     delete shape;
@@ -703,7 +716,7 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 
   btSoftBody *softBody = GetSoftBody();
   if (softBody) {
-    btSoftRigidDynamicsWorld *world = GetPhysicsEnvironment()->GetDynamicsWorld();
+    btSoftRigidDynamicsWorld *world = GetPhysicsEnvironment()->GetSoftBodyWorld();
     // remove the old softBody
     world->removeSoftBody(softBody);
 
@@ -837,6 +850,84 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
   return true;
 }
 
+void CcdPhysicsController::BuildSoftBodyVertexMap(Mesh *me)
+{
+  m_softBodyVertexMap.clear();
+  m_softBodyVertexMapDone = true;
+
+  RAS_MeshObject *rasMesh = GetShapeInfo()->GetMesh();
+  if (!rasMesh) {
+    return;
+  }
+
+  BKE_mesh_tessface_ensure(me);
+
+  const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy,
+                                                                   CD_ORIGINDEX);
+  const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
+  if (!index_mf_to_mpoly) {
+    index_mp_to_orig = nullptr;
+  }
+
+  const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
+  const int numpolys = me->totface_legacy;
+  const int numnodes = GetSoftBody()->m_nodes.size();
+
+  // Node of each mesh vertex, a vertex shared by several polygons keeps its last node.
+  std::vector<int> vertexNodes(me->verts_num, -1);
+  const auto set_vertex_node = [&vertexNodes, numnodes](unsigned int vertex, int node) {
+    if (node >= 0 && node < numnodes) {
+      vertexNodes[vertex] = node;
+    }
+  };
+
+  for (int p2 = 0; p2 < numpolys; p2++) {
+    const MFace *face = &faces[p2];
+    const int origi = index_mf_to_mpoly ?
+                          DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
+                          p2;
+    RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
+
+    // only add polygons that have the collisionflag set
+    if (poly) {
+      set_vertex_node(face->v1, poly->GetVertexInfo(0).getSoftBodyIndex());
+      set_vertex_node(face->v2, poly->GetVertexInfo(1).getSoftBodyIndex());
+      set_vertex_node(face->v3, poly->GetVertexInfo(2).getSoftBodyIndex());
+      if (face->v4) {
+        set_vertex_node(face->v4, poly->GetVertexInfo(3).getSoftBodyIndex());
+      }
+    }
+  }
+
+  for (int v = 0, size = vertexNodes.size(); v < size; ++v) {
+    if (vertexNodes[v] != -1) {
+      m_softBodyVertexMap.push_back({v, vertexNodes[v]});
+    }
+  }
+}
+
+struct SoftBodyWritebackData {
+  const CcdPhysicsController::SoftBodyVertex *map;
+  const btSoftBody::Node *nodes;
+  btVector3 com;
+  float (*positions)[3];
+};
+
+static void soft_body_writeback_func(void *__restrict userdata,
+                                     const int index,
+                                     const TaskParallelTLS *__restrict /*tls*/)
+{
+  SoftBodyWritebackData *data = static_cast<SoftBodyWritebackData *>(userdata);
+  const CcdPhysicsController::SoftBodyVertex &vertex = data->map[index];
+
+  // Do we need object_to_world? maybe
+  const btVector3 pos = data->nodes[vertex.m_node].m_x - data->com;
+  float *co = data->positions[vertex.m_vertex];
+  co[0] = pos.x();
+  co[1] = pos.y();
+  co[2] = pos.z();
+}
+
 void CcdPhysicsController::UpdateSoftBody()
 {
   btSoftBody *sb = GetSoftBody();
@@ -850,59 +941,28 @@ void CcdPhysicsController::UpdateSoftBody()
             (KX_ClientObjectInfo *)GetNewClientInfo());
         Object *ob = gameobj->GetBlenderObject();
         Mesh *me = (Mesh *)ob->data;
-        BKE_mesh_tessface_ensure(me);
 
-        const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy, CD_ORIGINDEX);
-        const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
-        if (!index_mf_to_mpoly) {
-          index_mp_to_orig = nullptr;
+        if (!m_softBodyVertexMapDone) {
+          BuildSoftBodyVertexMap(me);
         }
 
-        float(*positions)[3] = reinterpret_cast<float(*)[3]>(
-            me->vert_positions_for_write().data());
-        const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
-        int numpolys = me->totface_legacy;
-
-        btSoftBody::tNodeArray &nodes(sb->m_nodes);
-
-        for (int p2 = 0; p2 < numpolys; p2++) {
-          const MFace *face = &faces[p2];
-          const int origi = index_mf_to_mpoly ?
-                                DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
-                                p2;
-          RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
-
-          // only add polygons that have the collisionflag set
-          if (poly) {
-            float *v1 = &positions[face->v1][0];
-            float *v2 = &positions[face->v2][0];
-            float *v3 = &positions[face->v3][0];
-
-            int i1 = poly->GetVertexInfo(0).getSoftBodyIndex();
-            int i2 = poly->GetVertexInfo(1).getSoftBodyIndex();
-            int i3 = poly->GetVertexInfo(2).getSoftBodyIndex();
-
-            MT_Vector3 p1 = ToMoto(nodes.at(i1).m_x - sb->m_pose.m_com);
-            MT_Vector3 p2 = ToMoto(nodes.at(i2).m_x - sb->m_pose.m_com);
-            MT_Vector3 p3 = ToMoto(nodes.at(i3).m_x - sb->m_pose.m_com);
-
-            // Do we need object_to_world? maybe
-            copy_v3_v3(v1, p1.getValue());
-            copy_v3_v3(v2, p2.getValue());
-            copy_v3_v3(v3, p3.getValue());
-
-            if (face->v4) {
-              float *v4 = &positions[face->v4][0];
-
-              int i4 = poly->GetVertexInfo(3).getSoftBodyIndex();
+        if (m_softBodyVertexMap.empty()) {
+          return;
+        }
 
-              MT_Vector3 p4 = ToMoto(nodes.at(i4).m_x - sb->m_pose.m_com);
+        SoftBodyWritebackData data;
+        data.map = m_softBodyVertexMap.data();
+        data.nodes = &sb->m_nodes[0];
+        data.com = sb->m_pose.m_com;
+        data.positions = reinterpret_cast<float(*)[3]>(me->vert_positions_for_write().data());
 
-              copy_v3_v3(v4, p4.getValue());
+        // Each mesh vertex is written once, the iterations are independent.
+        TaskParallelSettings settings;
+        BLI_parallel_range_settings_defaults(&settings);
+        settings.min_iter_per_thread = 1024;
+        BLI_task_parallel_range(
+            0, m_softBodyVertexMap.size(), &data, soft_body_writeback_func, &settings);
 
-            }
-          }
-        }
         me->tag_positions_changed();
         DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
       }
@@ -1151,7 +1211,7 @@ void CcdPhysicsController::RefreshCollisions()
   if (IsPhysicsSuspended())
     return;
 
-  btSoftRigidDynamicsWorld *dw = GetPhysicsEnvironment()->GetDynamicsWorld();
+  btDiscreteDynamicsWorld *dw = GetPhysicsEnvironment()->GetDynamicsWorld();
   btBroadphaseProxy *proxy = m_object->getBroadphaseHandle();
   btDispatcher *dispatcher = dw->getDispatcher();
   btOverlappingPairCache *pairCache = dw->getPairCache();
@@ -1778,7 +1838,7 @@ void CcdPhysicsController::RemoveCompoundChild(PHY_IPhysicsController *child)
         break;
       }
     }
-    delete childCtrl->m_bulletChildShape;
+    DeleteBulletShape(childCtrl->m_bulletChildShape, true);
     childCtrl->m_bulletChildShape = nullptr;
   }
   // recompute inertia of parent
@@ -2670,15 +2730,14 @@ bool CcdShapeConstructionInfo::SetProxy(CcdShapeConstructionInfo *shapeInfo)
   return true;
 }
 
-btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
-                                                              bool useGimpact,
-                                                              bool useBvh)
+btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(
+    btScalar margin, bool useGimpact, bool useBvh, const std::string &bvhCacheDirectory)
 {
   btCollisionShape *collisionShape = nullptr;
   btCompoundShape *compoundShape = nullptr;
 
   if (m_shapeType == PHY_SHAPE_PROXY && m_shapeProxy != nullptr)
-    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh);
+    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh, bvhCacheDirectory);
 
   switch (m_shapeType) {
     default:
@@ -2743,6 +2802,24 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         collisionShape = gimpactShape;
       }
       else {
+        /* The cached BVH is only used for the mesh of the conversion, a mesh reinstanced at
+         * runtime is likely deformed and its BVH is not worth a cache file. */
+        const std::string cacheDirectory = m_forceReInstance ? std::string() : bvhCacheDirectory;
+
+        if (useBvh && m_weldingThreshold1 == 0.0f) {
+          // Meshes with the same triangles share the unscaled shape and its BVH.
+          collisionShape = CcdSharedMeshShape::CreateShape(
+              m_vertexArray, m_triFaceArray, margin, cacheDirectory);
+
+          // The shared shape uses its own copy of the triangles, drop the outdated array.
+          if (m_forceReInstance) {
+            delete m_triangleIndexVertexArray;
+            m_triangleIndexVertexArray = nullptr;
+            m_forceReInstance = false;
+          }
+          break;
+        }
+
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
           /// enable welding, only for the objects that need it (such as soft bodies)
           if (0.0f != m_weldingThreshold1) {
@@ -2794,7 +2871,8 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       for (std::vector<CcdShapeConstructionInfo *>::iterator sit = m_shapeArray.begin();
            sit != m_shapeArray.end();
            sit++) {
-        collisionShape = (*sit)->CreateBulletShape(margin, useGimpact, useBvh);
+        collisionShape = (*sit)->CreateBulletShape(
+            margin, useGimpact, useBvh, bvhCacheDirectory);
         if (collisionShape) {
           collisionShape->setLocalScaling((*sit)->m_childScale);
           compoundShape->addChildShape((*sit)->m_childTrans, collisionShape);
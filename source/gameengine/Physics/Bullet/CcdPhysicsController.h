@@ -23,6 +23,7 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <vector>
 
 ///	PHY_IPhysicsController is the abstract simplified Interface to a physical object.
@@ -156,9 +157,13 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
     return m_shapeProxy;
   }
 
+  /** \param bvhCacheDirectory The CcdBvhCache directory of the static mesh shapes, empty to
+   * disable the cache.
+   */
   btCollisionShape *CreateBulletShape(btScalar margin,
                                       bool useGimpact = false,
-                                      bool useBvh = true);
+                                      bool useBvh = true,
+                                      const std::string &bvhCacheDirectory = std::string());
 
   // member variables
   PHY_ShapeType m_shapeType;
@@ -558,6 +563,13 @@ class CleanPairCallback : public btOverlapCallback {
 /// CcdPhysicsController is a physics object that supports continuous collision detection and time
 /// of impact based physics resolution.
 class CcdPhysicsController : public PHY_IPhysicsController {
+ public:
+  /// Soft body node written to a Blender mesh vertex by UpdateSoftBody.
+  struct SoftBodyVertex {
+    int m_vertex;
+    int m_node;
+  };
+
  protected:
   btCollisionObject *m_object;
   CcdCharacter *m_characterController;
@@ -575,6 +587,9 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   // some book keeping for replication
   bool m_softbodyMappingDone;
+  /// Node of each written mesh vertex, built at the first update of the soft body.
+  std::vector<SoftBodyVertex> m_softBodyVertexMap;
+  bool m_softBodyVertexMapDone;
   bool m_softBodyTransformInitialized;
   bool m_prototypeTransformInitialized;
   btTransform m_softbodyStartTrans;
@@ -597,6 +612,8 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   void CreateRigidbody();
   bool CreateSoftbody();
+  /// Find the soft body node of each vertex of the Blender mesh through its polygons.
+  void BuildSoftBodyVertexMap(struct Mesh *me);
   bool CreateCharacterController();
 
   bool Register()
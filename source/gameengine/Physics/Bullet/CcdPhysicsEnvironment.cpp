@@ -23,22 +23,29 @@
 
 #include "BKE_object.hh"
 #include "BLI_bounds_types.hh"
+#include "BLI_task.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/ConstraintSolver/btNNCGConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
+#include "CM_Trace.h"
 #include "CcdConstraint.h"
 #include "CcdGraphicController.h"
+#include "CcdTaskScheduler.h"
 #include "KX_ClientObjectInfo.h"
 #include "KX_GameObject.h"
+#include "KX_Globals.h"
 #include "MT_MinMax.h"
 #include "PHY_IVehicle.h"
 #include "RAS_IVertex.h"
@@ -344,6 +351,18 @@ class WrapperVehicle : public PHY_IVehicle {
   }
 };
 
+/// Multithreaded world allowing to change its solver of the large islands with the solver type.
+class CcdDynamicsWorldMt : public btDiscreteDynamicsWorldMt {
+ public:
+  using btDiscreteDynamicsWorldMt::btDiscreteDynamicsWorldMt;
+
+  /// Set the solver of the large islands, nullptr to solve them with the solver pool.
+  void SetConstraintSolverMt(btConstraintSolver *solverMt)
+  {
+    m_constraintSolverMt = solverMt;
+  }
+};
+
 class CcdOverlapFilterCallBack : public btOverlapFilterCallback {
  private:
   class CcdPhysicsEnvironment *m_physEnv;
@@ -366,20 +385,28 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
   m_debugDrawer = debugDrawer;
 }
 
-CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling)
+CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType,
+                                             bool useDbvtCulling,
+                                             bool useMultithreading)
     : m_cullingCache(nullptr),
       m_cullingTree(nullptr),
       m_numIterations(10),
       m_numTimeSubSteps(1),
       m_solverType(PHY_SOLVER_NONE),
+      m_useMultithreading(useMultithreading),
       m_deactivationTime(2.0f),
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_dynamicsWorld(nullptr),
+      m_softBodyWorld(nullptr),
       m_solver(nullptr),
+      m_solverMt(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
-      m_ownDispatcher(nullptr)
+      m_ownDispatcher(nullptr),
+      m_numCollData(0),
+      m_collDataFrame(0)
 {
   for (int i = 0; i < PHY_NUM_RESPONSE; i++) {
     m_triggerCallbacks[i] = nullptr;
@@ -387,7 +414,15 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
 
   m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration();
 
-  btCollisionDispatcher *dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+  btCollisionDispatcher *dispatcher;
+  if (m_useMultithreading) {
+    // The multithreaded dispatcher sizes its per thread data from the task scheduler.
+    CcdTaskScheduler::Register();
+    dispatcher = new btCollisionDispatcherMt(m_collisionConfiguration);
+  }
+  else {
+    dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+  }
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
   m_ownDispatcher = dispatcher;
 
@@ -406,8 +441,19 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   SetSolverType(solverType);  // issues with quickstep and memory allocations
   //	m_dynamicsWorld = new
   // btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-  m_dynamicsWorld = new btSoftRigidDynamicsWorld(
-      dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  if (m_useMultithreading) {
+    m_solverMt = new btSequentialImpulseConstraintSolverMt();
+    m_dynamicsWorld = new CcdDynamicsWorldMt(dispatcher,
+                                             m_broadphase,
+                                             (btConstraintSolverPoolMt *)m_solver,
+                                             GetConstraintSolverMt(),
+                                             m_collisionConfiguration);
+  }
+  else {
+    m_softBodyWorld = new btSoftRigidDynamicsWorld(
+        dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+    m_dynamicsWorld = m_softBodyWorld;
+  }
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
@@ -454,7 +500,10 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
   else {
     if (ctrl->GetSoftBody()) {
       btSoftBody *softBody = ctrl->GetSoftBody();
-      m_dynamicsWorld->addSoftBody(softBody);
+      // Soft bodies merged from a single threaded environment are not simulated.
+      if (m_softBodyWorld) {
+        m_softBodyWorld->addSoftBody(softBody);
+      }
     }
     else {
       if (obj->getCollisionShape()) {
@@ -587,7 +636,9 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
   else {
     // if a softbody
     if (ctrl->GetSoftBody()) {
-      m_dynamicsWorld->removeSoftBody(ctrl->GetSoftBody());
+      if (m_softBodyWorld) {
+        m_softBodyWorld->removeSoftBody(ctrl->GetSoftBody());
+      }
     }
     else {
       m_dynamicsWorld->removeCollisionObject(ctrl->GetCollisionObject());
@@ -625,7 +676,9 @@ void CcdPhysicsEnvironment::UpdateCcdPhysicsController(CcdPhysicsController *ctr
       m_dynamicsWorld->addRigidBody(body, newCollisionGroup, newCollisionMask);
     }
     else if (softBody) {
-      m_dynamicsWorld->addSoftBody(softBody);
+      if (m_softBodyWorld) {
+        m_softBodyWorld->addSoftBody(softBody);
+      }
     }
     else {
       m_dynamicsWorld->addCollisionObject(obj, newCollisionGroup, newCollisionMask);
@@ -721,14 +774,36 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
   }
 }
 
+bool CcdPhysicsEnvironment::HasSameGlobalSettings(PHY_IPhysicsEnvironment *other)
+{
+  CcdPhysicsEnvironment *ccdOther = dynamic_cast<CcdPhysicsEnvironment *>(other);
+  if (!ccdOther) {
+    return true;
+  }
+
+  return (m_deactivationTime == ccdOther->m_deactivationTime &&
+          m_contactBreakingThreshold == ccdOther->m_contactBreakingThreshold);
+}
+
+void CcdPhysicsEnvironment::ApplyGlobalSettings()
+{
+  gDeactivationTime = m_deactivationTime;
+  gContactBreakingThreshold = m_contactBreakingThreshold;
+}
+
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
+  CM_TraceScope physicsTrace("physics", "ProceedDeltaTime");
+
   std::set<CcdPhysicsController *>::iterator it;
   int i;
 
-  // Update Bullet global variables.
-  gDeactivationTime = m_deactivationTime;
-  gContactBreakingThreshold = m_contactBreakingThreshold;
+  /* Update Bullet global variables, when the scenes are proceeded in parallel they are already
+   * set and only read here. */
+  if (gDeactivationTime != m_deactivationTime ||
+      gContactBreakingThreshold != m_contactBreakingThreshold) {
+    ApplyGlobalSettings();
+  }
 
   for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
     (*it)->SynchronizeMotionStates(timeStep);
@@ -1003,6 +1078,43 @@ void CcdPhysicsEnvironment::SetSolverDamping(float damping)
   m_dynamicsWorld->getSolverInfo().m_damping = damping;
 }
 
+btConstraintSolver *CcdPhysicsEnvironment::CreateConstraintSolver(PHY_SolverType solverType) const
+{
+  /* The pool picks its solvers modulo their number, one solver per thread really solving
+   * islands is enough. */
+  const int numSolvers = m_useMultithreading ? btGetTaskScheduler()->getMaxNumThreads() : 1;
+  std::vector<btConstraintSolver *> solvers(numSolvers);
+
+  for (int i = 0; i < numSolvers; ++i) {
+    switch (solverType) {
+      case PHY_SOLVER_SEQUENTIAL: {
+        solvers[i] = new btSequentialImpulseConstraintSolver();
+        break;
+      }
+
+      case PHY_SOLVER_NNCG: {
+        solvers[i] = new btNNCGConstraintSolver();
+        break;
+      }
+      default: {
+        BLI_assert(false);
+        solvers[i] = new btSequentialImpulseConstraintSolver();
+      }
+    };
+  }
+
+  btConstraintSolver *solver;
+  if (m_useMultithreading) {
+    // The pool takes the ownership of the solvers, one per thread solving islands.
+    solver = new btConstraintSolverPoolMt(solvers.data(), numSolvers);
+  }
+  else {
+    solver = solvers[0];
+  }
+
+  return solver;
+}
+
 void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
 {
 
@@ -1010,21 +1122,26 @@ void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
     return;
   }
 
-  switch (solverType) {
-    case PHY_SOLVER_SEQUENTIAL: {
-      m_solver = new btSequentialImpulseConstraintSolver();
-      break;
-    }
-
-    case PHY_SOLVER_NNCG: {
-      m_solver = new btNNCGConstraintSolver();
-      break;
-    }
-    default: {
-      BLI_assert(false);
-    }
-  };
+  btConstraintSolver *solver = CreateConstraintSolver(solverType);
+  // The world is not yet created when called from the constructor.
+  if (m_dynamicsWorld) {
+    m_dynamicsWorld->setConstraintSolver(solver);
+  }
+  delete m_solver;
+  m_solver = solver;
   m_solverType = solverType;
+
+  if (m_useMultithreading && m_dynamicsWorld) {
+    static_cast<CcdDynamicsWorldMt *>(m_dynamicsWorld)->SetConstraintSolverMt(
+        GetConstraintSolverMt());
+  }
+}
+
+btConstraintSolver *CcdPhysicsEnvironment::GetConstraintSolverMt() const
+{
+  /* Only a sequential impulse solver exists for the large islands, the islands of the other
+   * solver types are all solved by the solvers of the pool. */
+  return (m_solverType == PHY_SOLVER_SEQUENTIAL) ? m_solverMt : nullptr;
 }
 
 void CcdPhysicsEnvironment::GetGravity(MT_Vector3 &grav)
@@ -1039,7 +1156,9 @@ void CcdPhysicsEnvironment::SetGravity(float x, float y, float z)
 {
   m_gravity = btVector3(x, y, z);
   m_dynamicsWorld->setGravity(m_gravity);
-  m_dynamicsWorld->getWorldInfo().m_gravity.setValue(x, y, z);
+  if (m_softBodyWorld) {
+    m_softBodyWorld->getWorldInfo().m_gravity.setValue(x, y, z);
+  }
 }
 
 static int gConstraintUid = 1;
@@ -1116,6 +1235,88 @@ struct FilterClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
   }
 };
 
+/// Ray callback of the batch ray test, filtering the objects with their collision group only.
+struct MaskClosestRayResultCallback : public btCollisionWorld::ClosestRayResultCallback {
+  unsigned short m_mask;
+
+  MaskClosestRayResultCallback(const btVector3 &rayFrom,
+                               const btVector3 &rayTo,
+                               unsigned short mask)
+      : btCollisionWorld::ClosestRayResultCallback(rayFrom, rayTo), m_mask(mask)
+  {
+  }
+
+  virtual bool needsCollision(btBroadphaseProxy *proxy0) const
+  {
+    if (!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0)) {
+      return false;
+    }
+    btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+    CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+    // Skip the collision objects without physics controller.
+    return (phyCtrl && (phyCtrl->GetCollisionGroup() & m_mask));
+  }
+};
+
+struct RayTestBatchData {
+  const btCollisionWorld *world;
+  const float *from;
+  const float *to;
+  unsigned short mask;
+  PHY_RayCastResult *results;
+};
+
+static void ray_test_batch_func(void *__restrict userdata,
+                                const int index,
+                                const TaskParallelTLS *__restrict /*tls*/)
+{
+  const RayTestBatchData *data = (const RayTestBatchData *)userdata;
+  const float *from = &data->from[index * 3];
+  const float *to = &data->to[index * 3];
+  const btVector3 rayFrom(from[0], from[1], from[2]);
+  const btVector3 rayTo(to[0], to[1], to[2]);
+
+  MaskClosestRayResultCallback rayCallback(rayFrom, rayTo, data->mask);
+  // Same filtering and ray test flags than in RayTest.
+  rayCallback.m_collisionFilterMask = CcdConstructionInfo::AllFilter ^
+                                      CcdConstructionInfo::SensorFilter;
+  rayCallback.m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
+
+  data->world->rayTest(rayFrom, rayTo, rayCallback);
+
+  PHY_RayCastResult &result = data->results[index];
+  if (!rayCallback.hasHit()) {
+    result.m_controller = nullptr;
+    return;
+  }
+
+  result.m_controller = static_cast<CcdPhysicsController *>(
+      rayCallback.m_collisionObject->getUserPointer());
+  result.m_hitPoint = MT_Vector3(rayCallback.m_hitPointWorld.m_floats);
+  if (rayCallback.m_hitNormalWorld.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+    result.m_hitNormal = MT_Vector3(rayCallback.m_hitNormalWorld.normalized().m_floats);
+  }
+  else {
+    result.m_hitNormal = MT_Vector3(1.0f, 0.0f, 0.0f);
+  }
+}
+
+void CcdPhysicsEnvironment::RayTestBatch(const float *from,
+                                         const float *to,
+                                         unsigned int numRays,
+                                         unsigned short mask,
+                                         PHY_RayCastResult *results)
+{
+  RayTestBatchData data = {m_dynamicsWorld, from, to, mask, results};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  // A ray test is short, avoid to schedule too small chunks.
+  settings.min_iter_per_thread = 64;
+
+  BLI_task_parallel_range(0, numRays, &data, ray_test_batch_func, &settings);
+}
+
 static bool GetHitTriangle(btCollisionShape *shape,
                            CcdShapeConstructionInfo *shapeInfo,
                            int hitTriangleIndex,
@@ -1131,6 +1332,12 @@ static bool GetHitTriangle(btCollisionShape *shape,
   int numfaces;
   PHY_ScalarType indicestype;
   btStridingMeshInterface *meshInterface = shapeInfo->GetMeshInterface();
+  // The shared mesh shapes hold their own copy of the triangles of the shape info.
+  if (!meshInterface && shape->getShapeType() == SCALED_TRIANGLE_MESH_SHAPE_PROXYTYPE) {
+    meshInterface = static_cast<btScaledBvhTriangleMeshShape *>(shape)
+                        ->getChildShape()
+                        ->getMeshInterface();
+  }
 
   if (!meshInterface)
     return false;
@@ -2000,6 +2207,9 @@ CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
   if (nullptr != m_solver)
     delete m_solver;
 
+  if (nullptr != m_solverMt)
+    delete m_solverMt;
+
   if (nullptr != m_debugDrawer)
     delete m_debugDrawer;
 
@@ -2112,11 +2322,37 @@ void CcdPhysicsEnvironment::CallbackTriggers()
       manifold->clearManifold();  // refreshContactPoints(rb0->getCenterOfMassTransform(),rb1->getCenterOfMassTransform());
     }
 
-    const CcdCollData *coll_data = new CcdCollData(manifold);
+    const CcdCollData *coll_data = NewCollData(manifold);
     m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE], ctrl0, ctrl1, coll_data, first);
   }
 }
 
+const CcdCollData *CcdPhysicsEnvironment::NewCollData(const btPersistentManifold *manifold)
+{
+  const unsigned int firstPoint = m_contactPoints.size();
+  const unsigned int numContacts = manifold->getNumContacts();
+  for (unsigned int i = 0; i < numContacts; ++i) {
+    m_contactPoints.push_back(manifold->getContactPoint(i));
+  }
+
+  if (m_numCollData < m_collData.size()) {
+    m_collData[m_numCollData].SetPoints(&m_contactPoints, firstPoint, numContacts);
+  }
+  else {
+    m_collData.emplace_back(&m_contactPoints, &m_collDataFrame, firstPoint, numContacts);
+  }
+
+  return &m_collData[m_numCollData++];
+}
+
+void CcdPhysicsEnvironment::ClearCollisionData()
+{
+  m_contactPoints.clear();
+  m_numCollData = 0;
+  // The points are reused by the next collisions, the views given to the callbacks are stale.
+  ++m_collDataFrame;
+}
+
 PHY_CollisionTestResult CcdPhysicsEnvironment::CheckCollision(PHY_IPhysicsController *ctrl0, PHY_IPhysicsController *ctrl1)
 {
   PHY_CollisionTestResult result{false, false, nullptr};
@@ -2602,7 +2838,13 @@ PHY_IConstraint *CcdPhysicsEnvironment::CreateConstraint(class PHY_IPhysicsContr
   con->setUserConstraintType(type);
   CcdConstraint *constraintData = new CcdConstraint(con, disableCollisionBetweenLinkedBodies);
   con->setUserConstraintPtr(constraintData);
-  m_dynamicsWorld->addConstraint(con, disableCollisionBetweenLinkedBodies);
+  // The constraint of a suspended controller is added when the controller is restored.
+  if (IsActiveCcdPhysicsController(c0) && IsActiveCcdPhysicsController(c1)) {
+    m_dynamicsWorld->addConstraint(con, disableCollisionBetweenLinkedBodies);
+  }
+  else {
+    constraintData->SetActive(false);
+  }
 
   return constraintData;
 }
@@ -2742,15 +2984,18 @@ struct BlenderDebugDraw : public btIDebugDraw {
   }
 };
 
-CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool visualizePhysics)
+CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene,
+                                                     bool visualizePhysics,
+                                                     const std::string &bvhCacheDirectory)
 {
 
   static const PHY_SolverType solverTypeTable[] = {
       PHY_SOLVER_SEQUENTIAL,  // GAME_SOLVER_SEQUENTIAL
       PHY_SOLVER_NNCG,        // GAME_SOLVER_NNGC
   };
+  const bool useMultithreading = (blenderscene->gm.flag & GAME_USE_PHYSICS_MULTITHREADING) != 0;
   CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
-      solverTypeTable[blenderscene->gm.solverType], false);
+      solverTypeTable[blenderscene->gm.solverType], false, useMultithreading);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
@@ -2759,6 +3004,10 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
   ccdPhysEnv->SetERPContact(blenderscene->gm.erp2);
   ccdPhysEnv->SetCFM(blenderscene->gm.cfm);
 
+  if (blenderscene->gm.flag & GAME_USE_BVH_CACHE) {
+    ccdPhysEnv->m_bvhCacheDirectory = bvhCacheDirectory;
+  }
+
   if (visualizePhysics)
     ccdPhysEnv->SetDebugMode(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb |
                              btIDebugDraw::DBG_DrawContactPoints | btIDebugDraw::DBG_DrawText |
@@ -2821,6 +3070,13 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
     isbulletsoftbody = false;
   }
 
+  // The multithreaded world can't simulate soft bodies.
+  if (isbulletsoftbody && m_useMultithreading) {
+    CM_Warning("soft bodies are not supported by multithreaded physics, object \""
+               << gameobj->GetName() << "\" is converted without soft body.");
+    isbulletsoftbody = false;
+  }
+
   if (!isbulletdyna) {
     ci.m_collisionFlags |= btCollisionObject::CF_STATIC_OBJECT;
   }
@@ -3068,7 +3324,8 @@ void CcdPhysicsEnvironment::ConvertObject(BL_SceneConverter *converter,
         shapeInfo->setVertexWeldingThreshold1(0.0f);  // todo: expose this to the UI
       }
 
-      bm = shapeInfo->CreateBulletShape(ci.m_margin, useGimpact, !isbulletsoftbody);
+      bm = shapeInfo->CreateBulletShape(
+          ci.m_margin, useGimpact, !isbulletsoftbody, m_bvhCacheDirectory);
       // should we compute inertia for dynamic shape?
       // bm->calculateLocalInertia(ci.m_mass,ci.m_localInertiaTensor);
 
@@ -3357,64 +3614,92 @@ void CcdPhysicsEnvironment::SetupObjectConstraints(KX_GameObject *obj_src,
   }
 }
 
-CcdCollData::CcdCollData(const btPersistentManifold *manifoldPoint)
-    : m_manifoldPoint(manifoldPoint)
+CcdCollData::CcdCollData(const std::vector<btManifoldPoint> *points,
+                         const unsigned int *frame,
+                         unsigned int firstPoint,
+                         unsigned int numContacts)
+    : m_points(points), m_firstPoint(firstPoint), m_numContacts(numContacts), m_frame(frame)
+{
+}
+
+CcdCollData::CcdCollData(const btPersistentManifold *manifold)
+    : m_points(&m_ownPoints),
+      m_firstPoint(0),
+      m_numContacts(manifold->getNumContacts()),
+      m_frame(nullptr)
 {
+  for (unsigned int i = 0; i < m_numContacts; ++i) {
+    m_ownPoints.push_back(manifold->getContactPoint(i));
+  }
 }
 
 CcdCollData::~CcdCollData()
 {
 }
 
+void CcdCollData::SetPoints(const std::vector<btManifoldPoint> *points,
+                            unsigned int firstPoint,
+                            unsigned int numContacts)
+{
+  m_points = points;
+  m_firstPoint = firstPoint;
+  m_numContacts = numContacts;
+}
+
+unsigned int CcdCollData::GetFrame() const
+{
+  return m_frame ? *m_frame : 0;
+}
+
 unsigned int CcdCollData::GetNumContacts() const
 {
-  return m_manifoldPoint->getNumContacts();
+  return m_numContacts;
 }
 
 MT_Vector3 CcdCollData::GetLocalPointA(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return MT_Vector3(first ? point.m_localPointA.m_floats : point.m_localPointB.m_floats);
 }
 
 MT_Vector3 CcdCollData::GetLocalPointB(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return MT_Vector3(first ? point.m_localPointB.m_floats : point.m_localPointA.m_floats);
 }
 
 MT_Vector3 CcdCollData::GetWorldPoint(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return MT_Vector3(point.m_positionWorldOnB.m_floats);
 }
 
 MT_Vector3 CcdCollData::GetNormal(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return MT_Vector3(first ? (-point.m_normalWorldOnB).m_floats : point.m_normalWorldOnB.m_floats);
 }
 
 float CcdCollData::GetCombinedFriction(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return point.m_combinedFriction;
 }
 
 float CcdCollData::GetCombinedRollingFriction(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return point.m_combinedRollingFriction;
 }
 
 float CcdCollData::GetCombinedRestitution(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return point.m_combinedRestitution;
 }
 
 float CcdCollData::GetAppliedImpulse(unsigned int index, bool first) const
 {
-  const btManifoldPoint &point = m_manifoldPoint->getContactPoint(index);
+  const btManifoldPoint &point = (*m_points)[m_firstPoint + index];
   return point.m_appliedImpulse;
 }
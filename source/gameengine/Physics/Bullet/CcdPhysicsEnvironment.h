@@ -23,10 +23,12 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <set>
 #include <vector>
 
+#include "BulletCollision/NarrowPhaseCollision/btManifoldPoint.h"
 #include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
@@ -50,6 +52,45 @@ class CcdGraphicController;
 class CcdOverlapFilterCallBack;
 class CcdShapeConstructionInfo;
 
+/** Contact points of a pair of colliding objects. The points are stored in a contiguous buffer
+ * shared by all the collision data of a physics environment and filled at each physics step, the
+ * collision data being only a view on a range of this buffer. The views are invalidated by
+ * CcdPhysicsEnvironment::ClearCollisionData through the frame counter of the environment.
+ */
+class CcdCollData : public PHY_ICollData {
+  const std::vector<btManifoldPoint> *m_points;
+  unsigned int m_firstPoint;
+  unsigned int m_numContacts;
+  /// Frame counter of the environment owning m_points, nullptr when the points are owned.
+  const unsigned int *m_frame;
+  /// Contact points copied from a manifold, used when the collision data is not in a buffer.
+  std::vector<btManifoldPoint> m_ownPoints;
+
+ public:
+  CcdCollData(const std::vector<btManifoldPoint> *points,
+              const unsigned int *frame,
+              unsigned int firstPoint,
+              unsigned int numContacts);
+  CcdCollData(const btPersistentManifold *manifold);
+  CcdCollData(const CcdCollData &other) = delete;
+  virtual ~CcdCollData();
+
+  void SetPoints(const std::vector<btManifoldPoint> *points,
+                 unsigned int firstPoint,
+                 unsigned int numContacts);
+
+  virtual unsigned int GetFrame() const;
+  virtual unsigned int GetNumContacts() const;
+  virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
+  virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
+  virtual float GetCombinedFriction(unsigned int index, bool first) const;
+  virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
+  virtual float GetCombinedRestitution(unsigned int index, bool first) const;
+  virtual float GetAppliedImpulse(unsigned int index, bool first) const;
+};
+
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional
  * continuous collision detection. Physics Environment takes care of stepping the simulation and is
  * a container for physics entities. It stores rigidbodies,constraints, materials etc. A derived
@@ -87,6 +128,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   PHY_SolverType m_solverType;
 
+  /// Step the world with btDiscreteDynamicsWorldMt, soft bodies are not supported.
+  bool m_useMultithreading;
+
   float m_deactivationTime;
   float m_linearDeactivationThreshold;
   float m_angularDeactivationThreshold;
@@ -95,7 +139,7 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   void ProcessFhSprings(double curTime, float timeStep);
 
  public:
-  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
+  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling, bool useMultithreading);
 
   virtual ~CcdPhysicsEnvironment();
 
@@ -134,6 +178,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies();
 
+  virtual bool HasSameGlobalSettings(PHY_IPhysicsEnvironment *other);
+  virtual void ApplyGlobalSettings();
+
   /**
    * Called by Bullet for every physical simulation (sub)tick.
    * Our constructor registers this callback to Bullet, which stores a pointer to 'this' in
@@ -185,6 +232,7 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   virtual float getAppliedImpulse(int constraintid);
 
   virtual void CallbackTriggers();
+  virtual void ClearCollisionData();
 
   // complex constraint for vehicles
   virtual PHY_IVehicle *GetVehicleConstraint(int constraintId);
@@ -200,6 +248,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            unsigned short mask,
+                            PHY_RayCastResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -272,16 +325,38 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void SyncMotionStates(float timeStep);
 
-  class btSoftRigidDynamicsWorld *GetDynamicsWorld()
+  class btDiscreteDynamicsWorld *GetDynamicsWorld()
   {
     return m_dynamicsWorld;
   }
 
+  /// Return the soft body world, nullptr when the environment is multithreaded.
+  class btSoftRigidDynamicsWorld *GetSoftBodyWorld()
+  {
+    return m_softBodyWorld;
+  }
+
+  bool GetUseMultithreading() const
+  {
+    return m_useMultithreading;
+  }
+
+  /// Directory of the BVH cache of the static mesh shapes, empty when the cache is disabled.
+  const std::string &GetBvhCacheDirectory() const
+  {
+    return m_bvhCacheDirectory;
+  }
+
   class btConstraintSolver *GetConstraintSolver();
 
   void MergeEnvironment(PHY_IPhysicsEnvironment *other_env);
 
-  static CcdPhysicsEnvironment *Create(struct Scene *blenderscene, bool visualizePhysics);
+  /** \param bvhCacheDirectory The BVH cache directory of the game, used if the scene enables the
+   * cache, empty if the game has no cache directory.
+   */
+  static CcdPhysicsEnvironment *Create(struct Scene *blenderscene,
+                                       bool visualizePhysics,
+                                       const std::string &bvhCacheDirectory);
 
   virtual void ConvertObject(BL_SceneConverter *converter,
                              KX_GameObject *gameobj,
@@ -305,6 +380,20 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
   void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
 
+  /** Contact points of the collisions sent to the trigger callbacks since the last
+   * ClearCollisionData, the buffer capacity is kept between the frames. */
+  std::vector<btManifoldPoint> m_contactPoints;
+  /** Collision data viewing m_contactPoints, a deque keeps the addresses stable while growing
+   * and the records are reused between the frames instead of being allocated per collision. */
+  std::deque<CcdCollData> m_collData;
+  /// Number of records of m_collData in use.
+  unsigned int m_numCollData;
+  /// Incremented by ClearCollisionData to invalidate the views on m_contactPoints.
+  unsigned int m_collDataFrame;
+
+  /// Copy the contact points of a manifold and return a collision data viewing them.
+  const CcdCollData *NewCollData(const btPersistentManifold *manifold);
+
   std::vector<WrapperVehicle *> m_wrapperVehicles;
 
   /** use explicit btSoftRigidDynamicsWorld/btDiscreteDynamicsWorld* so that we have access to
@@ -314,9 +403,22 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
    * Ideally we would like to have access to this function from the btDynamicsWorld interface
    */
   // class btDynamicsWorld *m_dynamicsWorld;
-  class btSoftRigidDynamicsWorld *m_dynamicsWorld;
+  class btDiscreteDynamicsWorld *m_dynamicsWorld;
+  /// Same as m_dynamicsWorld for single threaded environment, else nullptr.
+  class btSoftRigidDynamicsWorld *m_softBodyWorld;
 
+  /// Constraint solver, a btConstraintSolverPoolMt when multithreaded.
   class btConstraintSolver *m_solver;
+  /// Solver used by the multithreaded world for large islands.
+  class btConstraintSolver *m_solverMt;
+
+  /// Create a constraint solver of the given type, a pool of it when multithreaded.
+  btConstraintSolver *CreateConstraintSolver(PHY_SolverType solverType) const;
+  /// Solver of the large islands for the current solver type, nullptr to use the pool.
+  btConstraintSolver *GetConstraintSolverMt() const;
+
+  /// Directory of the BVH cache, kept by each environment as the scenes settings differ.
+  std::string m_bvhCacheDirectory;
 
   class CcdOverlapFilterCallBack *m_filterCallback;
 
@@ -326,21 +428,3 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename);
 };
-
-class CcdCollData : public PHY_ICollData {
-  const btPersistentManifold *m_manifoldPoint;
-
- public:
-  CcdCollData(const btPersistentManifold *manifoldPoint);
-  virtual ~CcdCollData();
-
-  virtual unsigned int GetNumContacts() const;
-  virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetWorldPoint(unsigned int index, bool first) const;
-  virtual MT_Vector3 GetNormal(unsigned int index, bool first) const;
-  virtual float GetCombinedFriction(unsigned int index, bool first) const;
-  virtual float GetCombinedRollingFriction(unsigned int index, bool first) const;
-  virtual float GetCombinedRestitution(unsigned int index, bool first) const;
-  virtual float GetAppliedImpulse(unsigned int index, bool first) const;
-};
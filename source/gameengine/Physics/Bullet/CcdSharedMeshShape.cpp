@@ -0,0 +1,136 @@
+/** \file gameengine/Physics/Bullet/CcdSharedMeshShape.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdSharedMeshShape.h"
+
+#include "BLI_hash_md5.hh"
+
+#include "CcdBvhCache.h"
+
+std::unordered_map<std::string, CcdSharedMeshShape *> CcdSharedMeshShape::s_registry;
+CM_ThreadMutex CcdSharedMeshShape::s_registryMutex;
+
+/// Hash the triangles and the margin of a shape, the vertex and index arrays are hashed apart.
+static std::string shared_mesh_shape_key(const btAlignedObjectArray<btScalar> &vertexArray,
+                                         const std::vector<int> &triFaceArray,
+                                         btScalar margin)
+{
+  unsigned char digests[3][16];
+  const double header[3] = {double(margin), double(vertexArray.size()), double(triFaceArray.size())};
+  BLI_hash_md5_buffer((const char *)header, sizeof(header), digests[0]);
+  BLI_hash_md5_buffer((const char *)&vertexArray[0],
+                      vertexArray.size() * sizeof(btScalar),
+                      digests[1]);
+  BLI_hash_md5_buffer((const char *)triFaceArray.data(),
+                      triFaceArray.size() * sizeof(int),
+                      digests[2]);
+
+  unsigned char digest[16];
+  BLI_hash_md5_buffer((const char *)digests, sizeof(digests), digest);
+
+  char hex[33];
+  BLI_hash_md5_to_hexdigest(digest, hex);
+  return std::string(hex);
+}
+
+CcdSharedMeshShape::CcdSharedMeshShape(const std::string &key,
+                                       const btAlignedObjectArray<btScalar> &vertexArray,
+                                       const std::vector<int> &triFaceArray,
+                                       btScalar margin,
+                                       const std::string &bvhCacheDirectory)
+    : m_key(key),
+      m_vertexArray(vertexArray),
+      m_triFaceArray(triFaceArray),
+      m_bvh(nullptr),
+      m_bvhBuffer(nullptr)
+{
+  m_meshInterface = new btTriangleIndexVertexArray(m_triFaceArray.size() / 3,
+                                                   m_triFaceArray.data(),
+                                                   3 * sizeof(int),
+                                                   m_vertexArray.size() / 3,
+                                                   &m_vertexArray[0],
+                                                   3 * sizeof(btScalar));
+
+  const bool useBvhCache = !bvhCacheDirectory.empty();
+  m_shape = new btBvhTriangleMeshShape(m_meshInterface, true, !useBvhCache);
+  if (useBvhCache) {
+    m_bvh = CcdBvhCache::GetBvh(bvhCacheDirectory,
+                                m_meshInterface,
+                                m_shape->getLocalAabbMin(),
+                                m_shape->getLocalAabbMax(),
+                                m_bvhBuffer);
+    // The shape doesn't own the cached BVH.
+    m_shape->setOptimizedBvh(m_bvh);
+  }
+  m_shape->setMargin(margin);
+  m_shape->setUserPointer(this);
+}
+
+CcdSharedMeshShape::~CcdSharedMeshShape()
+{
+  delete m_shape;
+  if (m_bvh) {
+    CcdBvhCache::FreeBvh(m_bvh, m_bvhBuffer);
+  }
+  delete m_meshInterface;
+}
+
+btScaledBvhTriangleMeshShape *CcdSharedMeshShape::CreateShape(
+    const btAlignedObjectArray<btScalar> &vertexArray,
+    const std::vector<int> &triFaceArray,
+    btScalar margin,
+    const std::string &bvhCacheDirectory)
+{
+  const std::string key = shared_mesh_shape_key(vertexArray, triFaceArray, margin);
+
+  s_registryMutex.Lock();
+  const auto it = s_registry.find(key);
+  CcdSharedMeshShape *sharedShape = (it != s_registry.end()) ? it->second->AddRef() : nullptr;
+  s_registryMutex.Unlock();
+
+  if (!sharedShape) {
+    /* The shape and its BVH are built without the mutex to not block the other threads, the
+     * shape of a thread registering the same triangles meanwhile is used instead. */
+    CcdSharedMeshShape *newShape = new CcdSharedMeshShape(
+        key, vertexArray, triFaceArray, margin, bvhCacheDirectory);
+
+    s_registryMutex.Lock();
+    // The first reference is the one of the returned shape.
+    const auto pair = s_registry.emplace(key, newShape);
+    sharedShape = pair.second ? newShape : pair.first->second->AddRef();
+    s_registryMutex.Unlock();
+
+    if (!pair.second) {
+      delete newShape;
+    }
+  }
+
+  btScaledBvhTriangleMeshShape *shape = new btScaledBvhTriangleMeshShape(
+      sharedShape->m_shape, btVector3(1.0f, 1.0f, 1.0f));
+  shape->setMargin(margin);
+  return shape;
+}
+
+void CcdSharedMeshShape::ReleaseShape(CcdSharedMeshShape *sharedShape)
+{
+  s_registryMutex.Lock();
+  const bool last = (sharedShape->GetRefCount() == 1);
+  if (last) {
+    s_registry.erase(sharedShape->m_key);
+  }
+  else {
+    sharedShape->Release();
+  }
+  s_registryMutex.Unlock();
+
+  // The last reference is not reachable from the registry anymore, delete without the mutex.
+  if (last) {
+    sharedShape->Release();
+  }
+}
+
+CcdSharedMeshShape *CcdSharedMeshShape::FromShape(btCollisionShape *shape)
+{
+  return static_cast<CcdSharedMeshShape *>(shape->getUserPointer());
+}
@@ -0,0 +1,61 @@
+/** \file CcdSharedMeshShape.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "btBulletDynamicsCommon.h"
+
+#include "CM_RefCount.h"
+#include "CM_Thread.h"
+
+/** Unscaled triangle mesh shape and BVH shared by all the static mesh shapes with the same
+ * triangles and margin, whichever scene or library converted their mesh. The scaled shapes
+ * created from it keep a reference released by the deletion of the scaled shape.
+ * The shapes are created and released by the main thread and by the asynchronous library
+ * loading threads, the registry and the reference counts are protected by a mutex.
+ */
+class CcdSharedMeshShape : public CM_RefCount<CcdSharedMeshShape> {
+ private:
+  /// Shared shapes by hash of their triangles and margin.
+  static std::unordered_map<std::string, CcdSharedMeshShape *> s_registry;
+  /// Mutex of the registry and of the reference counts of the shared shapes.
+  static CM_ThreadMutex s_registryMutex;
+
+  std::string m_key;
+  /// Copies of the triangles, independent of the lifetime of the converted mesh.
+  btAlignedObjectArray<btScalar> m_vertexArray;
+  std::vector<int> m_triFaceArray;
+  btTriangleIndexVertexArray *m_meshInterface;
+  btBvhTriangleMeshShape *m_shape;
+  /// BVH read from the BVH cache, nullptr if the shape built its own.
+  btOptimizedBvh *m_bvh;
+  void *m_bvhBuffer;
+
+  CcdSharedMeshShape(const std::string &key,
+                     const btAlignedObjectArray<btScalar> &vertexArray,
+                     const std::vector<int> &triFaceArray,
+                     btScalar margin,
+                     const std::string &bvhCacheDirectory);
+
+ public:
+  virtual ~CcdSharedMeshShape();
+
+  /** Create a scaled shape using the shared shape of the triangles, the shared shape is created
+   * if no mesh with the same triangles and margin exists.
+   * \param bvhCacheDirectory The CcdBvhCache directory used to read or write the BVH of a
+   * created shared shape, empty to always build the BVH.
+   */
+  static btScaledBvhTriangleMeshShape *CreateShape(const btAlignedObjectArray<btScalar> &vertexArray,
+                                                   const std::vector<int> &triFaceArray,
+                                                   btScalar margin,
+                                                   const std::string &bvhCacheDirectory);
+  /// Release the reference of a deleted scaled shape, to use instead of Release.
+  static void ReleaseShape(CcdSharedMeshShape *sharedShape);
+  /// Get the shared shape of an unscaled shape, nullptr if the shape is not shared.
+  static CcdSharedMeshShape *FromShape(btCollisionShape *shape);
+};
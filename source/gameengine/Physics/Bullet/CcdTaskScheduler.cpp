@@ -0,0 +1,218 @@
+/** \file gameengine/Physics/Bullet/CcdTaskScheduler.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdTaskScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "CM_Message.h"
+
+// Defined in btThreads.cpp but not exposed in its header.
+void btPushThreadsAreRunning();
+void btPopThreadsAreRunning();
+
+/** Bullet threads indices owned by a thread. btGetCurrentThreadIndex() wraps back to 1 once
+ * BT_MAX_THREAD_COUNT threads called it, the threads receiving an index already owned by
+ * another thread must not run the loops using the per thread data of Bullet.
+ */
+static bool threadIndexOwned[BT_MAX_THREAD_COUNT] = {false};
+static std::mutex threadIndexMutex;
+
+/// Return true if the Bullet thread index of the calling thread is not shared with any thread.
+static bool claim_thread_index()
+{
+  thread_local int claimed = -1;
+  if (claimed == -1) {
+    const unsigned int index = btGetCurrentThreadIndex();
+
+    std::lock_guard<std::mutex> lock(threadIndexMutex);
+    claimed = !threadIndexOwned[index];
+    threadIndexOwned[index] = true;
+
+    if (!claimed) {
+      static bool warned = false;
+      if (!warned) {
+        CM_Warning("more than " << BT_MAX_THREAD_COUNT - 1
+                                << " threads used Bullet, the extra threads don't run physics "
+                                   "tasks");
+        warned = true;
+      }
+    }
+  }
+  return claimed;
+}
+
+/// Chunks of a parallel loop processed by lanes, at most one lane per available thread index.
+struct CcdParallelData {
+  int begin;
+  int end;
+  int grainSize;
+  int numChunks;
+  std::atomic<int> nextChunk;
+
+  CcdParallelData(int iBegin, int iEnd, int grain)
+      : begin(iBegin),
+        end(iEnd),
+        grainSize(grain),
+        numChunks((iEnd - iBegin + grain - 1) / grain),
+        nextChunk(0)
+  {
+  }
+
+  /// Process the remaining chunks with func(chunk, begin, end).
+  template<class Func> void Run(const Func &func)
+  {
+    int chunk;
+    while ((chunk = nextChunk.fetch_add(1)) < numChunks) {
+      const int chunkBegin = begin + chunk * grainSize;
+      func(chunk, chunkBegin, std::min(chunkBegin + grainSize, end));
+    }
+  }
+};
+
+struct CcdParallelForData : CcdParallelData {
+  const btIParallelForBody *body;
+
+  CcdParallelForData(int iBegin, int iEnd, int grain, const btIParallelForBody *forBody)
+      : CcdParallelData(iBegin, iEnd, grain), body(forBody)
+  {
+  }
+
+  void Run()
+  {
+    CcdParallelData::Run([this](int /*chunk*/, int chunkBegin, int chunkEnd) {
+      body->forLoop(chunkBegin, chunkEnd);
+    });
+  }
+};
+
+struct CcdParallelSumData : CcdParallelData {
+  const btIParallelSumBody *body;
+  /// Sum per chunk, reduced in chunk order to keep the result deterministic.
+  btScalar *sums;
+
+  CcdParallelSumData(
+      int iBegin, int iEnd, int grain, const btIParallelSumBody *sumBody, btScalar *chunkSums)
+      : CcdParallelData(iBegin, iEnd, grain), body(sumBody), sums(chunkSums)
+  {
+  }
+
+  void Run()
+  {
+    CcdParallelData::Run([this](int chunk, int chunkBegin, int chunkEnd) {
+      sums[chunk] = body->sumLoop(chunkBegin, chunkEnd);
+    });
+  }
+};
+
+template<class Data>
+static void parallel_lane_func(void *__restrict userdata,
+                               const int /*lane*/,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  // A thread sharing its index leaves the chunks to the other lanes and the calling thread.
+  if (claim_thread_index()) {
+    ((Data *)userdata)->Run();
+  }
+}
+
+/// Run the chunks of data on the blender task scheduler then finish them on the calling thread.
+template<class Data> static void run_parallel_lanes(Data &data)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  // The calling thread owns one of the thread indices.
+  const int numLanes = std::min(data.numChunks, int(BT_MAX_THREAD_COUNT) - 1);
+
+  btPushThreadsAreRunning();
+  BLI_task_parallel_range(0, numLanes, &data, parallel_lane_func<Data>, &settings);
+  btPopThreadsAreRunning();
+
+  data.Run();
+}
+
+CcdTaskScheduler::CcdTaskScheduler() : btITaskScheduler("Blender")
+{
+}
+
+CcdTaskScheduler::~CcdTaskScheduler()
+{
+}
+
+int CcdTaskScheduler::getMaxNumThreads() const
+{
+  /* The workers of the task scheduler plus the calling thread, which is not always the main
+   * thread (e.g. asynchronous scene conversion). */
+  return std::min(BLI_system_thread_count() + 1, int(BT_MAX_THREAD_COUNT));
+}
+
+int CcdTaskScheduler::getNumThreads() const
+{
+  /* Bullet sizes its per thread data (e.g. btCollisionDispatcherMt manifolds) with this value
+   * and indexes them with btGetCurrentThreadIndex(), which is global to the process: a world
+   * stepped from a thread outside of the scheduler (e.g. a parallel scene task) can use any
+   * index below BT_MAX_THREAD_COUNT. The loops only run on threads owning their index, see
+   * claim_thread_index. */
+  return BT_MAX_THREAD_COUNT;
+}
+
+void CcdTaskScheduler::setNumThreads(int /*numThreads*/)
+{
+  // The blender task scheduler owns its threads.
+}
+
+void CcdTaskScheduler::parallelFor(int iBegin,
+                                   int iEnd,
+                                   int grainSize,
+                                   const btIParallelForBody &body)
+{
+  grainSize = std::max(1, grainSize);
+  CcdParallelForData data(iBegin, iEnd, grainSize, &body);
+  // A calling thread sharing its index could run chunks at the same time as its twin.
+  if (data.numChunks <= 1 || !claim_thread_index()) {
+    body.forLoop(iBegin, iEnd);
+    return;
+  }
+
+  run_parallel_lanes(data);
+}
+
+btScalar CcdTaskScheduler::parallelSum(int iBegin,
+                                       int iEnd,
+                                       int grainSize,
+                                       const btIParallelSumBody &body)
+{
+  grainSize = std::max(1, grainSize);
+  std::vector<btScalar> sums(std::max(1, (iEnd - iBegin + grainSize - 1) / grainSize));
+  CcdParallelSumData data(iBegin, iEnd, grainSize, &body, sums.data());
+  if (data.numChunks <= 1 || !claim_thread_index()) {
+    return body.sumLoop(iBegin, iEnd);
+  }
+
+  run_parallel_lanes(data);
+
+  btScalar sum = btScalar(0);
+  for (const btScalar value : sums) {
+    sum += value;
+  }
+  return sum;
+}
+
+void CcdTaskScheduler::Register()
+{
+  static CcdTaskScheduler scheduler;
+  // The main thread owns the first thread index.
+  claim_thread_index();
+  if (btGetTaskScheduler() != &scheduler) {
+    btSetTaskScheduler(&scheduler);
+  }
+}
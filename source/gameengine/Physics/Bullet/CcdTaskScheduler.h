@@ -0,0 +1,33 @@
+/** \file CcdTaskScheduler.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include "LinearMath/btThreads.h"
+
+/** Bullet task scheduler running the parallel loops of the multithreaded dynamics world
+ * (btDiscreteDynamicsWorldMt, btCollisionDispatcherMt...) on the blender task scheduler.
+ * The loop ranges are split in chunks of grain size, each chunk being a blender parallel
+ * range iteration.
+ */
+class CcdTaskScheduler : public btITaskScheduler {
+ public:
+  CcdTaskScheduler();
+  virtual ~CcdTaskScheduler();
+
+  virtual int getMaxNumThreads() const;
+  virtual int getNumThreads() const;
+  virtual void setNumThreads(int numThreads);
+
+  virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody &body);
+  virtual btScalar parallelSum(int iBegin,
+                               int iEnd,
+                               int grainSize,
+                               const btIParallelSumBody &body);
+
+  /** Install the scheduler as the Bullet task scheduler, must be called from the main
+   * thread before the construction of any multithreaded Bullet object.
+   */
+  static void Register();
+};
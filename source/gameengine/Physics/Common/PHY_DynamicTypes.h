@@ -48,6 +48,9 @@ class PHY_ICollData {
   {
   }
 
+  /** Return the number of times the contact points were released, the collision data is valid
+   * as long as it returns the same number. */
+  virtual unsigned int GetFrame() const = 0;
   virtual unsigned int GetNumContacts() const = 0;
   virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const = 0;
   virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const = 0;
@@ -124,6 +124,20 @@ class PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies() = 0;
 
+  /** Return true if the settings the physics engine keeps in process globals are the same for
+   * both environments, only such environments can be proceeded at the same time.
+   */
+  virtual bool HasSameGlobalSettings(PHY_IPhysicsEnvironment *other)
+  {
+    return true;
+  }
+  /** Write the settings kept in process globals, ProceedDeltaTime doesn't write them if they
+   * are already set.
+   */
+  virtual void ApplyGlobalSettings()
+  {
+  }
+
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -240,6 +254,16 @@ class PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ) = 0;
+  /** Cast a batch of rays, from and to contain the three coordinates of each ray end point.
+   * Only the objects with a collision group matching mask are tested, the others being
+   * transparent. Results receives the closest hit of each ray, with a null controller when
+   * nothing was hit. The rays are tested in parallel and no filter callback is used.
+   */
+  virtual void RayTestBatch(const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            unsigned short mask,
+                            PHY_RayCastResult *results) = 0;
 
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
@@ -261,6 +285,9 @@ class PHY_IPhysicsEnvironment {
   virtual bool RequestCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
   virtual bool RemoveCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
   virtual PHY_CollisionTestResult CheckCollision(PHY_IPhysicsController *ctrl0, PHY_IPhysicsController *ctrl1) = 0;
+  /** Release the collision data sent to the collision callbacks since the last call, must be
+   * called once the collisions were dispatched. */
+  virtual void ClearCollisionData() = 0;
   // These two methods are *solely* used to create controllers for sensor! Don't use for anything
   // else
   virtual PHY_IPhysicsController *CreateSphereController(float radius,
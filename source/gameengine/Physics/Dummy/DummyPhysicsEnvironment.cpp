@@ -122,3 +122,12 @@ PHY_IPhysicsController *DummyPhysicsEnvironment::RayTest(
   // collision detection / raytesting
   return nullptr;
 }
+
+void DummyPhysicsEnvironment::RayTestBatch(const float *from,
+                                           const float *to,
+                                           unsigned int numRays,
+                                           unsigned short mask,
+                                           PHY_RayCastResult *results)
+{
+  // The results are default constructed without hit.
+}
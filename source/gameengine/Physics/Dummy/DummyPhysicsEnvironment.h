@@ -98,6 +98,11 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void RayTestBatch(const float *from,
+                            const float *to,
+                            unsigned int numRays,
+                            unsigned short mask,
+                            PHY_RayCastResult *results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -130,6 +135,9 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   {
     return {false, false, nullptr};
   }
+  virtual void ClearCollisionData()
+  {
+  }
   virtual PHY_IPhysicsController *CreateSphereController(float radius,
                                                          const class MT_Vector3 &position)
   {
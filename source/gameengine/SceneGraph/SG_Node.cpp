@@ -7,9 +7,12 @@
 
 #include "SG_Node.h"
 
+#include <algorithm>
+
 #include "CM_List.h"
 #include "SG_Controller.h"
 #include "SG_Familly.h"
+#include "SG_TransformStore.h"
 
 static CM_ThreadMutex scheduleMutex;
 static CM_ThreadMutex transformMutex;
@@ -28,6 +31,8 @@ SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks)
       m_worldScaling(1.0f, 1.0f, 1.0f),
       m_parent_relation(nullptr),
       m_familly(new SG_Familly()),
+      m_transformStore(nullptr),
+      m_transformIndex(-1),
       m_modified(true),
       m_dirty(DIRTY_NONE)
 {
@@ -48,12 +53,19 @@ SG_Node::SG_Node(const SG_Node &other)
       m_worldScaling(other.m_worldScaling),
       m_parent_relation(other.m_parent_relation->NewCopy()),
       m_familly(new SG_Familly()),
+      // The replica is stored when the scene rebuilds its transform store.
+      m_transformStore(nullptr),
+      m_transformIndex(-1),
       m_dirty(DIRTY_NONE)
 {
 }
 
 SG_Node::~SG_Node()
 {
+  if (m_transformStore) {
+    m_transformStore->RemoveNode(this);
+  }
+
   SGControllerList::iterator contit;
 
   for (contit = m_SGcontrollers.begin(); contit != m_SGcontrollers.end(); ++contit) {
@@ -173,6 +185,10 @@ void SG_Node::DisconnectFromParent()
   if (m_SGparent) {
     m_SGparent->RemoveChild(this);
     m_SGparent = nullptr;
+    // The node stays after its former parent in the store, it only becomes a root.
+    if (m_transformStore) {
+      m_transformStore->DetachNode(this);
+    }
     SetFamilly(std::make_shared<SG_Familly>());
   }
 }
@@ -197,6 +213,11 @@ void SG_Node::AddChild(SG_Node *child)
 {
   m_children.push_back(child);
   child->SetSGParent(this);
+
+  SG_TransformStore *store = m_transformStore ? m_transformStore : child->m_transformStore;
+  if (store) {
+    store->MoveNode(child);
+  }
 }
 
 void SG_Node::RemoveChild(SG_Node *child)
@@ -248,6 +269,42 @@ void SG_Node::UpdateWorldDataThreadSchedule(double time, bool parentUpdated)
   }
 }
 
+void SG_Node::UpdateWorldDataDeferred(double time, NodeList &updatedNodes, bool parentUpdated)
+{
+  CM_ThreadSpinLock &famillyMutex = m_familly->GetMutex();
+  famillyMutex.Lock();
+
+  UpdateWorldDataDeferredSchedule(time, updatedNodes, parentUpdated);
+
+  famillyMutex.Unlock();
+}
+
+void SG_Node::UpdateWorldDataDeferredSchedule(double time,
+                                              NodeList &updatedNodes,
+                                              bool parentUpdated)
+{
+  if (UpdateSpatialData(GetSGParent(), time, parentUpdated)) {
+    updatedNodes.push_back(this);
+  }
+
+  scheduleMutex.Lock();
+  // The node is updated, remove it from the update list
+  Delink();
+  scheduleMutex.Unlock();
+
+  // update children's worlddata
+  for (SG_Node *childnode : m_children) {
+    childnode->UpdateWorldDataDeferredSchedule(time, updatedNodes, parentUpdated);
+  }
+}
+
+void SG_Node::ActivateUpdateTransformCallbacks(const NodeList &nodes)
+{
+  for (SG_Node *node : nodes) {
+    node->ActivateUpdateTransformCallback();
+  }
+}
+
 void SG_Node::SetSimulatedTime(double time, bool recurse)
 {
   // update the controllers of this node.
@@ -372,7 +429,13 @@ void SG_Node::SetControllerTime(double time)
 void SG_Node::ClearModified()
 {
   m_modified = false;
+  /* Notify only the flags which were cleared, the client keeps track of the dirty nodes
+   * until it clears the flag. */
+  const unsigned int notifiedFlags = (DIRTY_RENDER | DIRTY_ACTIVITY) & ~m_dirty;
   m_dirty = DIRTY_ALL;
+  if (notifiedFlags) {
+    ActivateDirtyCallback(notifiedFlags);
+  }
 }
 
 void SG_Node::SetModified()
@@ -420,6 +483,10 @@ bool SG_Node::UpdateSpatialData(const SG_Node *parent, double time, bool &parent
     bComputesWorldTransform = ComputeWorldTransforms(parent, parentUpdated);
   }
 
+  if (bComputesWorldTransform && m_transformStore && m_transformIndex != -1) {
+    m_transformStore->SetMatrix(m_transformIndex, this);
+  }
+
   return bComputesWorldTransform;
 }
 
@@ -546,6 +613,17 @@ MT_Transform SG_Node::GetWorldTransform() const
       m_worldRotation.scaled(m_worldScaling[0], m_worldScaling[1], m_worldScaling[2]));
 }
 
+void SG_Node::GetWorldMatrix(float mat[16]) const
+{
+  if (m_transformStore && m_transformIndex != -1) {
+    const float *stored = m_transformStore->GetMatrix(m_transformIndex);
+    std::copy(stored, stored + 16, mat);
+  }
+  else {
+    GetWorldTransform().getValue(mat);
+  }
+}
+
 MT_Transform SG_Node::GetLocalTransform() const
 {
   return MT_Transform(
@@ -585,6 +663,22 @@ bool SG_Node::IsDirty(DirtyFlag flag)
   return (m_dirty & flag);
 }
 
+void SG_Node::SetTransformStore(SG_TransformStore *store, int index)
+{
+  m_transformStore = store;
+  m_transformIndex = index;
+}
+
+SG_TransformStore *SG_Node::GetTransformStore() const
+{
+  return m_transformStore;
+}
+
+int SG_Node::GetTransformIndex() const
+{
+  return m_transformIndex;
+}
+
 bool SG_Node::ActivateReplicationCallback(SG_Node *replica)
 {
   if (m_callbacks.m_replicafunc) {
@@ -641,3 +735,10 @@ void SG_Node::ActivateRecheduleUpdateCallback()
     m_callbacks.m_reschedulefunc(this, m_SGclientObject, m_SGclientInfo);
   }
 }
+
+void SG_Node::ActivateDirtyCallback(unsigned int flags)
+{
+  if (m_callbacks.m_dirtyfunc) {
+    m_callbacks.m_dirtyfunc(this, m_SGclientObject, m_SGclientInfo, flags);
+  }
+}
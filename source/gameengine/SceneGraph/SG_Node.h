@@ -18,6 +18,7 @@
 class SG_Controller;
 class SG_Familly;
 class SG_Node;
+class SG_TransformStore;
 
 typedef std::vector<SG_Controller *> SGControllerList;
 
@@ -26,6 +27,10 @@ typedef void *(*SG_DestructionNewCallback)(SG_Node *sgnode, void *clientobj, voi
 typedef void (*SG_UpdateTransformCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_ScheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
 typedef bool (*SG_RescheduleUpdateCallback)(SG_Node *sgnode, void *clientobj, void *clientinfo);
+typedef void (*SG_DirtyCallback)(SG_Node *sgnode,
+                                 void *clientobj,
+                                 void *clientinfo,
+                                 unsigned int flags);
 
 /**
  * SG_Callbacks hold 2 call backs to the outside world.
@@ -48,7 +53,8 @@ struct SG_Callbacks {
         m_destructionfunc(nullptr),
         m_updatefunc(nullptr),
         m_schedulefunc(nullptr),
-        m_reschedulefunc(nullptr)
+        m_reschedulefunc(nullptr),
+        m_dirtyfunc(nullptr)
   {
   }
 
@@ -56,12 +62,14 @@ struct SG_Callbacks {
                SG_DestructionNewCallback destructfunc,
                SG_UpdateTransformCallback updatefunc,
                SG_ScheduleUpdateCallback schedulefunc,
-               SG_RescheduleUpdateCallback reschedulefunc)
+               SG_RescheduleUpdateCallback reschedulefunc,
+               SG_DirtyCallback dirtyfunc = nullptr)
       : m_replicafunc(repfunc),
         m_destructionfunc(destructfunc),
         m_updatefunc(updatefunc),
         m_schedulefunc(schedulefunc),
-        m_reschedulefunc(reschedulefunc)
+        m_reschedulefunc(reschedulefunc),
+        m_dirtyfunc(dirtyfunc)
   {
   }
 
@@ -70,6 +78,10 @@ struct SG_Callbacks {
   SG_UpdateTransformCallback m_updatefunc;
   SG_ScheduleUpdateCallback m_schedulefunc;
   SG_RescheduleUpdateCallback m_reschedulefunc;
+  /** Called with the flags becoming dirty (render, activity) when the world transform of the
+   * node is updated.
+   */
+  SG_DirtyCallback m_dirtyfunc;
 };
 
 typedef std::vector<SG_Node *> NodeList;
@@ -83,7 +95,8 @@ class SG_Node : public SG_QList {
     DIRTY_NONE = 0,
     DIRTY_ALL = 0xFF,
     DIRTY_RENDER = (1 << 0),
-    DIRTY_CULLING = (1 << 1)
+    DIRTY_CULLING = (1 << 1),
+    DIRTY_ACTIVITY = (1 << 2)
   };
 
   SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks);
@@ -164,6 +177,14 @@ class SG_Node : public SG_QList {
    */
   void UpdateWorldData(double time, bool parentUpdated = false);
   void UpdateWorldDataThread(double time, bool parentUpdated = false);
+  /**
+   * Update the world data from a worker thread without calling the update transform callbacks,
+   * as they access data shared by all the families (e.g physics world). The updated nodes are
+   * appended to updatedNodes to call their callbacks later with ActivateUpdateTransformCallbacks.
+   */
+  void UpdateWorldDataDeferred(double time, NodeList &updatedNodes, bool parentUpdated = false);
+  /// Call the update transform callbacks of the nodes updated by UpdateWorldDataDeferred.
+  static void ActivateUpdateTransformCallbacks(const NodeList &nodes);
 
   /**
    * Update the simulation time of this node. Iterate through
@@ -315,6 +336,9 @@ class SG_Node : public SG_QList {
   MT_Transform GetWorldTransform() const;
   MT_Transform GetLocalTransform() const;
 
+  /// Get the world matrix stored by columns, read from the transform store when stored.
+  void GetWorldMatrix(float mat[16]) const;
+
   bool ComputeWorldTransforms(const SG_Node *parent, bool &parentUpdated);
 
   const std::shared_ptr<SG_Familly> &GetFamilly() const;
@@ -323,8 +347,14 @@ class SG_Node : public SG_QList {
   bool IsModified();
   bool IsDirty(DirtyFlag flag);
 
+  /// Set by the transform store when it stores the node, index is the slot of the node or -1.
+  void SetTransformStore(SG_TransformStore *store, int index);
+  SG_TransformStore *GetTransformStore() const;
+  int GetTransformIndex() const;
+
  protected:
   friend class SG_Controller;
+  friend class SG_TransformStore;
   friend class KX_BoneParentRelation;
   friend class KX_VertexParentRelation;
   friend class KX_SlowParentRelation;
@@ -335,6 +365,7 @@ class SG_Node : public SG_QList {
   void ActivateUpdateTransformCallback();
   bool ActivateScheduleUpdateCallback();
   void ActivateRecheduleUpdateCallback();
+  void ActivateDirtyCallback(unsigned int flags);
 
   /**
    * Update the world coordinates of this spatial node. This also informs
@@ -344,6 +375,7 @@ class SG_Node : public SG_QList {
 
  private:
   void UpdateWorldDataThreadSchedule(double time, bool parentUpdated = false);
+  void UpdateWorldDataDeferredSchedule(double time, NodeList &updatedNodes, bool parentUpdated);
 
   void ProcessSGReplica(SG_Node **replica);
 
@@ -375,6 +407,10 @@ class SG_Node : public SG_QList {
   std::shared_ptr<SG_Familly> m_familly;
   CM_ThreadMutex m_mutex;
 
+  /// Transform store holding the world matrix of this node, nullptr if not stored.
+  SG_TransformStore *m_transformStore;
+  int m_transformIndex;
+
   bool m_modified;
   unsigned short m_dirty;
 };
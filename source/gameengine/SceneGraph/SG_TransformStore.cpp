@@ -0,0 +1,282 @@
+/** \file gameengine/SceneGraph/SG_TransformStore.cpp
+ *  \ingroup bgesg
+ */
+
+#include "SG_TransformStore.h"
+
+#include <algorithm>
+
+#include "SG_Node.h"
+
+#include "BLI_assert.h"
+
+SG_TransformStore::SG_TransformStore() : m_numRemoved(0), m_valid(false)
+{
+}
+
+SG_TransformStore::~SG_TransformStore()
+{
+  // The nodes merged in another scene belong to the store of this scene.
+  for (SG_Node *node : m_nodes) {
+    if (node && node->GetTransformStore() == this) {
+      node->SetTransformStore(nullptr, -1);
+    }
+  }
+  for (SG_Node *node : m_pending) {
+    if (node->GetTransformStore() == this) {
+      node->SetTransformStore(nullptr, -1);
+    }
+  }
+}
+
+void SG_TransformStore::AddSubtree(SG_Node *node, int parent)
+{
+  SG_TransformStore *store = node->GetTransformStore();
+  if (store == this && node->GetTransformIndex() != -1) {
+    // A stored node now under a newly stored parent must follow it.
+    m_nodes[node->GetTransformIndex()] = nullptr;
+    ++m_numRemoved;
+  }
+  else if (store && store != this) {
+    store->RemoveNode(node);
+  }
+
+  const int index = m_nodes.size();
+  node->SetTransformStore(this, index);
+
+  m_nodes.push_back(node);
+  m_parents.push_back(parent);
+  m_matrices.resize(m_matrices.size() + 16);
+  node->GetWorldTransform().getValue(&m_matrices[index * 16]);
+  m_scheduled.push_back(0);
+  m_visited.push_back(0);
+  m_parentUpdated.push_back(0);
+
+  for (SG_Node *child : node->GetSGChildren()) {
+    AddSubtree(child, index);
+  }
+}
+
+void SG_TransformStore::RemoveSubtree(SG_Node *node)
+{
+  const int index = node->GetTransformIndex();
+  if (node->GetTransformStore() != this || index == -1) {
+    return;
+  }
+
+  m_nodes[index] = nullptr;
+  ++m_numRemoved;
+  node->SetTransformStore(this, -1);
+
+  for (SG_Node *child : node->GetSGChildren()) {
+    RemoveSubtree(child);
+  }
+}
+
+void SG_TransformStore::Compact()
+{
+  std::vector<int> slots(m_nodes.size(), -1);
+  unsigned int size = 0;
+  for (unsigned int i = 0, num = m_nodes.size(); i < num; ++i) {
+    SG_Node *node = m_nodes[i];
+    if (!node) {
+      continue;
+    }
+
+    // The parents are before their children, their new slot is known.
+    const int parent = m_parents[i];
+    m_nodes[size] = node;
+    m_parents[size] = (parent == -1) ? -1 : slots[parent];
+    std::copy_n(&m_matrices[i * 16], 16, &m_matrices[size * 16]);
+    node->SetTransformStore(this, size);
+    slots[i] = size++;
+  }
+
+  m_nodes.resize(size);
+  m_parents.resize(size);
+  m_matrices.resize(size * 16);
+  m_scheduled.assign(size, 0);
+  m_visited.assign(size, 0);
+  m_parentUpdated.assign(size, 0);
+  m_numRemoved = 0;
+}
+
+void SG_TransformStore::Build(const std::vector<SG_Node *> &roots)
+{
+  for (SG_Node *node : m_nodes) {
+    if (node && node->GetTransformStore() == this) {
+      node->SetTransformStore(nullptr, -1);
+    }
+  }
+  for (SG_Node *node : m_pending) {
+    if (node->GetTransformStore() == this) {
+      node->SetTransformStore(nullptr, -1);
+    }
+  }
+
+  m_nodes.clear();
+  m_parents.clear();
+  m_matrices.clear();
+  m_scheduled.clear();
+  m_visited.clear();
+  m_parentUpdated.clear();
+  m_pending.clear();
+  m_numRemoved = 0;
+
+  for (SG_Node *root : roots) {
+    AddSubtree(root, -1);
+  }
+
+  m_valid = true;
+}
+
+void SG_TransformStore::Invalidate()
+{
+  m_valid = false;
+}
+
+bool SG_TransformStore::IsValid() const
+{
+  return m_valid;
+}
+
+void SG_TransformStore::AddNode(SG_Node *node)
+{
+  SG_TransformStore *store = node->GetTransformStore();
+  if (store == this) {
+    return;
+  }
+  if (store) {
+    store->RemoveNode(node);
+  }
+
+  node->SetTransformStore(this, -1);
+  m_pending.push_back(node);
+}
+
+void SG_TransformStore::MoveNode(SG_Node *node)
+{
+  if (node->GetTransformStore() != this) {
+    AddNode(node);
+    return;
+  }
+
+  // A pending descendant of a pending node is not always in the pending list.
+  RemoveSubtree(node);
+  m_pending.push_back(node);
+}
+
+void SG_TransformStore::DetachNode(SG_Node *node)
+{
+  const int index = node->GetTransformIndex();
+  if (node->GetTransformStore() == this && index != -1) {
+    m_parents[index] = -1;
+  }
+}
+
+void SG_TransformStore::RemoveNode(SG_Node *node)
+{
+  const int index = node->GetTransformIndex();
+  if (index == -1) {
+    // A node moved several times is pending more than once.
+    m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), node), m_pending.end());
+  }
+  else {
+    BLI_assert(m_nodes[index] == node);
+    m_nodes[index] = nullptr;
+    ++m_numRemoved;
+  }
+
+  node->SetTransformStore(nullptr, -1);
+}
+
+void SG_TransformStore::StorePending()
+{
+  for (SG_Node *node : m_pending) {
+    // Already stored with the subtree of another pending node, or deleted.
+    if (node->GetTransformStore() != this || node->GetTransformIndex() != -1) {
+      continue;
+    }
+
+    // Store the pending ancestors with the node, after the first stored ancestor.
+    SG_Node *root = node;
+    SG_Node *parent = root->GetSGParent();
+    while (parent && (parent->GetTransformStore() != this || parent->GetTransformIndex() == -1)) {
+      root = parent;
+      parent = root->GetSGParent();
+    }
+
+    AddSubtree(root, parent ? parent->GetTransformIndex() : -1);
+  }
+  m_pending.clear();
+
+  if (m_numRemoved > 64 && m_numRemoved * 2 > m_nodes.size()) {
+    Compact();
+  }
+}
+
+void SG_TransformStore::Update(SG_QList &head, double time)
+{
+  SG_Node *node;
+
+  // The controllers and callbacks can schedule nodes during the update, they are updated in a
+  // next pass.
+  while ((node = SG_Node::GetNextScheduled(head)) != nullptr) {
+    const unsigned int size = m_nodes.size();
+    unsigned int first = size;
+    do {
+      if (node->GetTransformStore() == this && node->GetTransformIndex() != -1) {
+        const unsigned int index = node->GetTransformIndex();
+        m_scheduled[index] = 1;
+        first = std::min(first, index);
+      }
+      else {
+        node->UpdateWorldData(time);
+      }
+    } while ((node = SG_Node::GetNextScheduled(head)) != nullptr);
+
+    /* The parents are stored before their children, a node is updated when it is scheduled or
+     * when its parent was updated in this pass, with the parent updated state of its parent. */
+    for (unsigned int i = first; i < size; ++i) {
+      node = m_nodes[i];
+      const int parent = m_parents[i];
+      const bool parentVisited = (parent != -1 && m_visited[parent]);
+
+      if (!node) {
+        m_scheduled[i] = 0;
+        continue;
+      }
+      if (!m_scheduled[i] && !parentVisited) {
+        continue;
+      }
+
+      bool parentUpdated = (parentVisited && m_parentUpdated[parent]);
+      if (node->UpdateSpatialData(node->GetSGParent(), time, parentUpdated)) {
+        node->ActivateUpdateTransformCallback();
+      }
+      // The node is updated, remove it from the update list if it was scheduled again.
+      node->Delink();
+
+      m_scheduled[i] = 0;
+      m_visited[i] = 1;
+      m_parentUpdated[i] = parentUpdated;
+    }
+
+    std::fill(m_visited.begin() + first, m_visited.end(), 0);
+  }
+}
+
+void SG_TransformStore::SetMatrix(unsigned int index, const SG_Node *node)
+{
+  node->GetWorldTransform().getValue(&m_matrices[index * 16]);
+}
+
+const float *SG_TransformStore::GetMatrix(unsigned int index) const
+{
+  return &m_matrices[index * 16];
+}
+
+unsigned int SG_TransformStore::GetSize() const
+{
+  return m_nodes.size();
+}
@@ -0,0 +1,79 @@
+/** \file SG_TransformStore.h
+ *  \ingroup bgesg
+ */
+
+#pragma once
+
+#include <vector>
+
+class SG_Node;
+class SG_QList;
+
+/** Contiguous world matrices of the nodes of a scene, enabled by the scene setting
+ * "Contiguous Transforms" (GAME_USE_TRANSFORM_STORE).
+ * The nodes are stored in hierarchy order: each root is followed by its subtree, parents before
+ * their children. The arrays are indexed by the slot of the node: the node, the slot of its
+ * parent and its world matrix (16 floats stored by columns).
+ * A node writes its matrix in its slot when its world transform is computed, and Update
+ * propagates the scheduled nodes with one pass over the slots instead of a recursion per
+ * scheduled node.
+ * Build stores the whole scene once. The nodes added or reparented later are pending until
+ * StorePending appends their subtree at the end of the store, the slots they leave and the
+ * slots of the deleted nodes stay empty until enough of them are compacted.
+ * A pending node is in the store with the slot -1.
+ */
+class SG_TransformStore {
+ private:
+  std::vector<SG_Node *> m_nodes;
+  /// Slot of the parent of each node, -1 for the roots.
+  std::vector<int> m_parents;
+  std::vector<float> m_matrices;
+
+  /// Per slot state of the update pass.
+  std::vector<char> m_scheduled;
+  std::vector<char> m_visited;
+  std::vector<char> m_parentUpdated;
+
+  /// Nodes added or reparented since the last StorePending.
+  std::vector<SG_Node *> m_pending;
+  /// Number of empty slots.
+  unsigned int m_numRemoved;
+
+  bool m_valid;
+
+  void AddSubtree(SG_Node *node, int parent);
+  /// Empty the slots of node and of its stored descendants, they become pending.
+  void RemoveSubtree(SG_Node *node);
+  /// Remove the empty slots, keeping the order of the others.
+  void Compact();
+
+ public:
+  SG_TransformStore();
+  ~SG_TransformStore();
+
+  /// Store the hierarchies of roots, the nodes stored before and not in roots leave the store.
+  void Build(const std::vector<SG_Node *> &roots);
+  void Invalidate();
+  bool IsValid() const;
+
+  /// Add a node to the store, its hierarchy is stored by the next StorePending.
+  void AddNode(SG_Node *node);
+  /// Store again the subtree of a node which changed of parent after its new parent.
+  void MoveNode(SG_Node *node);
+  /// Make a node a root without changing its slot.
+  void DetachNode(SG_Node *node);
+  /// Forget a node being deleted or moved to another store, its slot is left empty.
+  void RemoveNode(SG_Node *node);
+  /// Append the subtrees of the pending nodes and compact the store when mostly empty.
+  void StorePending();
+
+  /** Update the world data of the nodes scheduled in head and of their descendants, as done
+   * by SG_Node::UpdateWorldData. The nodes outside the store are updated recursively.
+   */
+  void Update(SG_QList &head, double time);
+
+  void SetMatrix(unsigned int index, const SG_Node *node);
+  const float *GetMatrix(unsigned int index) const;
+
+  unsigned int GetSize() const;
+};
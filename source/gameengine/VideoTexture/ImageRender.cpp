@@ -621,6 +621,11 @@ static PyGetSetDef imageRenderGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"read the pixels without stalling, they are available two frames later",
+     nullptr},
     {(char *)"whole",
      (getter)ImageViewport_getWhole,
      (setter)ImageViewport_setWhole,
@@ -840,6 +845,11 @@ static PyGetSetDef imageMirrorGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"read the pixels without stalling, they are available two frames later",
+     nullptr},
     {(char *)"whole",
      (getter)ImageViewport_getWhole,
      (setter)ImageViewport_setWhole,
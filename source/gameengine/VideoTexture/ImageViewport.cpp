@@ -9,13 +9,16 @@
 
 #include "ImageViewport.h"
 
+#include <cstring>
+
 #include "FilterSource.h"
 #include "KX_Globals.h"
 #include "KX_KetsjiEngine.h"
 #include "RAS_ICanvas.h"
 #include "Texture.h"
 
-ImageViewport::ImageViewport() : m_alpha(false), m_texInit(false)
+ImageViewport::ImageViewport()
+    : m_alpha(false), m_asyncRead(false), m_pixelBuffers(), m_pixelBufferIndex(0), m_texInit(false)
 {
   /* Because this constructor is called from python direclty without any arguments
    * the viewport should be the one of the final screen with gaps.
@@ -44,7 +47,13 @@ ImageViewport::ImageViewport() : m_alpha(false), m_texInit(false)
 
 // constructor
 ImageViewport::ImageViewport(unsigned int width, unsigned int height)
-    : m_width(width), m_height(height), m_alpha(false), m_texInit(false)
+    : m_width(width),
+      m_height(height),
+      m_alpha(false),
+      m_asyncRead(false),
+      m_pixelBuffers(),
+      m_pixelBufferIndex(0),
+      m_texInit(false)
 {
   m_viewport[0] = 0;
   m_viewport[1] = 0;
@@ -63,6 +72,7 @@ ImageViewport::ImageViewport(unsigned int width, unsigned int height)
 // destructor
 ImageViewport::~ImageViewport(void)
 {
+  freePixelBuffers();
   delete[] m_viewportImage;
 }
 
@@ -104,6 +114,89 @@ void ImageViewport::setCaptureSize(short size[2])
   setPosition();
 }
 
+// use asynchronous readback
+void ImageViewport::setAsyncRead(bool asyncRead)
+{
+  if (!asyncRead) {
+    freePixelBuffers();
+  }
+  m_asyncRead = asyncRead;
+}
+
+void ImageViewport::freePixelBuffers(void)
+{
+  for (PixelBuffer &pixelBuffer : m_pixelBuffers) {
+    if (pixelBuffer.m_fence) {
+      glDeleteSync(pixelBuffer.m_fence);
+    }
+    if (pixelBuffer.m_buffer) {
+      glDeleteBuffers(1, &pixelBuffer.m_buffer);
+    }
+    pixelBuffer = PixelBuffer();
+  }
+  m_pixelBufferIndex = 0;
+}
+
+// read capture area
+bool ImageViewport::readPixels(unsigned int format, unsigned int type, void *buffer)
+{
+  const GLint rect[4] = {m_upLeft[0], m_upLeft[1], m_capSize[0], m_capSize[1]};
+
+  if (!m_asyncRead) {
+    glReadPixels(rect[0], rect[1], rect[2], rect[3], format, type, buffer);
+    return true;
+  }
+
+  // rows are aligned on the current pack alignment, 1 as set by the GPU module
+  GLint alignment;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  const unsigned int pixelSize = (format == GL_RGB) ? 3 : 4;
+  const unsigned int rowSize = (rect[2] * pixelSize + alignment - 1) / alignment * alignment;
+  const unsigned int size = rowSize * rect[3];
+
+  /* Copy the oldest read if it is complete, it is dropped if the capture changed since.
+   * A read not complete yet is kept until its buffer receives the next read. */
+  bool avail = false;
+  PixelBuffer &oldest = m_pixelBuffers[(m_pixelBufferIndex + 1) % PIXEL_BUFFER_COUNT];
+  if (oldest.m_fence) {
+    const GLenum status = glClientWaitSync(oldest.m_fence, 0, 0);
+    if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+      if (memcmp(oldest.m_rect, rect, sizeof(rect)) == 0 && oldest.m_format == format &&
+          oldest.m_type == type) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, oldest.m_buffer);
+        glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size, buffer);
+        avail = true;
+      }
+      glDeleteSync(oldest.m_fence);
+      oldest.m_fence = nullptr;
+    }
+  }
+
+  // start the read of the current frame in the next pixel buffer
+  PixelBuffer &current = m_pixelBuffers[m_pixelBufferIndex];
+  if (current.m_fence) {
+    glDeleteSync(current.m_fence);
+  }
+  if (!current.m_buffer) {
+    glGenBuffers(1, &current.m_buffer);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, current.m_buffer);
+  if (current.m_size < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    current.m_size = size;
+  }
+  glReadPixels(rect[0], rect[1], rect[2], rect[3], format, type, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  current.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  memcpy(current.m_rect, rect, sizeof(rect));
+  current.m_format = format;
+  current.m_type = type;
+  m_pixelBufferIndex = (m_pixelBufferIndex + 1) % PIXEL_BUFFER_COUNT;
+
+  return avail;
+}
+
 // set position of capture rectangle
 void ImageViewport::setPosition(GLint pos[2])
 {
@@ -158,32 +251,22 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
       // *** misusing m_viewportImage here, but since it has the correct size
       //     (4 bytes per pixel = size of float) and we just need it to apply
       //     the filter, it's ok
-      glReadPixels(m_upLeft[0],
-                   m_upLeft[1],
-                   (GLsizei)m_capSize[0],
-                   (GLsizei)m_capSize[1],
-                   GL_DEPTH_COMPONENT,
-                   GL_FLOAT,
-                   m_viewportImage);
-      // filter loaded data
-      FilterZZZA filt;
-      filterImage(filt, (float *)m_viewportImage, m_capSize);
+      if (readPixels(GL_DEPTH_COMPONENT, GL_FLOAT, m_viewportImage)) {
+        // filter loaded data
+        FilterZZZA filt;
+        filterImage(filt, (float *)m_viewportImage, m_capSize);
+      }
     }
     else {
 
       if (m_depth) {
         // Use read pixels with the depth buffer
         // See warning above about m_viewportImage.
-        glReadPixels(m_upLeft[0],
-                     m_upLeft[1],
-                     (GLsizei)m_capSize[0],
-                     (GLsizei)m_capSize[1],
-                     GL_DEPTH_COMPONENT,
-                     GL_FLOAT,
-                     m_viewportImage);
-        // filter loaded data
-        FilterDEPTH filt;
-        filterImage(filt, (float *)m_viewportImage, m_capSize);
+        if (readPixels(GL_DEPTH_COMPONENT, GL_FLOAT, m_viewportImage)) {
+          // filter loaded data
+          FilterDEPTH filt;
+          filterImage(filt, (float *)m_viewportImage, m_capSize);
+        }
       }
       else {
 
@@ -192,35 +275,31 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
           // as we are reading the pixel in the native format, we can read directly in the image
           // buffer if we are sure that no processing is needed on the image
           if (m_size[0] == m_capSize[0] && m_size[1] == m_capSize[1] && !m_flip && !m_pyfilter) {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         format,
-                         GL_UNSIGNED_BYTE,
-                         m_image);
-            m_avail = true;
+            if (readPixels(format, GL_UNSIGNED_BYTE, m_image)) {
+              m_avail = true;
+            }
           }
           else if (!m_pyfilter) {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         format,
-                         GL_UNSIGNED_BYTE,
-                         m_viewportImage);
-            FilterRGBA32 filt;
-            filterImage(filt, m_viewportImage, m_capSize);
+            if (readPixels(format, GL_UNSIGNED_BYTE, m_viewportImage)) {
+              FilterRGBA32 filt;
+              filterImage(filt, m_viewportImage, m_capSize);
+            }
           }
           else {
-            glReadPixels(m_upLeft[0],
-                         m_upLeft[1],
-                         (GLsizei)m_capSize[0],
-                         (GLsizei)m_capSize[1],
-                         GL_RGBA,
-                         GL_UNSIGNED_BYTE,
-                         m_viewportImage);
-            FilterRGBA32 filt;
+            if (readPixels(GL_RGBA, GL_UNSIGNED_BYTE, m_viewportImage)) {
+              FilterRGBA32 filt;
+              filterImage(filt, m_viewportImage, m_capSize);
+              if (format == GL_BGRA) {
+                // in place byte swapping
+                swapImageBR();
+              }
+            }
+          }
+        }
+        else {
+          if (readPixels(GL_RGB, GL_UNSIGNED_BYTE, m_viewportImage)) {
+            // filter loaded data
+            FilterRGB24 filt;
             filterImage(filt, m_viewportImage, m_capSize);
             if (format == GL_BGRA) {
               // in place byte swapping
@@ -228,22 +307,6 @@ void ImageViewport::calcViewport(unsigned int texId, double ts, unsigned int for
             }
           }
         }
-        else {
-          glReadPixels(m_upLeft[0],
-                       m_upLeft[1],
-                       (GLsizei)m_capSize[0],
-                       (GLsizei)m_capSize[1],
-                       GL_RGB,
-                       GL_UNSIGNED_BYTE,
-                       m_viewportImage);
-          // filter loaded data
-          FilterRGB24 filt;
-          filterImage(filt, m_viewportImage, m_capSize);
-          if (format == GL_BGRA) {
-            // in place byte swapping
-            swapImageBR();
-          }
-        }
       }
     }
   }
@@ -345,6 +408,30 @@ int ImageViewport_setAlpha(PyImage *self, PyObject *value, void *closure)
   return 0;
 }
 
+// get asynchronous readback
+PyObject *ImageViewport_getAsyncRead(PyImage *self, void *closure)
+{
+  if (self->m_image != nullptr && getImageViewport(self)->getAsyncRead())
+    Py_RETURN_TRUE;
+  else
+    Py_RETURN_FALSE;
+}
+
+// set asynchronous readback
+int ImageViewport_setAsyncRead(PyImage *self, PyObject *value, void *closure)
+{
+  // check parameter, report failure
+  if (value == nullptr || !PyBool_Check(value)) {
+    PyErr_SetString(PyExc_TypeError, "The value must be a bool");
+    return -1;
+  }
+  // set asynchronous readback
+  if (self->m_image != nullptr)
+    getImageViewport(self)->setAsyncRead(value == Py_True);
+  // success
+  return 0;
+}
+
 // get position
 static PyObject *ImageViewport_getPosition(PyImage *self, void *closure)
 {
@@ -437,6 +524,11 @@ static PyGetSetDef imageViewportGetSets[] = {
      (setter)ImageViewport_setAlpha,
      (char *)"use alpha in texture",
      nullptr},
+    {(char *)"asyncRead",
+     (getter)ImageViewport_getAsyncRead,
+     (setter)ImageViewport_setAsyncRead,
+     (char *)"read the pixels without stalling, they are available two frames later",
+     nullptr},
     // attributes from ImageBase class
     {(char *)"valid",
      (getter)Image_valid,
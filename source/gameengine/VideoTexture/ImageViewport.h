@@ -42,6 +42,14 @@ class ImageViewport : public ImageBase {
     m_alpha = alpha;
   }
 
+  /// is asynchronous readback used
+  bool getAsyncRead(void)
+  {
+    return m_asyncRead;
+  }
+  /// set asynchronous readback use, the pending reads are dropped
+  void setAsyncRead(bool asyncRead);
+
   /// get capture size in viewport
   short *getCaptureSize(void)
   {
@@ -79,6 +87,27 @@ class ImageViewport : public ImageBase {
   /// upper left point for capturing
   GLint m_upLeft[2];
 
+  /// pending read of the asynchronous readback
+  struct PixelBuffer {
+    GLuint m_buffer;
+    /// fence signaled when the read is complete, nullptr if no read is pending
+    GLsync m_fence;
+    /// allocated size of the buffer
+    unsigned int m_size;
+    /// area and format of the pending read
+    GLint m_rect[4];
+    unsigned int m_format;
+    unsigned int m_type;
+  };
+  /// number of pixel buffers, the pixels read at frame N are available at frame N + 2
+  static const unsigned int PIXEL_BUFFER_COUNT = 3;
+
+  /// use asynchronous readback through pixel buffers
+  bool m_asyncRead;
+  PixelBuffer m_pixelBuffers[PIXEL_BUFFER_COUNT];
+  /// index of the pixel buffer receiving the next read
+  unsigned int m_pixelBufferIndex;
+
   /// buffer to copy viewport
   BYTE *m_viewportImage;
   /// texture is initialized
@@ -93,6 +122,13 @@ class ImageViewport : public ImageBase {
   /// capture image from viewport
   virtual void calcViewport(unsigned int texId, double ts, unsigned int format);
 
+  /** read the capture area to buffer, with the asynchronous readback the buffer receives the
+   * pixels read two calls before, return false if they are not available
+   */
+  bool readPixels(unsigned int format, unsigned int type, void *buffer);
+  /// delete the pixel buffers and drop the pending reads
+  void freePixelBuffers(void);
+
   /// get viewport size
   GLint *getViewportSize(void)
   {
@@ -106,3 +142,5 @@ PyObject *ImageViewport_getWhole(PyImage *self, void *closure);
 int ImageViewport_setWhole(PyImage *self, PyObject *value, void *closure);
 PyObject *ImageViewport_getAlpha(PyImage *self, void *closure);
 int ImageViewport_setAlpha(PyImage *self, PyObject *value, void *closure);
+PyObject *ImageViewport_getAsyncRead(PyImage *self, void *closure);
+int ImageViewport_setAsyncRead(PyImage *self, PyObject *value, void *closure);
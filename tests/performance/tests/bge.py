@@ -0,0 +1,243 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+import pathlib
+import platform
+import re
+
+# Number of frames measured in each scenario, after the player warmup frames.
+NUM_FRAMES = 500
+
+COMPONENTS_TEXT = "bge_benchmark_components.py"
+
+COMPONENTS_SOURCE = '''
+import bge
+
+
+class Rotate(bge.types.KX_PythonComponent):
+    args = {}
+
+    def start(self, args):
+        pass
+
+    def update(self):
+        self.object.applyRotation((0.0, 0.0, 0.01), True)
+
+
+class Spawner(bge.types.KX_PythonComponent):
+    args = {"Template": "Template", "Per Second": 500, "Lifetime": 60}
+
+    def start(self, args):
+        self.template = self.object.scene.objectsInactive[args["Template"]]
+        self.per_frame = args["Per Second"] / bge.logic.getLogicTicRate()
+        self.lifetime = args["Lifetime"]
+        self.pending = 0.0
+
+    def update(self):
+        self.pending += self.per_frame
+        while self.pending >= 1.0:
+            self.object.scene.addObject(self.template, self.object, self.lifetime)
+            self.pending -= 1.0
+
+
+class PlayAction(bge.types.KX_PythonComponent):
+    args = {"Action": "", "End": 20}
+
+    def start(self, args):
+        self.object.playAction(args["Action"], 1, args["End"], play_mode=bge.logic.KX_ACTION_MODE_LOOP)
+
+    def update(self):
+        pass
+
+
+class LibLoadCycle(bge.types.KX_PythonComponent):
+    args = {"Library": "//libload_library.blend"}
+
+    def start(self, args):
+        self.path = bge.logic.expandPath(args["Library"])
+
+    def update(self):
+        if self.path in bge.logic.LibList():
+            bge.logic.LibFree(self.path)
+        else:
+            bge.logic.LibLoad(self.path, "Scene")
+'''
+
+
+def _generate(args):
+    import bpy
+    import math
+
+    bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+
+    scene = bpy.context.scene
+    collection = scene.collection
+
+    text = bpy.data.texts.new(COMPONENTS_TEXT)
+    text.from_string(COMPONENTS_SOURCE)
+    module = COMPONENTS_TEXT[:-3]
+
+    def add_object(name, data, location):
+        ob = bpy.data.objects.new(name, data)
+        ob.location = location
+        collection.objects.link(ob)
+        return ob
+
+    def add_component(ob, name):
+        bpy.context.view_layer.objects.active = ob
+        bpy.ops.logic.python_component_register(component_name=module + "." + name)
+        return ob.game.components[-1]
+
+    def grid(count, spacing, height=0.0):
+        side = math.ceil(math.sqrt(count))
+        for i in range(count):
+            yield ((i % side - side / 2) * spacing, (i // side - side / 2) * spacing, height)
+
+    mesh = bpy.data.meshes.new("Cube")
+    mesh.from_pydata(
+        [(-0.5, -0.5, -0.5), (0.5, -0.5, -0.5), (0.5, 0.5, -0.5), (-0.5, 0.5, -0.5),
+         (-0.5, -0.5, 0.5), (0.5, -0.5, 0.5), (0.5, 0.5, 0.5), (-0.5, 0.5, 0.5)],
+        [],
+        [(0, 3, 2, 1), (4, 5, 6, 7), (0, 1, 5, 4), (1, 2, 6, 5), (2, 3, 7, 6), (3, 0, 4, 7)])
+
+    camera = add_object("Camera", bpy.data.cameras.new("Camera"), (0.0, -120.0, 80.0))
+    camera.rotation_euler = (math.radians(55.0), 0.0, 0.0)
+    scene.camera = camera
+    add_object("Light", bpy.data.lights.new("Light", 'SUN'), (0.0, 0.0, 50.0))
+
+    scenario = args['scenario']
+
+    if scenario in {'static_objects', 'libload_library'}:
+        for location in grid(10000, 2.0):
+            add_object("Static", mesh, location).game.physics_type = 'STATIC'
+
+    elif scenario == 'rigid_bodies':
+        ground = add_object("Ground", mesh, (0.0, 0.0, -1.0))
+        ground.scale = (200.0, 200.0, 1.0)
+        for i, location in enumerate(grid(2000, 1.5)):
+            ob = add_object("RigidBody", mesh, location)
+            ob.location.z = 2.0 + (i % 5) * 1.5
+            ob.game.physics_type = 'RIGID_BODY'
+
+    elif scenario == 'spawn_objects':
+        # Templates are the objects of the hidden collections.
+        templates = bpy.data.collections.new("Templates")
+        collection.children.link(templates)
+        template = bpy.data.objects.new("Template", mesh)
+        template.game.physics_type = 'RIGID_BODY'
+        templates.objects.link(template)
+        bpy.context.view_layer.layer_collection.children["Templates"].hide_viewport = True
+
+        spawner = add_object("Spawner", None, (0.0, 0.0, 5.0))
+        add_component(spawner, "Spawner")
+
+    elif scenario == 'armatures':
+        armature = bpy.data.armatures.new("Armature")
+        template = add_object("Armature", armature, (0.0, 0.0, 0.0))
+        bpy.context.view_layer.objects.active = template
+        bpy.ops.object.mode_set(mode='EDIT')
+        parent = None
+        for i in range(8):
+            bone = armature.edit_bones.new("Bone%d" % i)
+            bone.head = (0.0, 0.0, i)
+            bone.tail = (0.0, 0.0, i + 1)
+            bone.parent = parent
+            parent = bone
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        for frame, angle in ((1, 0.0), (10, 0.5), (20, 0.0)):
+            for pose_bone in template.pose.bones:
+                pose_bone.rotation_mode = 'XYZ'
+                pose_bone.rotation_euler = (angle, 0.0, 0.0)
+                pose_bone.keyframe_insert("rotation_euler", frame=frame)
+        action = template.animation_data.action
+        template.animation_data_clear()
+
+        component = add_component(template, "PlayAction")
+        component.properties["Action"].value = action.name
+        collection.objects.unlink(template)
+
+        for location in grid(200, 3.0):
+            ob = template.copy()
+            ob.location = location
+            collection.objects.link(ob)
+
+    elif scenario == 'python_components':
+        template = add_object("Component", mesh, (0.0, 0.0, 0.0))
+        add_component(template, "Rotate")
+        collection.objects.unlink(template)
+
+        for location in grid(5000, 2.0):
+            ob = template.copy()
+            ob.location = location
+            collection.objects.link(ob)
+
+    elif scenario == 'libload':
+        loader = add_object("Loader", None, (0.0, 0.0, 0.0))
+        add_component(loader, "LibLoadCycle")
+
+    bpy.ops.wm.save_as_mainfile(filepath=args['filepath'])
+    return {}
+
+
+class BGETest(api.Test):
+    def __init__(self, scenario):
+        self.scenario = scenario
+
+    def name(self):
+        return self.scenario
+
+    def category(self):
+        return "bge"
+
+    def use_background(self):
+        # The player needs a window to render.
+        return False
+
+    def _player_executable(self, env):
+        executable = pathlib.Path(env.blender_executable)
+        name = 'blenderplayer.exe' if platform.system() == "Windows" else 'blenderplayer'
+        return executable.parent / name
+
+    def _generate_file(self, env, scenario, filepath):
+        args = {'scenario': scenario, 'filepath': str(filepath)}
+        env.run_in_blender(_generate, args)
+
+    def run(self, env, device_id):
+        directory = env.base_dir / 'bge'
+        directory.mkdir(parents=True, exist_ok=True)
+
+        # Regenerate the files with the tested build to avoid versioning in the measures.
+        filepath = directory / (self.scenario + '.blend')
+        if self.scenario == 'libload':
+            self._generate_file(env, 'libload_library', directory / 'libload_library.blend')
+        self._generate_file(env, self.scenario, filepath)
+
+        args = [self._player_executable(env),
+                '-w', '1280', '720',
+                '-g', 'benchmark_frames', '=', str(NUM_FRAMES),
+                str(filepath)]
+        lines = env.call(args, cwd=env.base_dir, environment=env.blender_executable_environment)
+
+        # Per frame times in milliseconds printed by the player for each profiling category.
+        result = {}
+        pattern = re.compile(r'^Benchmark (.+): ([0-9.eE+-]+) ms')
+        for line in lines:
+            match = pattern.match(line.strip())
+            if match:
+                category = match.group(1).lower().replace(' ', '_')
+                result[category] = float(match.group(2)) / 1000.0
+
+        if 'total' not in result:
+            return {}
+
+        result['time'] = result.pop('total')
+        return result
+
+
+def generate(env):
+    scenarios = ('static_objects', 'rigid_bodies', 'spawn_objects', 'armatures',
+                 'python_components', 'libload')
+    return [BGETest(scenario) for scenario in scenarios]
@@ -0,0 +1,238 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Test the game engine network replication between two blenderplayer instances on 127.0.0.1.
+
+The players need a window, run from a graphical session:
+./blender.bin --background --factory-startup --python tests/python/bge_network_loopback.py -- \
+    --output-dir /tmp/bge_network
+
+A host and a client player each replicate a cube with a game property and send a message at
+every frame. The host checks that it receives the cube, the property and the messages of the
+client, and that the client is removed from its peers by the bye packet sent when it stops.
+"""
+
+import bpy
+import json
+import os
+import subprocess
+import sys
+import time
+
+COMPONENTS_TEXT = "bge_network_loopback_components.py"
+
+COMPONENTS_SOURCE = '''
+import bge
+import json
+
+
+class LoopbackPeer(bge.types.KX_PythonComponent):
+    args = {"Role": "host", "Port": 0, "Frames": 300, "Result": ""}
+
+    def start(self, args):
+        self.role = args["Role"]
+        self.frames = args["Frames"]
+        self.result_path = args["Result"]
+        self.frame = 0
+
+        objects = self.object.scene.objects
+        if self.role == "host":
+            bge.logic.netStart(args["Port"])
+            self.sent = objects["HostCube"]
+            self.received = objects["ClientCube"]
+        else:
+            bge.logic.netStart()
+            bge.logic.netConnect("127.0.0.1", args["Port"])
+            self.sent = objects["ClientCube"]
+            self.received = objects["HostCube"]
+
+        self.sent["counter"] = 0
+        self.sent.replicate = True
+        self.sent.replicateProperties = ["counter"]
+
+        self.result = {
+            "counter": 0,
+            "position_error": 0.0,
+            "messages": 0,
+            "connected": False,
+            "peer_left": False,
+            "left_delay": 0,
+        }
+        self.last_receive_frame = 0
+
+    def update(self):
+        self.frame += 1
+        self.sent["counter"] = self.frame
+        self.sent.worldPosition = (0.0, 0.0, self.frame * 0.01)
+        bge.logic.netSendMessage("ping", self.role)
+
+        result = self.result
+        result["messages"] += sum(body != self.role for body in bge.logic.getMessages("ping").bodies)
+        counter = self.received.get("counter", 0)
+        if counter > result["counter"]:
+            result["counter"] = counter
+            result["position_error"] = abs(self.received.worldPosition.z - counter * 0.01)
+            self.last_receive_frame = self.frame
+
+        peers = bge.logic.netGetPeers()
+        if peers:
+            result["connected"] = True
+        elif result["connected"] and not result["peer_left"]:
+            result["peer_left"] = True
+            result["left_delay"] = self.frame - self.last_receive_frame
+
+        # The client stops first, the host waits until the client left.
+        if self.role == "host":
+            done = result["peer_left"] or self.frame >= self.frames * 4
+        else:
+            done = self.frame >= self.frames
+
+        if done:
+            bge.logic.netStop()
+            with open(self.result_path, "w") as file:
+                json.dump(result, file)
+            bge.logic.endGame()
+'''
+
+
+def generate(filepath, role, port, frames, result_path):
+    import math
+
+    bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+
+    scene = bpy.context.scene
+    collection = scene.collection
+
+    text = bpy.data.texts.new(COMPONENTS_TEXT)
+    text.from_string(COMPONENTS_SOURCE)
+
+    def add_object(name, data, location):
+        ob = bpy.data.objects.new(name, data)
+        ob.location = location
+        collection.objects.link(ob)
+        return ob
+
+    mesh = bpy.data.meshes.new("Cube")
+    mesh.from_pydata(
+        [(-0.5, -0.5, -0.5), (0.5, -0.5, -0.5), (0.5, 0.5, -0.5), (-0.5, 0.5, -0.5),
+         (-0.5, -0.5, 0.5), (0.5, -0.5, 0.5), (0.5, 0.5, 0.5), (-0.5, 0.5, 0.5)],
+        [],
+        [(0, 3, 2, 1), (4, 5, 6, 7), (0, 1, 5, 4), (1, 2, 6, 5), (2, 3, 7, 6), (3, 0, 4, 7)])
+
+    camera = add_object("Camera", bpy.data.cameras.new("Camera"), (0.0, -10.0, 2.0))
+    camera.rotation_euler = (math.radians(90.0), 0.0, 0.0)
+    scene.camera = camera
+    add_object("HostCube", mesh, (-2.0, 0.0, 0.0))
+    add_object("ClientCube", mesh, (2.0, 0.0, 0.0))
+
+    peer = add_object("Peer", None, (0.0, 0.0, 0.0))
+    bpy.context.view_layer.objects.active = peer
+    bpy.ops.logic.python_component_register(component_name=COMPONENTS_TEXT[:-3] + ".LoopbackPeer")
+    properties = peer.game.components[-1].properties
+    properties["Role"].value = role
+    properties["Port"].value = port
+    properties["Frames"].value = frames
+    properties["Result"].value = result_path
+
+    bpy.ops.wm.save_as_mainfile(filepath=filepath, check_existing=False)
+
+
+def player_executable():
+    directory = os.path.dirname(bpy.app.binary_path)
+    name = "blenderplayer.exe" if sys.platform == "win32" else "blenderplayer"
+    return os.path.join(directory, name)
+
+
+def argparse_create():
+    import argparse
+
+    description = "Test the game engine network replication between two players."
+    parser = argparse.ArgumentParser(description=description)
+    parser.add_argument(
+        "--output-dir",
+        dest="output_dir",
+        default=".",
+        help="Where to write the game files and the results",
+        required=False,
+    )
+    parser.add_argument(
+        "--player",
+        dest="player",
+        default=player_executable(),
+        help="The blenderplayer executable",
+        required=False,
+    )
+    parser.add_argument("--port", dest="port", type=int, default=47810, required=False)
+    parser.add_argument("--frames", dest="frames", type=int, default=300, required=False)
+    parser.add_argument("--timeout", dest="timeout", type=float, default=120.0, required=False)
+
+    return parser
+
+
+def main():
+    args = argparse_create().parse_args()
+    os.makedirs(args.output_dir, exist_ok=True)
+
+    players = []
+    for role in ("host", "client"):
+        filepath = os.path.abspath(os.path.join(args.output_dir, "network_" + role + ".blend"))
+        result_path = os.path.abspath(os.path.join(args.output_dir, "network_" + role + ".json"))
+        if os.path.exists(result_path):
+            os.remove(result_path)
+        generate(filepath, role, args.port, args.frames, result_path)
+        players.append((role, filepath, result_path))
+
+    processes = []
+    for role, filepath, result_path in players:
+        processes.append(subprocess.Popen([args.player, "-w", "320", "240", filepath]))
+        # The host binds its port first, the client resends its hello anyway until connected.
+        time.sleep(1.0)
+
+    failures = []
+    for (role, filepath, result_path), process in zip(players, processes):
+        try:
+            if process.wait(timeout=args.timeout) != 0:
+                failures.append(role + ": the player returned " + str(process.returncode))
+        except subprocess.TimeoutExpired:
+            process.kill()
+            failures.append(role + ": the player timed out")
+
+    results = {}
+    for role, filepath, result_path in players:
+        if not os.path.exists(result_path):
+            failures.append(role + ": no result written")
+            continue
+        with open(result_path) as file:
+            results[role] = json.load(file)
+        print(role, results[role])
+
+    for role, result in results.items():
+        if not result["connected"]:
+            failures.append(role + ": never connected")
+        if result["counter"] == 0:
+            failures.append(role + ": no replicated property received")
+        # The positions are quantized to a millimeter.
+        if result["position_error"] > 0.001:
+            failures.append(role + ": replicated position off by " + str(result["position_error"]))
+        if result["messages"] == 0:
+            failures.append(role + ": no message received")
+
+    if "host" in results:
+        if results["host"]["counter"] < args.frames // 2:
+            failures.append("host: only received the counter " + str(results["host"]["counter"]))
+        # Without the bye packet, the client would only be removed after 10 seconds of silence.
+        if not results["host"]["peer_left"] or results["host"]["left_delay"] > 60:
+            failures.append("host: the client bye packet was not received")
+
+    for failure in failures:
+        print("FAILED", failure)
+    if failures:
+        sys.exit(1)
+    print("OK")
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    main()